@@ -32,7 +32,7 @@ class StaticDataChanged : public uaf::DataChangeCallback
 {
     void operator() (const uaf::DataChangeNotification& notification)
     {
-        uaf::Status status = notification.status;
+        uaf::Status status = notification.status();
         uaf::Variant data  = notification.data;
         double value0;
         if (status.isGood() && data.toDouble(value0).isGood())
@@ -47,7 +47,7 @@ class DynamicDataChanged : public uaf::DataChangeCallback
 {
     void operator() (const uaf::DataChangeNotification& notification)
     {
-        uaf::Status status = notification.status;
+        uaf::Status status = notification.status();
         uaf::Variant data  = notification.data;
         double value0;
         if (status.isGood() && data.toDouble(value0).isGood())
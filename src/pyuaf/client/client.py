@@ -55,6 +55,7 @@ class Client(ClientBase):
         self.__subscriptionCallbacks__ = []
         self.__notificationsMissingCallbacks__ = []
         self.__keepAliveCallbacks__ = []
+        self.__notificationCallbackObjects__ = []
         
         # initialize the base class
         if settings is None:
@@ -243,6 +244,12 @@ class Client(ClientBase):
                 self.dataChangesReceived(notificationsWithoutCallback)
             except:
                 pass # nothing we can do at this point!
+        
+        # also call the callbacks registered by registerDataChangeCallback()
+        try:
+            ClientBase.__dispatch_dataChangesReceived__(self, dataNotifications)
+        except:
+            pass # nothing we can do at this point!
     
     def dataChangesReceived(self, dataNotifications):
         """
@@ -296,6 +303,12 @@ class Client(ClientBase):
                 self.eventsReceived(notificationsWithoutCallback)
             except:
                 pass # nothing we can do at this point!
+        
+        # also call the callbacks registered by registerEventCallback()
+        try:
+            ClientBase.__dispatch_eventsReceived__(self, eventNotifications)
+        except:
+            pass # nothing we can do at this point!
     
     
     def eventsReceived(self, eventNotifications):
@@ -662,6 +675,91 @@ class Client(ClientBase):
         pass
     
     
+    def registerDataChangeCallback(self, callback, onlyClientHandle=None):
+        """
+        Register a callback object to handle the data change notifications of monitored items.
+        
+        Several callbacks can be registered for the same ClientHandle: all of them will be called
+        (in the thread that received the notifications), in addition to the callback functions
+        given to :meth:`~pyuaf.client.Client.createMonitoredData` and to 
+        :meth:`~pyuaf.client.Client.dataChangesReceived`. 
+        
+        The client keeps a reference to the callback object until the client is deleted, since
+        a callback may still be called by a notification that was being dispatched while the 
+        callback was unregistered.
+        
+        :param callback:            A callback object, i.e. an instance of a subclass of 
+                                    :class:`~pyuaf.client.DataChangeCallback` that implements
+                                    ``__call__(self, notification)``.
+        :type  callback:            :class:`~pyuaf.client.DataChangeCallback`
+        :param onlyClientHandle:    Optional argument: provide this argument if the callback 
+                                    should only be called for the monitored item identified by 
+                                    the given clientHandle.
+        :type  onlyClientHandle:    ``int``
+        """
+        self.__notificationCallbackObjects__.append(callback)
+        
+        if onlyClientHandle is None:
+            ClientBase.registerDataChangeCallback(self, callback)
+        else:
+            ClientBase.registerDataChangeCallback(self, onlyClientHandle, callback)
+    
+    
+    def registerEventCallback(self, callback, onlyClientHandle=None):
+        """
+        Register a callback object to handle the event notifications of monitored items.
+        
+        See :meth:`~pyuaf.client.Client.registerDataChangeCallback`.
+        
+        :param callback:            A callback object, i.e. an instance of a subclass of 
+                                    :class:`~pyuaf.client.EventCallback` that implements
+                                    ``__call__(self, notification)``.
+        :type  callback:            :class:`~pyuaf.client.EventCallback`
+        :param onlyClientHandle:    Optional argument: provide this argument if the callback 
+                                    should only be called for the monitored item identified by 
+                                    the given clientHandle.
+        :type  onlyClientHandle:    ``int``
+        """
+        self.__notificationCallbackObjects__.append(callback)
+        
+        if onlyClientHandle is None:
+            ClientBase.registerEventCallback(self, callback)
+        else:
+            ClientBase.registerEventCallback(self, onlyClientHandle, callback)
+    
+    
+    def unregisterDataChangeCallbacks(self, onlyClientHandle=None):
+        """
+        Unregister the callback objects that were registered by 
+        :meth:`~pyuaf.client.Client.registerDataChangeCallback`.
+        
+        :param onlyClientHandle:    Optional argument: provide this argument to only unregister
+                                    the callbacks of the given clientHandle (if not provided, 
+                                    only the callbacks for all monitored items are unregistered).
+        :type  onlyClientHandle:    ``int``
+        """
+        if onlyClientHandle is None:
+            ClientBase.unregisterDataChangeCallbacks(self)
+        else:
+            ClientBase.unregisterDataChangeCallbacks(self, onlyClientHandle)
+    
+    
+    def unregisterEventCallbacks(self, onlyClientHandle=None):
+        """
+        Unregister the callback objects that were registered by 
+        :meth:`~pyuaf.client.Client.registerEventCallback`.
+        
+        :param onlyClientHandle:    Optional argument: provide this argument to only unregister
+                                    the callbacks of the given clientHandle (if not provided, 
+                                    only the callbacks for all monitored items are unregistered).
+        :type  onlyClientHandle:    ``int``
+        """
+        if onlyClientHandle is None:
+            ClientBase.unregisterEventCallbacks(self)
+        else:
+            ClientBase.unregisterEventCallbacks(self, onlyClientHandle)
+    
+    
     def unregisterLoggingCallback(self):
         """
         Unregister a callback function to stop receiving all log messages.
@@ -1297,6 +1395,77 @@ class Client(ClientBase):
         return info
     
     
+    def notificationDispatchStatistics(self):
+        """
+        Get the statistics of the threads that dispatch the notifications to the callbacks.
+        
+        These statistics (such as the number of queued and dropped notifications) are only
+        relevant if :attr:`~pyuaf.client.settings.ClientSettings.notificationDispatchEnable`
+        is True, and can be used to size the dispatch queues.
+        
+        :return: The current statistics.
+        :rtype:  :class:`~pyuaf.client.NotificationDispatchStatistics`
+        """
+        return ClientBase.notificationDispatchStatistics(self)
+    
+    
+    def resolutionStatistics(self):
+        """
+        Get the statistics of the resolver, which translates the relative paths of the addresses
+        into NodeIds.
+        
+        These statistics (such as the number of addresses that were resolved by the address
+        cache, and the number of browse paths that had to be translated by the servers) show
+        how effective the caching of the resolved addresses is.
+        
+        :return: The current statistics.
+        :rtype:  :class:`~pyuaf.client.ResolutionStatistics`
+        """
+        return ClientBase.resolutionStatistics(self)
+    
+    
+    def latestValue(self, clientHandleOrAddress):
+        """
+        Get the latest value that was received by a monitored data item.
+        
+        The latest values are only stored if 
+        :attr:`~pyuaf.client.settings.ClientSettings.latestValueStoreEnable` is True. 
+        They can be queried at any time, without having to process the notifications.
+        The :attr:`~pyuaf.client.LatestValue.sequenceNumber` tells you whether a new value was 
+        received since the last time you queried it.
+        
+        :param clientHandleOrAddress: The handle of the monitored item, or the address of the 
+                                      monitored node.
+        :type  clientHandleOrAddress: ``int`` or :class:`~pyuaf.util.Address`
+        :return: The latest value of the monitored item.
+        :rtype:  :class:`~pyuaf.client.LatestValue`
+        :raise pyuaf.util.errors.UnknownClientHandleError:
+             Raised in case no monitored item is known for the given client handle or address.
+        :raise pyuaf.util.errors.UafError:
+             Base exception, catch this to handle any other errors.
+        """
+        latestValue = pyuaf.client.LatestValue()
+        ClientBase.latestValue(self, clientHandleOrAddress, latestValue).test()
+        return latestValue
+    
+    
+    def latestValues(self):
+        """
+        Get the latest values of all monitored data items.
+        
+        The latest values are only stored if 
+        :attr:`~pyuaf.client.settings.ClientSettings.latestValueStoreEnable` is True.
+        
+        :return: A list of the latest values of all monitored data items.
+        :rtype:  ``list`` of :class:`~pyuaf.client.LatestValue`
+        """
+        l = []
+        vec = ClientBase.latestValues(self)
+        for i in xrange(len(vec)):
+            l.append(vec[i])
+        return l
+    
+    
     def read(self, addresses, attributeId=pyuaf.util.attributeids.Value, **kwargs):
         """
         Read a number of node attributes synchronously.
@@ -1360,12 +1529,11 @@ class Client(ClientBase):
            inherit from the :class:`~pyuaf.client.Client` class, so it can override the  
            :meth:`~pyuaf.client.Client.readComplete` method.
         
-        .. warning::
+        .. note::
         
-            Asynchronous requests MUST be invoked on a single session. Meaning:
-            the targets of asynchronous requests MUST belong to the same server (as the UAF can 
-            currently not reconstruct an asynchronous request that must be "split up" to be called
-            on multiple servers). If they don't belong to the same server, an error will be raised.
+            If the targets of an asynchronous request belong to different servers, the request is
+            split up into one asynchronous transaction per session, and the result is reassembled
+            before the callback is called (so it is called only once per request).
         
         .. warning::
             
@@ -1513,12 +1681,11 @@ class Client(ClientBase):
            inherit from the :class:`~pyuaf.client.Client` class, so it can override the  
            :meth:`~pyuaf.client.Client.writeComplete` method.
         
-        .. warning::
+        .. note::
         
-            Asynchronous requests MUST be invoked on a single session. Meaning:
-            the targets of asynchronous requests MUST belong to the same server (as the UAF can 
-            currently not reconstruct an asynchronous request that must be "split up" to be called
-            on multiple servers). If they don't belong to the same server, an error will be raised.
+            If the targets of an asynchronous request belong to different servers, the request is
+            split up into one asynchronous transaction per session, and the result is reassembled
+            before the callback is called (so it is called only once per request).
         
         .. warning::
             
@@ -2572,11 +2739,10 @@ class Client(ClientBase):
                :attr:`~pyuaf.util.errors.CreateMonitoredItemsError.assignedClientHandles`
                attribute, providing the assigned client handles.
         
-        .. warning::
-            Asynchronous requests MUST be invoked on a single session. Meaning:
-            the targets of asynchronous requests MUST belong to the same server (as the UAF can 
-            currently not reconstruct an asynchronous request that must be "split up" to be called
-            on multiple servers). If they don't belong to the same server, an error will be raised.
+        .. note::
+            If the targets of an asynchronous request belong to different servers, the request is
+            split up into one asynchronous transaction per session, and the result is reassembled
+            before the callback is called (so it is called only once per request).
         
         .. warning::
             
@@ -2691,6 +2857,165 @@ class Client(ClientBase):
                 self.__asyncWriteLock__.release()
             elif type(request) == pyuaf.client.requests.AsyncMethodCallRequest:
                 self.__asyncCallLock__.release()
+    
+    
+    def prepare(self, request):
+        """
+        Prepare a synchronous read request, so that it can be executed many times (e.g. for 
+        cyclic polling) with a minimum of overhead.
+        
+        The targets are resolved, the sessions are connected, and the Read service calls are
+        built and encoded only once. Executing the prepared read (see 
+        :meth:`~pyuaf.client.Client.execute`) then only sends the service calls and decodes the 
+        values. When a session has reconnected in the meantime (so the NamespaceArray of the 
+        server may have changed), the read is prepared again automatically.
+        
+        :param request: The read request to prepare.
+        :type  request: :class:`~pyuaf.client.requests.ReadRequest`
+        :return: The prepared read (which should not be used anymore once the client is deleted).
+        :rtype:  :class:`~pyuaf.client.PreparedRead`
+        :raise pyuaf.util.errors.UafError:
+             Base exception, catch this to handle any UAF errors.
+        """
+        preparedRead = pyuaf.client.PreparedRead()
+        status = ClientBase.prepare(self, request, preparedRead)
+        status.test()
+        return preparedRead
+    
+    
+    def execute(self, preparedRead):
+        """
+        Execute a read that was prepared by :meth:`~pyuaf.client.Client.prepare`.
+        
+        :param preparedRead: The prepared read.
+        :type  preparedRead: :class:`~pyuaf.client.PreparedRead`
+        :return: The result of the read.
+        :rtype:  :class:`~pyuaf.client.results.ReadResult`
+        :raise pyuaf.util.errors.ReadNotPreparedError:
+             Raised if the read could not be prepared by this client.
+        :raise pyuaf.util.errors.UafError:
+             Base exception, catch this to handle any UAF errors.
+        """
+        result = pyuaf.client.results.ReadResult()
+        status = ClientBase.execute(self, preparedRead, result)
+        status.test()
+        return result
+    
+    
+    def readAsync(self, request):
+        """
+        Process a read request without waiting for the result.
+        
+        The request is sent as an asynchronous Read service call, so no thread is blocked while 
+        the request is in progress. The result is delivered to the returned future (and not to 
+        :meth:`~pyuaf.client.Client.readComplete`).
+        
+        :param request: The request to process.
+        :type  request: :class:`~pyuaf.client.requests.ReadRequest`
+        :return: The future result. If the request could not be sent, the future holds a result with
+                 the client-side status as its ``overallStatus``.
+        :rtype:  :class:`~pyuaf.client.ReadFuture`
+        """
+        return ClientBase.readAsync(self, request)
+    
+    
+    def writeAsync(self, request):
+        """
+        Process a write request without waiting for the result.
+        
+        The request is sent as an asynchronous Write service call, so no thread is blocked while 
+        the request is in progress. The result is delivered to the returned future (and not to 
+        :meth:`~pyuaf.client.Client.writeComplete`).
+        
+        :param request: The request to process.
+        :type  request: :class:`~pyuaf.client.requests.WriteRequest`
+        :return: The future result. If the request could not be sent, the future holds a result with
+                 the client-side status as its ``overallStatus``.
+        :rtype:  :class:`~pyuaf.client.WriteFuture`
+        """
+        return ClientBase.writeAsync(self, request)
+    
+    
+    def callAsync(self, request):
+        """
+        Process a method call request without waiting for the result.
+        
+        A request with a single target is sent as an asynchronous Call service call (and its 
+        result is not delivered to :meth:`~pyuaf.client.Client.callComplete`). A request with 
+        multiple targets is processed synchronously by one of the 
+        :attr:`~pyuaf.client.settings.ClientSettings.futureMaxThreads` worker threads.
+        
+        :param request: The request to process.
+        :type  request: :class:`~pyuaf.client.requests.MethodCallRequest`
+        :return: The future result. If the request could not be sent, the future holds a result with
+                 the client-side status as its ``overallStatus``.
+        :rtype:  :class:`~pyuaf.client.MethodCallFuture`
+        """
+        return ClientBase.callAsync(self, request)
+    
+    
+    def browseAsync(self, request):
+        """
+        Process a browse request without waiting for the result.
+        
+        The request is processed synchronously by one of the 
+        :attr:`~pyuaf.client.settings.ClientSettings.futureMaxThreads` worker threads.
+        
+        :param request: The request to process.
+        :type  request: :class:`~pyuaf.client.requests.BrowseRequest`
+        :return: The future result. If the request failed, the future holds a result with
+                 the client-side status as its ``overallStatus``.
+        :rtype:  :class:`~pyuaf.client.BrowseFuture`
+        """
+        return ClientBase.browseAsync(self, request)
+    
+    
+    def browseNextAsync(self, request):
+        """
+        Process a browse next request without waiting for the result.
+        
+        The request is processed synchronously by one of the 
+        :attr:`~pyuaf.client.settings.ClientSettings.futureMaxThreads` worker threads.
+        
+        :param request: The request to process.
+        :type  request: :class:`~pyuaf.client.requests.BrowseNextRequest`
+        :return: The future result. If the request failed, the future holds a result with
+                 the client-side status as its ``overallStatus``.
+        :rtype:  :class:`~pyuaf.client.BrowseFuture`
+        """
+        return ClientBase.browseNextAsync(self, request)
+    
+    
+    def translateBrowsePathsToNodeIdsAsync(self, request):
+        """
+        Process a TranslateBrowsePathsToNodeIds request without waiting for the result.
+        
+        The request is processed synchronously by one of the 
+        :attr:`~pyuaf.client.settings.ClientSettings.futureMaxThreads` worker threads.
+        
+        :param request: The request to process.
+        :type  request: :class:`~pyuaf.client.requests.TranslateBrowsePathsToNodeIdsRequest`
+        :return: The future result. If the request failed, the future holds a result with
+                 the client-side status as its ``overallStatus``.
+        :rtype:  :class:`~pyuaf.client.TranslateBrowsePathsToNodeIdsFuture`
+        """
+        return ClientBase.translateBrowsePathsToNodeIdsAsync(self, request)
+    
+    
+    def historyReadRawModifiedAsync(self, request):
+        """
+        Process a HistoryReadRawModified request without waiting for the result.
+        
+        The request is processed synchronously by one of the 
+        :attr:`~pyuaf.client.settings.ClientSettings.futureMaxThreads` worker threads.
+        
+        :param request: The request to process.
+        :type  request: :class:`~pyuaf.client.requests.HistoryReadRawModifiedRequest`
+        :return: The future result. If the request failed, the future holds a result with
+                 the client-side status as its ``overallStatus``.
+        :rtype:  :class:`~pyuaf.client.HistoryReadRawModifiedFuture`
+        """
+        return ClientBase.historyReadRawModifiedAsync(self, request)
 
 
 #### END OF INCLUDED PYTHON FILE
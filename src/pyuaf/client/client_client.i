@@ -65,8 +65,15 @@
 #include "uaf/client/subscriptions/subscriptioninformation.h"
 #include "uaf/client/subscriptions/monitoreditemstates.h"
 #include "uaf/client/subscriptions/monitorediteminformation.h"
+#include "uaf/client/subscriptions/overflowpolicies.h"
+#include "uaf/client/subscriptions/notificationdispatchstatistics.h"
+#include "uaf/client/resolution/resolutionstatistics.h"
+#include "uaf/client/subscriptions/latestvalue.h"
 #include "uaf/client/sessions/sessionstates.h"
 #include "uaf/client/sessions/sessioninformation.h"
+#include "uaf/client/preparedread.h"
+#include "uaf/client/future.h"
+#include "uaf/util/callbacks.h"
 %}
 
 
@@ -127,6 +134,7 @@ import time
 %import "pyuaf/client/client_connectionsteps.i"
 %import "pyuaf/client/client_subscriptionstates.i" 
 %import "pyuaf/client/client_monitoreditemstates.i"
+%import "pyuaf/client/client_overflowpolicies.i"
 %import "pyuaf/client/client_settings.i"
 %import "pyuaf/client/client_requests.i"
 %import "pyuaf/client/client_results.i"
@@ -146,6 +154,12 @@ import time
 %rename(__dispatch_connectErrorReceived__)    				uaf::ClientInterface::connectErrorReceived;
 
 
+// the batch callbacks refer to SDK memory that is only valid during the call, so they are only
+// available in C++
+%ignore uaf::ClientInterface::dataChangeBatchReceived;
+%ignore uaf::ClientInterface::eventBatchReceived;
+
+
 // now include all classes in a generic way
 UAF_WRAP_CLASS("uaf/client/subscriptions/subscriptioninformation.h"   , uaf , SubscriptionInformation   , COPY_YES, TOSTRING_YES, COMP_YES, pyuaf.client, SubscriptionInformationVector)
 UAF_WRAP_CLASS("uaf/client/subscriptions/monitorediteminformation.h"  , uaf , MonitoredItemInformation  , COPY_YES, TOSTRING_YES, COMP_YES, pyuaf.client, MonitoredItemInformationVector)
@@ -154,7 +168,37 @@ UAF_WRAP_CLASS("uaf/client/subscriptions/datachangenotification.h"    , uaf , Da
 UAF_WRAP_CLASS("uaf/client/subscriptions/eventnotification.h"         , uaf , EventNotification         , COPY_YES, TOSTRING_YES, COMP_YES, pyuaf.client, EventNotificationVector)
 UAF_WRAP_CLASS("uaf/client/subscriptions/keepalivenotification.h"     , uaf , KeepAliveNotification     , COPY_YES, TOSTRING_YES, COMP_NO,  pyuaf.client, VECTOR_NO)
 UAF_WRAP_CLASS("uaf/client/sessions/sessioninformation.h"             , uaf , SessionInformation        , COPY_YES, TOSTRING_YES, COMP_YES, pyuaf.client, SessionInformationVector)
+UAF_WRAP_CLASS("uaf/client/subscriptions/notificationdispatchstatistics.h", uaf , NotificationDispatchStatistics, COPY_YES, TOSTRING_YES, COMP_NO, pyuaf.client, VECTOR_NO)
+UAF_WRAP_CLASS("uaf/client/resolution/resolutionstatistics.h"         , uaf , ResolutionStatistics      , COPY_YES, TOSTRING_YES, COMP_NO,  pyuaf.client, VECTOR_NO)
+UAF_WRAP_CLASS("uaf/client/subscriptions/latestvalue.h"               , uaf , LatestValue               , COPY_YES, TOSTRING_YES, COMP_NO,  pyuaf.client, LatestValueVector)
 UAF_WRAP_CLASS("uaf/client/clientinterface.h"                         , uaf , ClientInterface           , COPY_NO,  TOSTRING_NO,  COMP_NO,  pyuaf.client, VECTOR_NO)
+UAF_WRAP_CLASS("uaf/client/preparedread.h"                            , uaf , PreparedRead              , COPY_NO,  TOSTRING_NO,  COMP_NO,  pyuaf.client, VECTOR_NO)
+
+
+// The futures can only be waited for from Python (continuations and waiting for several 
+// futures at once are only available in C++). Note that BrowseNextResult is the same type as 
+// BrowseResult, so browseNextAsync() returns a BrowseFuture.
+%ignore uaf::Future::then;
+%ignore uaf::Future::waitAll;
+%ignore uaf::Future::waitAny;
+%include "uaf/client/future.h"
+%template(ReadFuture)                           uaf::Future<uaf::ReadResult>;
+%template(WriteFuture)                          uaf::Future<uaf::WriteResult>;
+%template(MethodCallFuture)                     uaf::Future<uaf::MethodCallResult>;
+%template(BrowseFuture)                         uaf::Future<uaf::BrowseResult>;
+%template(TranslateBrowsePathsToNodeIdsFuture)  uaf::Future<uaf::TranslateBrowsePathsToNodeIdsResult>;
+%template(HistoryReadRawModifiedFuture)         uaf::Future<uaf::HistoryReadRawModifiedResult>;
+
+
+// The callbacks of monitored items can be implemented in Python (by subclassing 
+// DataChangeCallback or EventCallback), so that several of them can be registered for the same 
+// ClientHandle.
+%feature("director") uaf::Callback<uaf::DataChangeNotification>;
+%feature("director") uaf::Callback<uaf::EventNotification>;
+%rename(__call__) uaf::Callback::operator();
+%include "uaf/util/callbacks.h"
+%template(DataChangeCallback)                   uaf::Callback<uaf::DataChangeNotification>;
+%template(EventCallback)                        uaf::Callback<uaf::EventNotification>;
 
 
 // Client is quite a special class so we treat it here:
@@ -78,6 +78,10 @@
 %import(module="pyuaf.util")                        "pyuaf/util/util_util.i"
 
 
+// import the necessary dependencies from pyuaf.client
+%import(module="pyuaf.client.overflowpolicies")    "pyuaf/client/client_overflowpolicies.i"
+
+
 // also include the typemaps
 #if defined(SWIGPYTHON)
     %include "pyuaf/util/util_bytestring_python.i"
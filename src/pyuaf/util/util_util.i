@@ -128,6 +128,10 @@
 %ignore extractServerUri(const Address& object, std::string& serverUri);
 %ignore operator>(const DateTime&, const DateTime&);
 %ignore uaf::DateTime::DateTime(const FILETIME& t);
+%ignore uaf::NodeId::nameSpaceUriEntry;
+%ignore uaf::NodeId::setNameSpaceUri(const uaf::NamespaceUriTable::Entry* uri);
+%ignore uaf::QualifiedName::nameSpaceUriEntry;
+%ignore uaf::QualifiedName::setNameSpaceUri(const uaf::NamespaceUriTable::Entry* nameSpaceUri);
 
 // The default SWIG output returned by uaf::Status::opcUaStatusCode() is a signed representation (Long) of an unsigned 32-bit integer.
 // The returned value (a Long which can only be positive) does not correspond bit-to-bit to the original OPC UA status codes, e.g. as found in
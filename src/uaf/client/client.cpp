@@ -20,6 +20,9 @@
 
 #include "uaf/client/client.h"
 
+// STD
+#include <algorithm>
+
 
 namespace uaf
 {
@@ -80,11 +83,13 @@ namespace uaf
     {
         currentRequestHandle_ = 0;
         doFinishThread_ = false;
+        noOfCoalescedReads_ = 0;
 
         database_       = new Database(logger_->loggerFactory());
         discoverer_     = new Discoverer(logger_->loggerFactory(), database_);
         sessionFactory_ = new SessionFactory(logger_->loggerFactory(), this, discoverer_, database_);
         resolver_       = new Resolver(logger_->loggerFactory(), sessionFactory_, database_);
+        futurePool_     = new InvocationPool(logger_->loggerFactory());
 
         logger_->debug("Now starting the thread to periodically check the requests");
 
@@ -108,10 +113,21 @@ namespace uaf
 
         wait();
 
+        // from now on, the notifications are passed to the callbacks directly
+        database_->notificationDispatcher.stop();
+
+        // first finish the futures that are still being processed (they need the resolver and
+        // the session factory)
+        delete futurePool_;
+        futurePool_ = 0;
 
         delete resolver_;
         resolver_ = 0;
 
+        // save the address cache before the sessions are disconnected (which clears the cache)
+        if (!database_->clientSettings.addressCacheFile.empty())
+            database_->addressCache.save(database_->clientSettings.addressCacheFile);
+
         delete sessionFactory_;
         sessionFactory_ = 0;
 
@@ -146,8 +162,19 @@ namespace uaf
         logger_->loggerFactory()->setCallbackLevel(settings.logToCallbackLevel);
 
         bool doFindServers = (settings.discoveryUrls != database_->clientSettings.discoveryUrls);
+        bool doLoadAddressCache = (   !settings.addressCacheFile.empty()
+                                   &&  settings.addressCacheFile
+                                           != database_->clientSettings.addressCacheFile);
         database_->clientSettings = settings;
 
+        database_->notificationDispatcher.configure(this, settings);
+
+        if (doLoadAddressCache)
+        {
+            logger_->debug("The addressCacheFile was changed, so we load the cached addresses");
+            resolver_->countLoadedAddresses(database_->addressCache.load(settings.addressCacheFile));
+        }
+
         if (doFindServers)
         {
             logger_->debug("The discoveryUrls were changed, so we rediscover the system");
@@ -754,6 +781,66 @@ namespace uaf
     }
 
 
+    // Get the statistics of the notification dispatcher
+    // =============================================================================================
+    NotificationDispatchStatistics Client::notificationDispatchStatistics()
+    {
+        return database_->notificationDispatcher.statistics();
+    }
+
+
+    // Get the statistics of the resolver
+    // =============================================================================================
+    ResolutionStatistics Client::resolutionStatistics()
+    {
+        return resolver_->statistics();
+    }
+
+
+    // Get the latest value of a monitored item
+    // =============================================================================================
+    Status Client::latestValue(ClientHandle clientHandle, LatestValue& latestValue)
+    {
+        if (database_->latestValueStore.find(clientHandle, latestValue))
+            return statuscodes::Good;
+        else
+            return UnknownClientHandleError(clientHandle);
+    }
+
+
+    // Get the latest value of a monitored node
+    // =============================================================================================
+    Status Client::latestValue(const Address& address, LatestValue& latestValue)
+    {
+        vector<Address>         addresses(1, address);
+        vector<ExpandedNodeId>  expandedNodeIds;
+        vector<Status>          statuses;
+
+        Status ret = resolver_->resolve(addresses, expandedNodeIds, statuses);
+
+        if (ret.isGood() && statuses.size() == 1 && statuses[0].isNotGood())
+            ret = statuses[0];
+
+        if (ret.isGood() && expandedNodeIds.size() == 1)
+        {
+            if (!database_->latestValueStore.find(expandedNodeIds[0], latestValue))
+                ret = UnknownClientHandleError();
+        }
+
+        return ret;
+    }
+
+
+    // Get the latest values of all monitored items
+    // =============================================================================================
+    vector<LatestValue> Client::latestValues()
+    {
+        vector<LatestValue> ret;
+        database_->latestValueStore.snapshot(ret);
+        return ret;
+    }
+
+
     // Set the publishing mode.
     // =============================================================================================
     Status Client::setPublishingMode(
@@ -932,18 +1019,76 @@ namespace uaf
 
                 if (!doFinishThread_)
                     processPersistedRequests(database_->createMonitoredEventsRequestStore);
+
+                if (   !doFinishThread_
+                    && database_->clientSettings.addressCacheModelChangeEventsEnable)
+                    monitorModelChanges();
             }
         }
     }
 
 
+    // Monitor the model change events of the connected servers
+    // =============================================================================================
+    void Client::monitorModelChanges()
+    {
+        vector<SessionInformation> sessionInformations = sessionFactory_->allSessionInformations();
+
+        for (vector<SessionInformation>::const_iterator it = sessionInformations.begin();
+             it != sessionInformations.end() && !doFinishThread_;
+             ++it)
+        {
+            if (   it->sessionState != uaf::sessionstates::Connected
+                || database_->addressCache.hasModelChangeMonitoredItem(it->serverUri))
+                continue;
+
+            logger_->debug("Monitoring the model change events of ServerUri '%s'",
+                           it->serverUri.c_str());
+
+            // the Server object notifies all model changes of the server
+            CreateMonitoredEventsRequest request;
+            request.targets.push_back(CreateMonitoredEventsRequestTarget(
+                    Address(NodeId(OpcUaId_Server, 0), it->serverUri),
+                    AddressCache::modelChangeEventFilter()));
+
+            CreateMonitoredEventsResult result;
+            Status status = processRequest(request, result);
+
+            if (status.isNotGood())
+                logger_->warning("The model change events of ServerUri '%s' are not monitored "
+                                 "yet", it->serverUri.c_str());
+
+            // like all monitored items, it will be (re)created automatically once it has a
+            // ClientHandle
+            if (   result.targets.size() == 1
+                && result.targets[0].clientHandle != uaf::constants::CLIENTHANDLE_NOT_ASSIGNED)
+                database_->addressCache.addModelChangeMonitoredItem(
+                        result.targets[0].clientHandle,
+                        it->serverUri);
+        }
+    }
+
+
 
 
     // Process a ReadRequest
     // =============================================================================================
     Status Client::processRequest(const uaf::ReadRequest& request, uaf::ReadResult& result)
     {
-        return processRequest<ReadService>(request, result);
+        const ClientSettings& settings = database_->clientSettings;
+
+        // small requests may be coalesced with other concurrent read requests
+        if (settings.readCoalescingEnable
+                && request.requestHandle() == uaf::constants::REQUESTHANDLE_NOT_ASSIGNED
+                && request.targets.size() > 0
+                && request.targets.size() < settings.readCoalescingMaxTargets)
+            return processCoalescedRead(
+                    request,
+                    settings.readCoalescingWindowMs,
+                    settings.readCoalescingMaxTargets,
+                    result);
+        else
+            return processRequest<ReadService>(request, result);
     }
 
     // Process a ReadRequest
@@ -1045,6 +1190,389 @@ namespace uaf
     }
 
 
+    // Prepare a read request
+    // =============================================================================================
+    Status Client::prepare(const uaf::ReadRequest& request, uaf::PreparedRead& preparedRead)
+    {
+        UaMutexLocker locker(&preparedRead.mutex_); // auto-unlocks when out of scope
+
+        preparedRead.client_  = this;
+        preparedRead.request_ = request;
+
+        return prepareRead(preparedRead);
+    }
+
+
+    // Execute a prepared read request
+    // =============================================================================================
+    Status Client::execute(uaf::PreparedRead& preparedRead, uaf::ReadResult& result)
+    {
+        UaMutexLocker locker(&preparedRead.mutex_); // auto-unlocks when out of scope
+
+        Status ret;
+
+        if (preparedRead.client_ != this)
+        {
+            ret = ReadNotPreparedError();
+        }
+        else
+        {
+            ret = statuscodes::Good;
+
+            // (re)prepare the read if needed, and execute it (preparing it again at most once if
+            // the prepared invocations turn out to be outdated)
+            bool outdated = !preparedRead.prepared_;
+            bool executed = false;
+            for (int attempt = 0; attempt < 2 && !executed && ret.isGood(); attempt++)
+            {
+                if (outdated)
+                {
+                    logger_->debug("Preparing the read (again)");
+                    ret = prepareRead(preparedRead);
+                }
+
+                if (ret.isGood())
+                {
+                    ret = executePreparedRead(preparedRead, result, outdated);
+                    executed = !outdated;
+                }
+            }
+
+            if (ret.isGood() && !executed)
+                ret = ReadNotPreparedError();
+        }
+
+        return ret;
+    }
+
+
+    // Resolve the request of a prepared read and prepare its invocations
+    // =============================================================================================
+    Status Client::prepareRead(uaf::PreparedRead& preparedRead)
+    {
+        Status ret;
+
+        // delete the invocations that were prepared before
+        preparedRead.clear();
+
+        // resolve a copy of the request
+        preparedRead.resolvedRequest_ = preparedRead.request_;
+        preparedRead.resolvedResult_  = ReadResult();
+        preparedRead.resolvedResult_.targets.resize(preparedRead.request_.targets.size());
+
+        Mask mask(preparedRead.request_.targets.size(), true);
+
+        ret = resolver_->resolve<ReadService>(
+                preparedRead.resolvedRequest_,
+                mask,
+                preparedRead.resolvedResult_);
+
+        // prepare the invocations for the resolved targets
+        if (ret.isGood())
+            ret = sessionFactory_->prepareRequest<ReadService>(
+                    preparedRead.resolvedRequest_,
+                    mask && preparedRead.resolvedResult_.getGoodTargetsMask(),
+                    preparedRead.resolvedResult_,
+                    preparedRead.invocations_);
+
+        if (ret.isGood())
+            preparedRead.prepared_ = true;
+        else
+            preparedRead.clear();
+
+        return ret;
+    }
+
+
+    // Invoke the prepared invocations of a prepared read
+    // =============================================================================================
+    Status Client::executePreparedRead(
+            uaf::PreparedRead&  preparedRead,
+            uaf::ReadResult&    result,
+            bool&               outdated)
+    {
+        Status ret;
+
+        // start from the result of the resolution, which contains the statuses of the
+        // unresolved targets
+        result = preparedRead.resolvedResult_;
+
+        // each execution is a new request, so it gets a new handle
+        ret = assignRequestHandle<ReadService>(preparedRead.resolvedRequest_, result);
+
+        if (ret.isGood())
+            ret = sessionFactory_->invokePreparedRequest<ReadService>(
+                    preparedRead.resolvedRequest_,
+                    preparedRead.invocations_,
+                    result,
+                    outdated);
+
+        result.updateOverallStatus();
+
+        if (ret.isGood() && !outdated)
+        {
+            UAF_LOG_DEBUG(logger_, ("Prepared ReadResult %d:", result.requestHandle));
+            UAF_LOG_DEBUG(logger_, (result.toString()));
+        }
+
+        return ret;
+    }
+
+
+    // Check if two read requests can be coalesced (i.e. if they have the same settings)
+    // =============================================================================================
+    static bool haveSameReadSettings(const ReadRequest& request1, const ReadRequest& request2)
+    {
+        return request1.clientConnectionIdGiven == request2.clientConnectionIdGiven
+            && request1.clientConnectionId == request2.clientConnectionId
+            && request1.serviceSettingsGiven == request2.serviceSettingsGiven
+            && request1.serviceSettings.maxAgeSec == request2.serviceSettings.maxAgeSec
+            && static_cast<const ServiceSettings&>(request1.serviceSettings)
+                    == static_cast<const ServiceSettings&>(request2.serviceSettings)
+            && request1.translateSettingsGiven == request2.translateSettingsGiven
+            && request1.translateSettings == request2.translateSettings
+            && request1.sessionSettingsGiven == request2.sessionSettingsGiven
+            && request1.sessionSettings == request2.sessionSettings;
+    }
+
+
+    // Process a read request together with other concurrent read requests
+    // =============================================================================================
+    Status Client::processCoalescedRead(
+            const uaf::ReadRequest& request,
+            uint32_t                windowMs,
+            uint32_t                maxTargets,
+            uaf::ReadResult&        result)
+    {
+        ReadBatch*  batch = 0;
+        bool        leader;
+        bool        closed;
+        bool        alone;
+        std::size_t offset;
+        std::size_t noOfTargets = request.targets.size();
+
+        // join an open batch with the same settings, or open a new one
+        readBatchesMutex_.lock();
+
+        noOfCoalescedReads_++;
+
+        vector<ReadBatch*>::iterator it;
+        for (it = openReadBatches_.begin(); it != openReadBatches_.end() && batch == 0; ++it)
+        {
+            if ((*it)->request.targets.size() + noOfTargets <= maxTargets
+                    && haveSameReadSettings((*it)->request, request))
+                batch = *it;
+        }
+
+        leader = (batch == 0);
+
+        if (leader)
+        {
+            batch = new ReadBatch;
+            copyRequest(request, batch->request);
+            batch->request.targets.clear();
+            openReadBatches_.push_back(batch);
+        }
+        else
+        {
+            batch->refCount++;
+        }
+
+        offset = batch->request.targets.size();
+        batch->request.targets.insert(
+                batch->request.targets.end(),
+                request.targets.begin(),
+                request.targets.end());
+
+        // close the batch if it's full, and let the leader know
+        if (batch->request.targets.size() >= maxTargets)
+        {
+            openReadBatches_.erase(std::find(openReadBatches_.begin(), openReadBatches_.end(), batch));
+            batch->closed = true;
+            if (!leader)
+                batch->full.post(1);
+        }
+
+        closed = batch->closed;
+
+        // if no other read request is being processed, it's unlikely that one will join soon
+        alone = (noOfCoalescedReads_ == 1);
+
+        readBatchesMutex_.unlock();
+
+        if (leader)
+        {
+            // wait for other requests to join
+            if (!closed && !alone)
+                batch->full.timedWait(windowMs);
+
+            readBatchesMutex_.lock();
+            if (!batch->closed)
+            {
+                openReadBatches_.erase(std::find(openReadBatches_.begin(), openReadBatches_.end(), batch));
+                batch->closed = true;
+            }
+            uint32_t noOfFollowers = batch->refCount - 1;
+            readBatchesMutex_.unlock();
+
+            UAF_LOG_DEBUG(logger_, ("Reading %d coalesced read requests with %d targets at once",
+                                    noOfFollowers + 1, batch->request.targets.size()));
+
+            batch->status = processRequest<ReadService>(batch->request, batch->result);
+
+            // wake up the followers
+            if (noOfFollowers > 0)
+                batch->done.post(noOfFollowers);
+        }
+        else
+        {
+            batch->done.wait();
+        }
+
+        Status ret = batch->status;
+
+        // release the batch
+        readBatchesMutex_.lock();
+        bool shared = (batch->refCount > 1);
+        bool last   = (--batch->refCount == 0);
+        readBatchesMutex_.unlock();
+
+        if (ret.isGood())
+        {
+            // copy our part of the combined result
+            result.targets.assign(
+                    batch->result.targets.begin() + offset,
+                    batch->result.targets.begin() + offset + noOfTargets);
+
+            // each request gets its own handle (only the handle of the dummy request is assigned)
+            ReadRequest handleRequest;
+            ret = assignRequestHandle<ReadService>(handleRequest, result);
+
+            result.updateOverallStatus();
+        }
+
+        if (last)
+            delete batch;
+
+        if (ret.isNotGood() && shared)
+        {
+            // the combined request failed as a whole (e.g. because the server of another
+            // request could not be reached), so our targets may not even have been read:
+            // read them on their own, so we only get our own errors
+            UAF_LOG_DEBUG(logger_, ("The coalesced read failed, so the %d targets are read again",
+                                    noOfTargets));
+            result = ReadResult();
+            ret = processRequest<ReadService>(request, result);
+        }
+
+        readBatchesMutex_.lock();
+        noOfCoalescedReads_--;
+        readBatchesMutex_.unlock();
+
+        return ret;
+    }
+
+
+    // Job to process the request of a future
+    // =============================================================================================
+    template<typename _Service>
+    class Client::FutureJob : public uaf::InvocationJob
+    {
+    public:
+
+        FutureJob(
+                uaf::Client*                                        client,
+                const typename _Service::Request&                   request,
+                const uaf::Future<typename _Service::Result>&       future)
+        : client_(client),
+          request_(request),
+          future_(future)
+        {}
+
+        virtual void execute()
+        {
+            client_->processFutureRequest<_Service>(request_, future_);
+        }
+
+    private:
+        uaf::Client*                            client_;
+        typename _Service::Request              request_;
+        uaf::Future<typename _Service::Result>  future_;
+    };
+
+
+    // Read without waiting for the result
+    // =============================================================================================
+    Future<ReadResult> Client::readAsync(const ReadRequest& request)
+    {
+        AsyncReadRequest asyncRequest;
+        copyRequest(request, asyncRequest);
+        return beginFutureRequest<AsyncReadService, ReadResult>(asyncRequest);
+    }
+
+
+    // Write without waiting for the result
+    // =============================================================================================
+    Future<WriteResult> Client::writeAsync(const WriteRequest& request)
+    {
+        AsyncWriteRequest asyncRequest;
+        copyRequest(request, asyncRequest);
+        return beginFutureRequest<AsyncWriteService, WriteResult>(asyncRequest);
+    }
+
+
+    // Call a method without waiting for the result
+    // =============================================================================================
+    Future<MethodCallResult> Client::callAsync(const MethodCallRequest& request)
+    {
+        // the asynchronous Call service only supports a single target
+        if (request.targets.size() == 1)
+        {
+            AsyncMethodCallRequest asyncRequest;
+            copyRequest(request, asyncRequest);
+            return beginFutureRequest<AsyncMethodCallService, MethodCallResult>(asyncRequest);
+        }
+        else
+        {
+            return postFutureRequest<MethodCallService>(request);
+        }
+    }
+
+
+    // Browse without waiting for the result
+    // =============================================================================================
+    Future<BrowseResult> Client::browseAsync(const BrowseRequest& request)
+    {
+        return postFutureRequest<BrowseService>(request);
+    }
+
+
+    // Browse next without waiting for the result
+    // =============================================================================================
+    Future<BrowseNextResult> Client::browseNextAsync(const BrowseNextRequest& request)
+    {
+        return postFutureRequest<BrowseNextService>(request);
+    }
+
+
+    // Translate browse paths without waiting for the result
+    // =============================================================================================
+    Future<TranslateBrowsePathsToNodeIdsResult> Client::translateBrowsePathsToNodeIdsAsync(
+            const TranslateBrowsePathsToNodeIdsRequest& request)
+    {
+        return postFutureRequest<TranslateBrowsePathsToNodeIdsService>(request);
+    }
+
+
+    // Read historical data without waiting for the result
+    // =============================================================================================
+    Future<HistoryReadRawModifiedResult> Client::historyReadRawModifiedAsync(
+            const HistoryReadRawModifiedRequest& request)
+    {
+        return postFutureRequest<HistoryReadRawModifiedService>(request);
+    }
+
+
     // Get a structure definition
     // =============================================================================================
     Status Client::structureDefinition(const uaf::NodeId &dataTypeId, uaf::StructureDefinition& definition)
@@ -1089,6 +1617,123 @@ namespace uaf
     }
 
 
+    // Private template function implementation: copy the targets and settings of a request
+    // =============================================================================================
+    template<typename _FromRequest, typename _ToRequest>
+    void Client::copyRequest(const _FromRequest& from, _ToRequest& to)
+    {
+        to.targets                  = from.targets;
+        to.clientConnectionIdGiven  = from.clientConnectionIdGiven;
+        to.clientConnectionId       = from.clientConnectionId;
+        to.serviceSettingsGiven     = from.serviceSettingsGiven;
+        to.serviceSettings          = from.serviceSettings;
+        to.translateSettingsGiven   = from.translateSettingsGiven;
+        to.translateSettings        = from.translateSettings;
+        to.sessionSettingsGiven     = from.sessionSettingsGiven;
+        to.sessionSettings          = from.sessionSettings;
+    }
+
+
+    // Private template function implementation: begin the asynchronous request of a future
+    // =============================================================================================
+    template<typename _AsyncService, typename _Result>
+    Future<_Result> Client::beginFutureRequest(const typename _AsyncService::Request& request)
+    {
+        Status ret;
+
+        typename _AsyncService::Request copiedRequest(request);
+        typename _AsyncService::Result  asyncResult;
+
+        // the future must be registered under its request handle before the request is sent,
+        // since the result may arrive before processRequest() returns
+        ret = assignRequestHandle<_AsyncService>(copiedRequest, asyncResult);
+
+        Future<_Result> future(asyncResult.requestHandle);
+
+        bool completeNow;
+
+        if (ret.isGood())
+        {
+            sessionFactory_->registerFuture(future);
+            ret = processRequest<_AsyncService>(copiedRequest, asyncResult);
+
+            // if no target could be sent, the result will never arrive: complete the future now
+            // with the statuses that are already known (unless the result did arrive already)
+            bool sent = ret.isGood() && asyncResult.getGoodTargetsMask().setCount() > 0;
+            completeNow = !sent && sessionFactory_->unregisterFuture(future);
+        }
+        else
+        {
+            completeNow = true;
+        }
+
+        if (completeNow)
+        {
+            _Result result;
+            result.requestHandle = asyncResult.requestHandle;
+            result.targets.resize(asyncResult.targets.size());
+            for (std::size_t i = 0; i < asyncResult.targets.size(); i++)
+                result.targets[i].status = asyncResult.targets[i].status;
+            result.updateOverallStatus();
+            if (ret.isBad())
+                result.overallStatus = ret;
+
+            future.setResult(result);
+        }
+
+        return future;
+    }
+
+
+    // Private template function implementation: post the synchronous request of a future
+    // =============================================================================================
+    template<typename _Service>
+    Future<typename _Service::Result> Client::postFutureRequest(
+            const typename _Service::Request& request)
+    {
+        typename _Service::Request copiedRequest(request);
+        typename _Service::Result  result;
+
+        Status ret = assignRequestHandle<_Service>(copiedRequest, result);
+
+        Future<typename _Service::Result> future(result.requestHandle);
+
+        if (ret.isGood())
+        {
+            futurePool_->post(
+                    new FutureJob<_Service>(this, copiedRequest, future),
+                    database_->clientSettings.futureMaxThreads);
+        }
+        else
+        {
+            result.overallStatus = ret;
+            future.setResult(result);
+        }
+
+        return future;
+    }
+
+
+    // Private template function implementation: process the synchronous request of a future
+    // =============================================================================================
+    template<typename _Service>
+    void Client::processFutureRequest(
+            const typename _Service::Request&               request,
+            const Future<typename _Service::Result>&        future)
+    {
+        typename _Service::Result result;
+
+        // the request handle was already assigned by postFutureRequest()
+        Status ret = processRequest<_Service>(request, result);
+
+        result.requestHandle = future.requestHandle();
+        if (ret.isBad())
+            result.overallStatus = ret;
+
+        future.setResult(result);
+    }
+
+
     // Private template function implementation: process persistent requests
     // =============================================================================================
     template<typename _Store>
@@ -1138,8 +1783,8 @@ namespace uaf
         // declare the return Status
         uaf::Status ret;
 
-        logger_->debug("Processing the following %sRequest:", _Service::name().c_str());
-        logger_->debug(request.toString());
+        UAF_LOG_DEBUG(logger_, ("Processing the following %sRequest:", _Service::name().c_str()));
+        UAF_LOG_DEBUG(logger_, (request.toString()));
 
         // resize the result
         result.targets.resize(request.targets.size());
@@ -1178,7 +1823,14 @@ namespace uaf
         if (ret.isGood())
         {
             uaf::Mask resolvedMask = mask && result.getGoodTargetsMask();
+
+            // answer the targets from the value cache if possible (only for reads)
+            uaf::readFromValueCacheIfNeeded<_Service>(copiedRequest, resolvedMask, result, database_);
+
             ret = sessionFactory_->invokeRequest<_Service>(copiedRequest, resolvedMask, result);
+
+            // update the value cache if needed (only for reads and writes)
+            uaf::updateValueCacheIfNeeded<_Service>(copiedRequest, resolvedMask, result, database_);
         }
 
         // finally, update the overall status
@@ -1192,8 +1844,8 @@ namespace uaf
         // log the result, if good
         if (ret.isGood())
         {
-            logger_->debug("%sResult %d:", _Service::name().c_str(), result.requestHandle);
-            logger_->debug(result.toString());
+            UAF_LOG_DEBUG(logger_, ("%sResult %d:", _Service::name().c_str(), result.requestHandle));
+            UAF_LOG_DEBUG(logger_, (result.toString()));
         }
 
         // if client handles were assigned, copy them to the diagnostics of the Status object
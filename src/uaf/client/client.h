@@ -42,6 +42,9 @@
 #include "uaf/client/resolution/resolver.h"
 #include "uaf/client/sessions/sessionfactory.h"
 #include "uaf/client/clientservices.h"
+#include "uaf/client/preparedread.h"
+#include "uaf/client/future.h"
+#include "uaf/client/readbatch.h"
 
 
 
@@ -199,10 +202,9 @@ namespace uaf
         /**
          * Read a number of node attributes asynchronously.
          *
-         * Note that asynchronous requests MUST be invoked on a single session. Meaning:
-         * if you provide multiple addresses to beginRead(), the addresses MUST point to nodes that
-         * belong to the same server (as the UAF can currently not reconstruct an asynchronous
-         * request that must be "split up" to be called on multiple servers).
+         * If the addresses point to nodes that belong to different servers, the request is
+         * split up into one asynchronous transaction per session, and the result is reassembled
+         * before the callback function is called (so it is called only once per request).
          *
          * @param addresses       Addresses of the nodes of which the attributes should be read.
          * @param attributeId     The attribute to be read (e.g. Value or DisplayName).
@@ -246,10 +248,9 @@ namespace uaf
         /**
          * Write a number of node attributes asynchronously.
          *
-         * Note that asynchronous requests MUST be invoked on a single session. Meaning:
-         * if you provide multiple addresses to beginWrite(), the addresses MUST point to nodes that
-         * belong to the same server (as the UAF can currently not reconstruct an asynchronous
-         * request that must be "split up" to be called on multiple servers).
+         * If the addresses point to nodes that belong to different servers, the request is
+         * split up into one asynchronous transaction per session, and the result is reassembled
+         * before the callback function is called (so it is called only once per request).
          *
          * @param addresses         Addresses of the nodes of which the attribute should be written.
          * @param data              Data values that should be written (one data value per address).
@@ -737,6 +738,139 @@ namespace uaf
                 const uaf::HistoryReadRawModifiedRequest&  request,
                 uaf::HistoryReadRawModifiedResult&         result);
 
+        /**
+         * Prepare a synchronous read request, so that it can be executed many times (e.g. for
+         * cyclic polling) with a minimum of overhead.
+         *
+         * The targets are resolved, the sessions are connected, and the Read service calls are
+         * built and encoded only once. Executing the prepared read (see execute()) then only
+         * sends the service calls and decodes the values. Targets that could not be resolved
+         * keep their bad status until the read is prepared again.
+         *
+         * When the prepared read is executed after one of its sessions has reconnected (so the
+         * NamespaceArray of the server may have changed) or was deleted, it is prepared again
+         * automatically.
+         *
+         * @param request       The request to prepare.
+         * @param preparedRead  The prepared read (which must not outlive the client).
+         * @return              The client-side status.
+         */
+        uaf::Status prepare(
+                const uaf::ReadRequest&    request,
+                uaf::PreparedRead&         preparedRead);
+
+        /**
+         * Execute a read that was prepared by prepare().
+         *
+         * @param preparedRead  The prepared read.
+         * @param result        The result.
+         * @return              The client-side status.
+         */
+        uaf::Status execute(
+                uaf::PreparedRead&         preparedRead,
+                uaf::ReadResult&           result);
+
+
+        ///@} //////////////////////////////////////////////////////////////////////////////////////
+        /**
+         *  @name Futures
+         *  Process requests without waiting for their results.
+         *
+         *  The results are delivered to a uaf::Future, which can be waited for or which can call
+         *  continuations. Note that the targets of the requests are still resolved (and the
+         *  sessions are still connected, if needed) by the calling thread.
+         */
+        ///@{
+
+        /**
+         * Process a read request without waiting for the result.
+         *
+         * The request is sent as an asynchronous Read service call, so no thread is blocked
+         * while the request is in progress. The result is delivered to the returned future (and
+         * not to readComplete()).
+         *
+         * @param request   The request.
+         * @return          The future result. If the request could not be sent, the future holds
+         *                  a result with the client-side status as its overallStatus.
+         */
+        uaf::Future<uaf::ReadResult> readAsync(const uaf::ReadRequest& request);
+
+        /**
+         * Process a write request without waiting for the result.
+         *
+         * The request is sent as an asynchronous Write service call, so no thread is blocked
+         * while the request is in progress. The result is delivered to the returned future (and
+         * not to writeComplete()).
+         *
+         * @param request   The request.
+         * @return          The future result. If the request could not be sent, the future holds
+         *                  a result with the client-side status as its overallStatus.
+         */
+        uaf::Future<uaf::WriteResult> writeAsync(const uaf::WriteRequest& request);
+
+        /**
+         * Process a method call request without waiting for the result.
+         *
+         * A request with a single target is sent as an asynchronous Call service call (and its
+         * result is not delivered to callComplete()). A request with multiple targets is
+         * processed synchronously by one of the ClientSettings::futureMaxThreads worker threads.
+         *
+         * @param request   The request.
+         * @return          The future result. If the request could not be sent, the future holds
+         *                  a result with the client-side status as its overallStatus.
+         */
+        uaf::Future<uaf::MethodCallResult> callAsync(const uaf::MethodCallRequest& request);
+
+        /**
+         * Process a browse request without waiting for the result.
+         *
+         * The request is processed synchronously by one of the ClientSettings::futureMaxThreads
+         * worker threads.
+         *
+         * @param request   The request.
+         * @return          The future result. If the request failed, the future holds a result
+         *                  with the client-side status as its overallStatus.
+         */
+        uaf::Future<uaf::BrowseResult> browseAsync(const uaf::BrowseRequest& request);
+
+        /**
+         * Process a browse next request without waiting for the result.
+         *
+         * The request is processed synchronously by one of the ClientSettings::futureMaxThreads
+         * worker threads.
+         *
+         * @param request   The request.
+         * @return          The future result. If the request failed, the future holds a result
+         *                  with the client-side status as its overallStatus.
+         */
+        uaf::Future<uaf::BrowseNextResult> browseNextAsync(const uaf::BrowseNextRequest& request);
+
+        /**
+         * Process a TranslateBrowsePathsToNodeIds request without waiting for the result.
+         *
+         * The request is processed synchronously by one of the ClientSettings::futureMaxThreads
+         * worker threads.
+         *
+         * @param request   The request.
+         * @return          The future result. If the request failed, the future holds a result
+         *                  with the client-side status as its overallStatus.
+         */
+        uaf::Future<uaf::TranslateBrowsePathsToNodeIdsResult> translateBrowsePathsToNodeIdsAsync(
+                const uaf::TranslateBrowsePathsToNodeIdsRequest& request);
+
+        /**
+         * Process a HistoryReadRawModified request without waiting for the result.
+         *
+         * The request is processed synchronously by one of the ClientSettings::futureMaxThreads
+         * worker threads.
+         *
+         * @param request   The request.
+         * @return          The future result. If the request failed, the future holds a result
+         *                  with the client-side status as its overallStatus.
+         */
+        uaf::Future<uaf::HistoryReadRawModifiedResult> historyReadRawModifiedAsync(
+                const uaf::HistoryReadRawModifiedRequest& request);
+
 
 
         ///@} //////////////////////////////////////////////////////////////////////////////////////
@@ -1004,6 +1138,61 @@ namespace uaf
                  uaf::MonitoredItemInformation&    monitoredItemInformation);
 
 
+        /**
+         * Get the statistics of the notification dispatch threads (see
+         * ClientSettings::notificationDispatchEnable), such as the number of queued and dropped
+         * notifications.
+         *
+         * @return The current statistics.
+         */
+        uaf::NotificationDispatchStatistics notificationDispatchStatistics();
+
+
+        /**
+         * Get the statistics of the resolver, such as the number of addresses that were resolved
+         * by the address cache and the number of browse paths that had to be translated by the
+         * servers.
+         *
+         * @return The current statistics.
+         */
+        uaf::ResolutionStatistics resolutionStatistics();
+
+
+        /**
+         * Get the latest value that was received by a monitored data item (see
+         * ClientSettings::latestValueStoreEnable).
+         *
+         * @param clientHandle  The handle identifying the monitored item.
+         * @param latestValue   Output parameter, giving you the latest value of the monitored item.
+         * @return              Good if the monitored item could be found, Bad if not.
+         */
+        uaf::Status latestValue(
+                 uaf::ClientHandle      clientHandle,
+                 uaf::LatestValue&      latestValue);
+
+
+        /**
+         * Get the latest value that was received for a monitored node (see
+         * ClientSettings::latestValueStoreEnable). The address is resolved first, if needed.
+         *
+         * @param address       The address of the monitored node.
+         * @param latestValue   Output parameter, giving you the latest value of the monitored node.
+         * @return              Good if the node is monitored, Bad if not.
+         */
+        uaf::Status latestValue(
+                 const uaf::Address&    address,
+                 uaf::LatestValue&      latestValue);
+
+
+        /**
+         * Get the latest values of all monitored data items (see
+         * ClientSettings::latestValueStoreEnable).
+         *
+         * @return  A vector of the latest values of all monitored data items.
+         */
+        std::vector<uaf::LatestValue> latestValues();
+
+
         ///@} //////////////////////////////////////////////////////////////////////////////////////
         /**
          *  @name ChangeSubscriptions
@@ -1058,6 +1247,10 @@ namespace uaf
         /**
          *  @name Callbacks
          *  Manage callbacks for monitored items.
+         *
+         *  The callbacks are owned by the caller. Once a callback has been unregistered, it is
+         *  no longer in use (unregistering waits for the running callbacks of the same
+         *  ClientHandles), so it may be deleted.
          */
         ///@{
 
@@ -1065,6 +1258,8 @@ namespace uaf
         /**
         * Register a callback for a monitored data item.
         *
+        * Several callbacks may be registered for the same ClientHandle.
+        *
         * @param clientHandle      The ClientHandle of the monitored item.
         * @param callback          A callback function.
         */
@@ -1084,6 +1279,8 @@ namespace uaf
         /**
         * Register a callback for a monitored event.
         *
+        * Several callbacks may be registered for the same ClientHandle.
+        *
         * @param clientHandle      The ClientHandle of the monitored item.
         * @param callback          A callback function.
         */
@@ -1165,6 +1362,9 @@ namespace uaf
         /** The discoverer (to find servers in the network). */
         uaf::Discoverer* discoverer_;
 
+        /** The worker threads that process the futures of synchronous services. */
+        uaf::InvocationPool* futurePool_;
+
         /** The shared database of the client. */
         uaf::Database* database_;
 
@@ -1177,6 +1377,16 @@ namespace uaf
         /** The mutex to lock when the currentRequestHandle_ is read or manipulated. */
         UaMutex requestHandleMutex_;
 
+        /** The batches of coalesced read requests that can still be joined. */
+        std::vector<uaf::ReadBatch*> openReadBatches_;
+
+        /** The number of read requests that are being coalesced (only to be read or manipulated
+         *  when readBatchesMutex_ is locked). */
+        uint32_t noOfCoalescedReads_;
+
+        /** The mutex to lock when the openReadBatches_ (or the batches) are manipulated. */
+        UaMutex readBatchesMutex_;
+
         /** The callback registry for events. */
         uaf::CallbackRegistry<EventNotification> eventCallbackRegistry_;
 
@@ -1209,6 +1419,53 @@ namespace uaf
          */
         virtual void eventsReceived(std::vector<uaf::EventNotification> notifications);
 
+        /**
+         * Resolve the request of a prepared read, and prepare its invocations.
+         * The mutex of the prepared read must be locked.
+         *
+         * @param preparedRead  The prepared read.
+         * @return              The client-side status.
+         */
+        uaf::Status prepareRead(uaf::PreparedRead& preparedRead);
+
+        /**
+         * Invoke the prepared invocations of a prepared read.
+         * The mutex of the prepared read must be locked.
+         *
+         * @param preparedRead  The prepared read.
+         * @param result        The result.
+         * @param outdated      Output parameter: true if the read needs to be prepared again
+         *                      (in which case nothing was invoked).
+         * @return              The client-side status.
+         */
+        uaf::Status executePreparedRead(
+                uaf::PreparedRead&         preparedRead,
+                uaf::ReadResult&           result,
+                bool&                      outdated);
+
+        /**
+         * Process a read request together with other concurrent read requests that have the
+         * same settings (see ClientSettings::readCoalescingEnable).
+         *
+         * @param request       The request.
+         * @param windowMs      The maximum time to wait for other requests to join.
+         * @param maxTargets    The maximum number of targets of the combined request.
+         * @param result        The result (only containing the targets of this request).
+         * @return              The client-side status.
+         */
+        uaf::Status processCoalescedRead(
+                const uaf::ReadRequest&    request,
+                uint32_t                   windowMs,
+                uint32_t                   maxTargets,
+                uaf::ReadResult&           result);
+
+        /**
+         * Monitor the model change events of the connected servers that are not monitored yet,
+         * so that the address cache can invalidate the addresses of the changed nodes (see
+         * ClientSettings::addressCacheModelChangeEventsEnable).
+         */
+        void monitorModelChanges();
+
 
 
 #ifndef SWIG /* The private template functions below do not need to be seen by SWIG. */
@@ -1296,6 +1553,67 @@ namespace uaf
                 typename _Service::Result&          result);
         // Private template functions can be implemented in the CPP file (keeps the header clean!)
 
+
+        /**
+         * Job to process a request of a future, by one of the worker threads of the futurePool_.
+         */
+        template<typename _Service>
+        class FutureJob;
+
+
+        /**
+         * Copy the targets and the settings of a request to another (e.g. asynchronous) request.
+         *
+         * @param from  The request to copy.
+         * @param to    The request to be updated.
+         */
+        template<typename _FromRequest, typename _ToRequest>
+        static void copyRequest(const _FromRequest& from, _ToRequest& to);
+        // Private template functions can be implemented in the CPP file (keeps the header clean!)
+
+
+        /**
+         * Process an asynchronous request, and deliver its result to a future.
+         *
+         * @tparam _AsyncService    The asynchronous Service type (e.g. uaf::AsyncReadService).
+         * @tparam _Result          The type of the result of the asynchronous request (e.g.
+         *                          uaf::ReadResult).
+         * @param request           The asynchronous request.
+         * @return                  The future result.
+         */
+        template<typename _AsyncService, typename _Result>
+        uaf::Future<_Result> beginFutureRequest(const typename _AsyncService::Request& request);
+        // Private template functions can be implemented in the CPP file (keeps the header clean!)
+
+
+        /**
+         * Let one of the worker threads of the futurePool_ process a synchronous request, and
+         * deliver its result to a future.
+         *
+         * @tparam _Service The synchronous Service type (e.g. uaf::BrowseService).
+         * @param request   The request.
+         * @return          The future result.
+         */
+        template<typename _Service>
+        uaf::Future<typename _Service::Result> postFutureRequest(
+                const typename _Service::Request& request);
+        // Private template functions can be implemented in the CPP file (keeps the header clean!)
+
+
+        /**
+         * Process the synchronous request of a future (by one of the worker threads of the
+         * futurePool_), and deliver its result to the future.
+         *
+         * @tparam _Service The synchronous Service type (e.g. uaf::BrowseService).
+         * @param request   The request (with a request handle already assigned).
+         * @param future    The future that will receive the result.
+         */
+        template<typename _Service>
+        void processFutureRequest(
+                const typename _Service::Request&               request,
+                const uaf::Future<typename _Service::Result>&   future);
+        // Private template functions can be implemented in the CPP file (keeps the header clean!)
+
 #endif  /* SWIG (the section above is not visible by the SWIG preprocessor) */
 
         ///@}
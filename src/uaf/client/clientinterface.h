@@ -32,6 +32,8 @@
 #include "uaf/client/sessions/sessioninformation.h"
 #include "uaf/client/subscriptions/datachangenotification.h"
 #include "uaf/client/subscriptions/eventnotification.h"
+#include "uaf/client/subscriptions/eventbatch.h"
+#include "uaf/client/subscriptions/datachangebatch.h"
 #include "uaf/client/subscriptions/keepalivenotification.h"
 #include "uaf/client/subscriptions/subscriptioninformation.h"
 
@@ -126,6 +128,39 @@ namespace uaf
         virtual void dataChangesReceived(std::vector<uaf::DataChangeNotification> notifications) {}
 
 
+        /**
+         * Override this method to handle all events of a publish response at once, without
+         * copying them into uaf::EventNotification instances.
+         *
+         * This method is called by the thread that received the events from the server, before
+         * the events are passed to eventsReceived() (and to the notification dispatch threads,
+         * if any). The batch is only valid during the call.
+         *
+         * @param batch A view on the received events.
+         * @return      True if the events have been handled, in which case they are not passed
+         *              to eventsReceived() (nor to the registered event callbacks).
+         *              False by default.
+         */
+        virtual bool eventBatchReceived(const uaf::EventBatch& batch) { return false; }
+
+
+        /**
+         * Override this method to handle all data changes of a publish response at once, without
+         * copying them into uaf::DataChangeNotification instances.
+         *
+         * This method is called by the thread that received the data changes from the server,
+         * before the data changes are passed to dataChangesReceived() (and to the notification
+         * dispatch threads, if any). The batch is only valid during the call, and the values are
+         * only decoded when they are requested.
+         *
+         * @param batch A view on the received data changes.
+         * @return      True if the data changes have been handled, in which case they are not
+         *              passed to dataChangesReceived() (nor to the registered data change
+         *              callbacks). False by default.
+         */
+        virtual bool dataChangeBatchReceived(const uaf::DataChangeBatch& batch) { return false; }
+
+
         /**
          * Override this method to handle keep alive notifications.
          *
@@ -20,6 +20,13 @@
 
 #include "uaf/client/database/addresscache.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <set>
+
+#include "uaf/util/modelchangestructuredatatype.h"
+
 
 
 
@@ -32,6 +39,276 @@ namespace uaf
     using std::size_t;
 
 
+    // The file format of a saved address cache (bump the version when the format changes!)
+    // =============================================================================================
+    static const uint32_t FILE_MAGIC        = 0x55414643u; // "UAFC"
+    static const uint32_t FILE_VERSION      = 1;
+    static const uint32_t MAX_STRING_LENGTH = 1024 * 1024;
+    static const int      MAX_PATH_DEPTH    = 64;
+
+
+    // Write an unsigned integer to a file (little endian, so the file is portable)
+    // =============================================================================================
+    static void writeUInt32(std::ostream& out, uint32_t value)
+    {
+        char bytes[4];
+        for (int i = 0; i < 4; i++)
+            bytes[i] = char((value >> (8 * i)) & 0xFF);
+        out.write(bytes, 4);
+    }
+
+
+    // Read an unsigned integer from a file
+    // =============================================================================================
+    static bool readUInt32(std::istream& in, uint32_t& value)
+    {
+        unsigned char bytes[4];
+        if (!in.read(reinterpret_cast<char*>(bytes), 4))
+            return false;
+        value = 0;
+        for (int i = 0; i < 4; i++)
+            value |= uint32_t(bytes[i]) << (8 * i);
+        return true;
+    }
+
+
+    // Write a string to a file
+    // =============================================================================================
+    static void writeString(std::ostream& out, const string& value)
+    {
+        writeUInt32(out, uint32_t(value.size()));
+        out.write(value.data(), value.size());
+    }
+
+
+    // Read a string from a file
+    // =============================================================================================
+    static bool readString(std::istream& in, string& value)
+    {
+        uint32_t length;
+        if (!readUInt32(in, length) || length > MAX_STRING_LENGTH)
+            return false;
+        value.resize(length);
+        return length == 0 || bool(in.read(&value[0], length));
+    }
+
+
+    // Write a NodeId to a file
+    // =============================================================================================
+    static void writeNodeId(std::ostream& out, const NodeId& nodeId)
+    {
+        NodeIdIdentifier identifier = nodeId.identifier();
+
+        writeUInt32(out, uint32_t(identifier.type));
+        if (identifier.type == nodeididentifiertypes::Identifier_Numeric)
+            writeUInt32(out, identifier.idNumeric);
+        else if (identifier.type == nodeididentifiertypes::Identifier_String)
+            writeString(out, identifier.idString);
+        else if (identifier.type == nodeididentifiertypes::Identifier_Guid)
+            writeString(out, identifier.idGuid.toString());
+        else
+            writeString(out, string(reinterpret_cast<const char*>(identifier.idOpaque.data()),
+                                    identifier.idOpaque.length()));
+
+        writeUInt32(out,   uint32_t(nodeId.hasNameSpaceUri())
+                        | (uint32_t(nodeId.hasNameSpaceIndex()) << 1));
+        writeString(out, nodeId.nameSpaceUri());
+        writeUInt32(out, uint32_t(nodeId.nameSpaceIndex()));
+    }
+
+
+    // Read a NodeId from a file
+    // =============================================================================================
+    static bool readNodeId(std::istream& in, NodeId& nodeId)
+    {
+        uint32_t type, flags, nameSpaceIndex;
+        string nameSpaceUri;
+        NodeIdIdentifier identifier;
+
+        if (!readUInt32(in, type))
+            return false;
+
+        if (type == nodeididentifiertypes::Identifier_Numeric)
+        {
+            uint32_t idNumeric;
+            if (!readUInt32(in, idNumeric))
+                return false;
+            identifier = NodeIdIdentifier(idNumeric);
+        }
+        else if (type <= nodeididentifiertypes::Identifier_Opaque)
+        {
+            string s;
+            if (!readString(in, s))
+                return false;
+
+            if (type == nodeididentifiertypes::Identifier_String)
+                identifier = NodeIdIdentifier(s);
+            else if (type == nodeididentifiertypes::Identifier_Guid)
+                identifier = NodeIdIdentifier(Guid(s));
+            else
+                identifier = NodeIdIdentifier(ByteString(
+                        int32_t(s.size()),
+                        reinterpret_cast<uint8_t*>(s.empty() ? 0 : &s[0])));
+        }
+        else
+        {
+            return false;
+        }
+
+        if (   !readUInt32(in, flags)
+            || !readString(in, nameSpaceUri)
+            || !readUInt32(in, nameSpaceIndex))
+            return false;
+
+        bool hasUri   = (flags & 1) != 0;
+        bool hasIndex = (flags & 2) != 0;
+
+        if (hasUri && hasIndex)
+            nodeId = NodeId(identifier, nameSpaceUri, NameSpaceIndex(nameSpaceIndex));
+        else if (hasUri)
+            nodeId = NodeId(identifier, nameSpaceUri);
+        else if (hasIndex)
+            nodeId = NodeId(identifier, NameSpaceIndex(nameSpaceIndex));
+        else
+            nodeId = NodeId(identifier, string());
+
+        return true;
+    }
+
+
+    // Write an ExpandedNodeId to a file
+    // =============================================================================================
+    static void writeExpandedNodeId(std::ostream& out, const ExpandedNodeId& expandedNodeId)
+    {
+        writeNodeId(out, expandedNodeId.nodeId());
+        writeUInt32(out,   uint32_t(expandedNodeId.hasServerUri())
+                        | (uint32_t(expandedNodeId.hasServerIndex()) << 1));
+        writeString(out, expandedNodeId.serverUri());
+        writeUInt32(out, uint32_t(expandedNodeId.serverIndex()));
+    }
+
+
+    // Read an ExpandedNodeId from a file
+    // =============================================================================================
+    static bool readExpandedNodeId(std::istream& in, ExpandedNodeId& expandedNodeId)
+    {
+        NodeId nodeId;
+        uint32_t flags, serverIndex;
+        string serverUri;
+
+        if (   !readNodeId(in, nodeId)
+            || !readUInt32(in, flags)
+            || !readString(in, serverUri)
+            || !readUInt32(in, serverIndex))
+            return false;
+
+        if ((flags & 1) && (flags & 2))
+            expandedNodeId = ExpandedNodeId(nodeId, serverUri, ServerIndex(serverIndex));
+        else if (flags & 2)
+            expandedNodeId = ExpandedNodeId(nodeId, ServerIndex(serverIndex));
+        else
+            expandedNodeId = ExpandedNodeId(nodeId, serverUri);
+
+        return true;
+    }
+
+
+    // Write an Address to a file
+    // =============================================================================================
+    static void writeAddress(std::ostream& out, const Address& address)
+    {
+        if (address.isRelativePath() && address.getStartingAddress() != 0)
+        {
+            vector<RelativePathElement> relativePath = address.getRelativePath();
+
+            writeUInt32(out, 1);
+            writeAddress(out, *address.getStartingAddress());
+            writeUInt32(out, uint32_t(relativePath.size()));
+
+            for (vector<RelativePathElement>::const_iterator it = relativePath.begin();
+                 it != relativePath.end();
+                 ++it)
+            {
+                writeString(out, it->targetName.name());
+                writeUInt32(out,   uint32_t(it->targetName.hasNameSpaceUri())
+                                | (uint32_t(it->targetName.hasNameSpaceIndex()) << 1));
+                writeString(out, it->targetName.nameSpaceUri());
+                writeUInt32(out, uint32_t(it->targetName.nameSpaceIndex()));
+                writeNodeId(out, it->referenceType);
+                writeUInt32(out, uint32_t(it->isInverse) | (uint32_t(it->includeSubtypes) << 1));
+            }
+        }
+        else
+        {
+            writeUInt32(out, 0);
+            writeExpandedNodeId(out, address.getExpandedNodeId());
+        }
+    }
+
+
+    // Read an Address from a file
+    // =============================================================================================
+    static bool readAddress(std::istream& in, Address& address, int depth = 0)
+    {
+        uint32_t kind;
+
+        if (depth > MAX_PATH_DEPTH || !readUInt32(in, kind))
+            return false;
+
+        if (kind == 0)
+        {
+            ExpandedNodeId expandedNodeId;
+            if (!readExpandedNodeId(in, expandedNodeId))
+                return false;
+            address = Address(expandedNodeId);
+            return true;
+        }
+        else if (kind == 1)
+        {
+            Address startingAddress;
+            uint32_t noOfElements;
+
+            if (!readAddress(in, startingAddress, depth + 1) || !readUInt32(in, noOfElements))
+                return false;
+
+            vector<RelativePathElement> relativePath;
+
+            for (uint32_t i = 0; i < noOfElements; i++)
+            {
+                string name, nameSpaceUri;
+                uint32_t nameFlags, nameSpaceIndex, elementFlags;
+                RelativePathElement element;
+
+                if (   !readString(in, name)
+                    || !readUInt32(in, nameFlags)
+                    || !readString(in, nameSpaceUri)
+                    || !readUInt32(in, nameSpaceIndex)
+                    || !readNodeId(in, element.referenceType)
+                    || !readUInt32(in, elementFlags))
+                    return false;
+
+                element.targetName = QualifiedName(name);
+                if (nameFlags & 1)
+                    element.targetName.setNameSpaceUri(nameSpaceUri);
+                if (nameFlags & 2)
+                    element.targetName.setNameSpaceIndex(uint16_t(nameSpaceIndex));
+                element.isInverse       = (elementFlags & 1) != 0;
+                element.includeSubtypes = (elementFlags & 2) != 0;
+
+                relativePath.push_back(element);
+            }
+
+            // the starting address is copied by the constructor
+            address = Address(&startingAddress, relativePath);
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+
     // Constructor
     // =============================================================================================
     AddressCache::AddressCache(LoggerFactory* loggerFactory)
@@ -54,15 +331,37 @@ namespace uaf
     }
 
 
+    // Find an address in the cache
+    // =============================================================================================
+    AddressCache::Cache::iterator AddressCache::findEntry(
+            Cache&          cache,
+            uint32_t        hash,
+            const Address&  address)
+    {
+        std::pair<Cache::iterator, Cache::iterator> range = cache.equal_range(hash);
+
+        for (Cache::iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second.address == address)
+                return it;
+        }
+
+        return cache.end();
+    }
+
+
     // Remove all items from the cache
     // =============================================================================================
     void AddressCache::clear()
     {
         logger_->info("Clearing the address cache");
 
-        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
-
-        cache_.clear();
+        for (uint32_t i = 0; i < NO_OF_SHARDS; i++)
+        {
+            UaMutexLocker locker(&shards_[i].mutex); // unlocks when locker goes out of scope
+            shards_[i].cache.clear();
+            shards_[i].failures.clear();
+        }
     }
 
 
@@ -72,21 +371,23 @@ namespace uaf
     {
         logger_->info("Clearing the cached addresses for ServerUri '%s':", serverUri.c_str());
 
-        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
-
-        Cache::iterator it = cache_.begin();
-        while(it != cache_.end())
+        for (uint32_t i = 0; i < NO_OF_SHARDS; i++)
         {
-            if (it->second.serverUri() == serverUri)
-            {
-                logger_->debug("Removing the address from the cache");
-                cache_.erase(it++);  // The post increment increments the iterator but returns the
-                                     // original value for use by erase
-            }
-            else
+            UaMutexLocker locker(&shards_[i].mutex); // unlocks when locker goes out of scope
+
+            Cache& cache = shards_[i].cache;
+
+            Cache::iterator it = cache.begin();
+            while(it != cache.end())
             {
-                ++it; // Can use pre-increment here to make sure you have the efficient version
+                if (it->second.expandedNodeId.serverUri() == serverUri)
+                    cache.erase(it++);  // The post increment increments the iterator but returns
+                                        // the original value for use by erase
+                else
+                    ++it;
             }
+
+            clearFailures(shards_[i].failures, serverUri);
         }
 
         logger_->debug("All cached addresses for ServerUri '%s' have been cleared",
@@ -102,20 +403,31 @@ namespace uaf
             const ExpandedNodeId&   expandedNodeId,
             bool                    replaceIfExists)
     {
+        uint32_t addressHash = address.hash();
+        Shard& shard = shards_[addressHash & (NO_OF_SHARDS - 1)];
 
-        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+        UaMutexLocker locker(&shard.mutex); // unlocks when locker goes out of scope
 
-        Cache::iterator iter = cache_.find(address);
+        Cache::iterator iter = findEntry(shard.cache, addressHash, address);
 
-        if (iter == cache_.end() || replaceIfExists)
-        {
-            logger_->info("The address is now cached");
+        // the address is not a failure anymore
+        Failures::iterator failureIter = findFailure(shard.failures, addressHash, address);
+        if (failureIter != shard.failures.end())
+            shard.failures.erase(failureIter);
 
-            cache_[address] = expandedNodeId;
+        if (iter == shard.cache.end())
+        {
+            logger_->debug("The address is now cached");
+            shard.cache.insert(Cache::value_type(addressHash, Entry(address, expandedNodeId)));
+        }
+        else if (replaceIfExists)
+        {
+            logger_->debug("The address is now cached (replacing the previous entry)");
+            iter->second.expandedNodeId = expandedNodeId;
         }
         else
         {
-            logger_->info("The address was already cached and we mustn't replace it");
+            logger_->debug("The address was already cached and we mustn't replace it");
         }
     }
 
@@ -143,32 +455,713 @@ namespace uaf
     // =============================================================================================
     bool AddressCache::find(const Address& address, uaf::ExpandedNodeId& expandedNodeId)
     {
-        logger_->debug("Trying to find the following address in the cache (size=%d)", cache_.size());
-        logger_->debug(address.toString());
+        UAF_LOG_DEBUG(logger_, ("Trying to find the following address in the cache"));
+        UAF_LOG_DEBUG(logger_, (address.toString()));
+
+        uint32_t addressHash = address.hash();
+        Shard& shard = shards_[addressHash & (NO_OF_SHARDS - 1)];
 
-        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+        UaMutexLocker locker(&shard.mutex); // unlocks when locker goes out of scope
 
-        Cache::const_iterator iter = cache_.find(address);
+        Cache::iterator iter = findEntry(shard.cache, addressHash, address);
 
-        bool found = (iter != cache_.end());
+        bool found = (iter != shard.cache.end());
 
         if (found)
         {
-            expandedNodeId = iter->second;
-            logger_->info("The address was found in the cache");
-            logger_->info("It corresponds to %s", expandedNodeId.toString().c_str());
+            expandedNodeId = iter->second.expandedNodeId;
+            UAF_LOG_DEBUG(logger_, ("The address was found in the cache"));
+            UAF_LOG_DEBUG(logger_, ("It corresponds to %s", expandedNodeId.toString().c_str()));
         }
         else
         {
-            logger_->info("The address was not found in the cache");
+            UAF_LOG_DEBUG(logger_, ("The address was not found in the cache"));
         }
 
         return found;
     }
 
 
+    // Find the resolved ExpandedNodeIds for a number of addresses
+    // =============================================================================================
+    size_t AddressCache::find(
+            const vector<Address>&  addresses,
+            vector<ExpandedNodeId>& expandedNodeIds,
+            Mask&                   found)
+    {
+        size_t noOfAddresses = addresses.size();
+        size_t noOfFound     = 0;
 
+        expandedNodeIds.resize(noOfAddresses);
+        found = Mask(noOfAddresses, false);
 
-}
+        // compute the hashes, and sort the addresses per shard
+        vector<uint32_t> hashes(noOfAddresses);
+        vector<size_t>   shardIndexes[NO_OF_SHARDS];
+
+        for (size_t i = 0; i < noOfAddresses; i++)
+        {
+            hashes[i] = addresses[i].hash();
+            shardIndexes[hashes[i] & (NO_OF_SHARDS - 1)].push_back(i);
+        }
+
+        // look up the addresses, locking each shard only once
+        for (uint32_t s = 0; s < NO_OF_SHARDS; s++)
+        {
+            if (shardIndexes[s].empty())
+                continue;
+
+            UaMutexLocker locker(&shards_[s].mutex); // unlocks when locker goes out of scope
+
+            Cache& cache = shards_[s].cache;
+
+            for (vector<size_t>::const_iterator it = shardIndexes[s].begin();
+                 it != shardIndexes[s].end();
+                 ++it)
+            {
+                Cache::iterator iter = findEntry(cache, hashes[*it], addresses[*it]);
+
+                if (iter != cache.end())
+                {
+                    expandedNodeIds[*it] = iter->second.expandedNodeId;
+                    found.set(*it);
+                    noOfFound++;
+                }
+            }
+        }
+
+        UAF_LOG_DEBUG(logger_, ("%d of the %d addresses were found in the cache",
+                                noOfFound, noOfAddresses));
+
+        return noOfFound;
+    }
+
+
+    // Find a failure in the cache
+    // =============================================================================================
+    AddressCache::Failures::iterator AddressCache::findFailure(
+            Failures&       failures,
+            uint32_t        hash,
+            const Address&  address)
+    {
+        std::pair<Failures::iterator, Failures::iterator> range = failures.equal_range(hash);
+
+        for (Failures::iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second.address == address)
+                return it;
+        }
+
+        return failures.end();
+    }
+
+
+    // Remove the failures of a server
+    // =============================================================================================
+    void AddressCache::clearFailures(Failures& failures, const string& serverUri)
+    {
+        Failures::iterator it = failures.begin();
+        while (it != failures.end())
+        {
+            if (it->second.serverUri == serverUri)
+                failures.erase(it++);
+            else
+                ++it;
+        }
+    }
+
+
+    // Remove the forgotten failures of a shard
+    // =============================================================================================
+    void AddressCache::pruneFailuresIfNeeded(Shard& shard, const DateTime& now)
+    {
+        // pruning takes linear time, so only do it when the number of failures has doubled
+        if (shard.failures.size() < 2 * std::max(shard.noOfFailuresAfterPruning, size_t(16)))
+            return;
+
+        Failures::iterator it = shard.failures.begin();
+        while (it != shard.failures.end())
+        {
+            if (now.msecsTo(it->second.forgetTime) <= 0)
+                shard.failures.erase(it++);
+            else
+                ++it;
+        }
+
+        shard.noOfFailuresAfterPruning = shard.failures.size();
+    }
+
+
+    // Get the server URI of the (starting) ExpandedNodeId of an address
+    // =============================================================================================
+    string AddressCache::serverUriOf(const Address& address)
+    {
+        const Address* link = &address;
+
+        while (link != 0 && link->isRelativePath())
+            link = link->getStartingAddress();
+
+        if (link != 0 && link->isExpandedNodeId())
+            return link->getExpandedNodeId().serverUri();
+        else
+            return string();
+    }
+
+
+    // Check if a resolution status is a failure that can be cached
+    // =============================================================================================
+    bool AddressCache::isCacheableFailure(const Status& status)
+    {
+        return    status.statusCode == statuscodes::ServerCouldNotTranslateBrowsePathsToNodeIdsError
+               || status.statusCode == statuscodes::MultipleTranslationResultsError;
+    }
+
+
+    // Add an address that could not be resolved
+    // =============================================================================================
+    void AddressCache::addFailure(
+            const Address&  address,
+            const Status&   status,
+            double          ttlSec,
+            double          maxTtlSec)
+    {
+        uint32_t addressHash = address.hash();
+        Shard& shard = shards_[addressHash & (NO_OF_SHARDS - 1)];
+
+        UaMutexLocker locker(&shard.mutex); // unlocks when locker goes out of scope
+
+        Failures::iterator iter = findFailure(shard.failures, addressHash, address);
+
+        if (iter == shard.failures.end())
+            iter = shard.failures.insert(Failures::value_type(
+                    addressHash,
+                    Failure(address, serverUriOf(address))));
+
+        Failure& failure = iter->second;
 
+        // back off exponentially for addresses that keep failing
+        double failureTtlSec = ttlSec;
+        for (uint32_t i = 0; i < failure.count && failureTtlSec < maxTtlSec; i++)
+            failureTtlSec *= 2.0;
+        if (failureTtlSec > maxTtlSec)
+            failureTtlSec = maxTtlSec;
 
+        failure.count++;
+        failure.status     = status;
+        failure.expiryTime = DateTime::now();
+        failure.expiryTime.addMilliSecs(int(failureTtlSec * 1000.0));
+
+        // once expired, remember the failure for a while to back off if it fails again
+        failure.forgetTime = failure.expiryTime;
+        failure.forgetTime.addMilliSecs(int(maxTtlSec * 1000.0));
+
+        logger_->debug("The address failed %d times, so the failure is now cached for %.1fs",
+                       failure.count, failureTtlSec);
+    }
+
+
+    // Find the cached failures of a number of addresses
+    // =============================================================================================
+    size_t AddressCache::findFailures(
+            const vector<Address>&  addresses,
+            const Mask&             mask,
+            vector<Status>&         statuses,
+            Mask&                   found)
+    {
+        size_t noOfAddresses = addresses.size();
+        size_t noOfFound     = 0;
+
+        found = Mask(noOfAddresses, false);
+
+        DateTime now = DateTime::now();
+
+        for (size_t i = 0; i < noOfAddresses; i++)
+        {
+            if (!mask.isSet(i))
+                continue;
+
+            uint32_t addressHash = addresses[i].hash();
+            Shard& shard = shards_[addressHash & (NO_OF_SHARDS - 1)];
+
+            UaMutexLocker locker(&shard.mutex); // unlocks when locker goes out of scope
+
+            Failures::iterator iter = findFailure(shard.failures, addressHash, addresses[i]);
+
+            // expired failures are kept for a while (to remember how often they failed), but
+            // are ignored
+            if (iter != shard.failures.end())
+            {
+                if (now.msecsTo(iter->second.expiryTime) > 0)
+                {
+                    statuses[i] = iter->second.status;
+                    found.set(i);
+                    noOfFound++;
+                }
+                else if (now.msecsTo(iter->second.forgetTime) <= 0)
+                {
+                    shard.failures.erase(iter);
+                }
+            }
+
+            pruneFailuresIfNeeded(shard, now);
+        }
+
+        UAF_LOG_DEBUG(logger_, ("%d cached failures were found", noOfFound));
+
+        return noOfFound;
+    }
+
+
+    // Update the NamespaceArray of a server
+    // =============================================================================================
+    void AddressCache::updateNamespaceArray(
+            const string&           serverUri,
+            const NamespaceArray&   namespaceArray)
+    {
+        uint64_t fingerprint = namespaceArray.fingerprint();
+
+        UaMutexLocker locker(&serversMutex_); // unlocks when locker goes out of scope
+
+        namespaceArrays_[serverUri] = namespaceArray;
+
+        map<string, uint64_t>::iterator iter = fingerprints_.find(serverUri);
+
+        if (iter != fingerprints_.end() && iter->second != fingerprint)
+        {
+            logger_->warning("The NamespaceArray of ServerUri '%s' has changed, so its cached "
+                             "addresses are invalid", serverUri.c_str());
+            clear(serverUri);
+        }
+
+        fingerprints_[serverUri] = fingerprint;
+    }
+
+
+    // Get a NodeId with the namespace URI instead of the namespace index, if possible
+    // =============================================================================================
+    NodeId AddressCache::normalize(const NodeId& nodeId, const NamespaceArray* namespaceArray)
+    {
+        string nameSpaceUri;
+
+        if (nodeId.hasNameSpaceUri())
+            return NodeId(nodeId.identifier(), nodeId.nameSpaceUri());
+        else if (namespaceArray != 0
+                && namespaceArray->findNamespaceUri(nodeId.nameSpaceIndex(), nameSpaceUri))
+            return NodeId(nodeId.identifier(), nameSpaceUri);
+        else
+            return NodeId(nodeId.identifier(), nodeId.nameSpaceIndex());
+    }
+
+
+    // Remove the cached addresses that resolve to, or are browsed from, the given nodes
+    // =============================================================================================
+    void AddressCache::invalidate(const string& serverUri, const vector<NodeId>& affectedNodeIds)
+    {
+        logger_->debug("Invalidating the cached addresses of %d changed nodes of ServerUri '%s'",
+                       affectedNodeIds.size(), serverUri.c_str());
+
+        UaMutexLocker locker(&serversMutex_); // unlocks when locker goes out of scope
+
+        map<string, NamespaceArray>::const_iterator arrayIter = namespaceArrays_.find(serverUri);
+        const NamespaceArray* namespaceArray = 0;
+        if (arrayIter != namespaceArrays_.end())
+            namespaceArray = &arrayIter->second;
+
+        std::set<NodeId> affected;
+        for (vector<NodeId>::const_iterator it = affectedNodeIds.begin();
+             it != affectedNodeIds.end();
+             ++it)
+            affected.insert(normalize(*it, namespaceArray));
+
+        // 1) find the cached addresses that resolve to an affected node
+        vector<uint32_t> affectedHashes;
+        vector<Address>  affectedAddresses;
+
+        for (uint32_t i = 0; i < NO_OF_SHARDS; i++)
+        {
+            UaMutexLocker shardLocker(&shards_[i].mutex); // unlocks when locker goes out of scope
+
+            for (Cache::const_iterator it = shards_[i].cache.begin();
+                 it != shards_[i].cache.end();
+                 ++it)
+            {
+                if (   it->second.expandedNodeId.serverUri() == serverUri
+                    && affected.count(normalize(it->second.expandedNodeId.nodeId(),
+                                                namespaceArray)))
+                {
+                    affectedHashes.push_back(it->first);
+                    affectedAddresses.push_back(it->second.address);
+                }
+            }
+        }
+
+        // 2) remove them, together with the cached addresses that are browsed from an affected
+        //    node or from one of the addresses of 1)
+        size_t noOfRemoved = 0;
+
+        for (uint32_t i = 0; i < NO_OF_SHARDS; i++)
+        {
+            UaMutexLocker shardLocker(&shards_[i].mutex); // unlocks when locker goes out of scope
+
+            Cache& cache = shards_[i].cache;
+
+            // the changes may also have fixed the addresses that could not be resolved
+            clearFailures(shards_[i].failures, serverUri);
+
+            Cache::iterator it = cache.begin();
+            while (it != cache.end())
+            {
+                bool remove = false;
+
+                if (it->second.expandedNodeId.serverUri() == serverUri)
+                {
+                    // walk along the starting addresses, starting with the address itself
+                    const Address* link = &it->second.address;
+
+                    while (link != 0 && !remove)
+                    {
+                        if (link->isExpandedNodeId())
+                        {
+                            ExpandedNodeId expandedNodeId = link->getExpandedNodeId();
+                            remove = affected.count(normalize(expandedNodeId.nodeId(),
+                                                              namespaceArray)) > 0;
+                            link = 0;
+                        }
+                        else if (link->getRelativePath().size() > 1)
+                        {
+                            // the intermediate nodes of the path are not known, so it may pass
+                            // through one of the affected nodes
+                            remove = true;
+                        }
+                        else
+                        {
+                            uint32_t linkHash = link->hash();
+                            for (size_t j = 0; j < affectedAddresses.size() && !remove; j++)
+                                remove = (   affectedHashes[j] == linkHash
+                                          && affectedAddresses[j] == *link);
+                            link = link->getStartingAddress();
+                        }
+                    }
+
+                    // the resolved node itself
+                    if (!remove)
+                        remove = affected.count(normalize(it->second.expandedNodeId.nodeId(),
+                                                          namespaceArray)) > 0;
+                }
+
+                if (remove)
+                {
+                    cache.erase(it++);  // The post increment increments the iterator but returns
+                                        // the original value for use by erase
+                    noOfRemoved++;
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        logger_->debug("%d cached addresses of ServerUri '%s' have been invalidated",
+                       noOfRemoved, serverUri.c_str());
+    }
+
+
+    // Register a monitored item that receives model change events
+    // =============================================================================================
+    void AddressCache::addModelChangeMonitoredItem(
+            ClientHandle    clientHandle,
+            const string&   serverUri)
+    {
+        UaMutexLocker locker(&serversMutex_); // unlocks when locker goes out of scope
+        modelChangeMonitoredItems_[clientHandle] = serverUri;
+    }
+
+
+    // Unregister a monitored item that receives model change events
+    // =============================================================================================
+    void AddressCache::removeModelChangeMonitoredItem(ClientHandle clientHandle)
+    {
+        UaMutexLocker locker(&serversMutex_); // unlocks when locker goes out of scope
+        modelChangeMonitoredItems_.erase(clientHandle);
+    }
+
+
+    // Check if the model change events of a server are monitored
+    // =============================================================================================
+    bool AddressCache::hasModelChangeMonitoredItem(const string& serverUri)
+    {
+        UaMutexLocker locker(&serversMutex_); // unlocks when locker goes out of scope
+
+        for (map<ClientHandle, string>::const_iterator it = modelChangeMonitoredItems_.begin();
+             it != modelChangeMonitoredItems_.end();
+             ++it)
+        {
+            if (it->second == serverUri)
+                return true;
+        }
+
+        return false;
+    }
+
+
+    // Find the server of a monitored item that receives model change events
+    // =============================================================================================
+    bool AddressCache::findModelChangeMonitoredItem(
+            ClientHandle    clientHandle,
+            string&         serverUri)
+    {
+        UaMutexLocker locker(&serversMutex_); // unlocks when locker goes out of scope
+
+        map<ClientHandle, string>::const_iterator it
+            = modelChangeMonitoredItems_.find(clientHandle);
+        if (it == modelChangeMonitoredItems_.end())
+            return false;
+
+        serverUri = it->second;
+        return true;
+    }
+
+
+    // Process a model change event
+    // =============================================================================================
+    void AddressCache::processModelChangeEvent(
+            const string&           serverUri,
+            const vector<Variant>&  fields)
+    {
+        NodeId eventType;
+        if (fields.size() < 2 || fields[0].toNodeId(eventType).isNotGood())
+            return;
+
+        if (eventType == NodeId(OpcUaId_GeneralModelChangeEventType, 0))
+        {
+            vector<ExtensionObject> changes;
+
+            if (fields[1].toExtensionObjectArray(changes).isGood())
+            {
+                vector<NodeId> affectedNodeIds;
+                affectedNodeIds.reserve(changes.size());
+
+                for (vector<ExtensionObject>::const_iterator it = changes.begin();
+                     it != changes.end();
+                     ++it)
+                    affectedNodeIds.push_back(ModelChangeStructureDataType(*it).affected);
+
+                invalidate(serverUri, affectedNodeIds);
+            }
+            else
+            {
+                // we don't know which nodes were changed
+                clear(serverUri);
+            }
+        }
+        else if (eventType == NodeId(OpcUaId_BaseModelChangeEventType, 0))
+        {
+            clear(serverUri);
+        }
+    }
+
+
+    // Get the event filter of the monitored items that receive model change events
+    // =============================================================================================
+    EventFilter AddressCache::modelChangeEventFilter()
+    {
+        EventFilter eventFilter;
+        eventFilter.selectClauses.resize(2);
+
+        // 1) the EventType of any event
+        eventFilter.selectClauses[0].typeId = NodeId(OpcUaId_BaseEventType, 0);
+        eventFilter.selectClauses[0].browsePath.push_back(QualifiedName("EventType", 0));
+
+        // 2) the Changes of a GeneralModelChangeEvent
+        eventFilter.selectClauses[1].typeId = NodeId(OpcUaId_GeneralModelChangeEventType, 0);
+        eventFilter.selectClauses[1].browsePath.push_back(QualifiedName("Changes", 0));
+
+        return eventFilter;
+    }
+
+
+    // Save the cache to a file
+    // =============================================================================================
+    bool AddressCache::save(const string& fileName)
+    {
+        logger_->debug("Saving the address cache to '%s'", fileName.c_str());
+
+        // only the addresses of servers with a known NamespaceArray can be saved
+        map<string, uint64_t> fingerprints;
+        {
+            UaMutexLocker locker(&serversMutex_); // unlocks when locker goes out of scope
+            fingerprints = fingerprints_;
+        }
+
+        map<string, vector<Entry> > entries;
+
+        for (uint32_t i = 0; i < NO_OF_SHARDS; i++)
+        {
+            UaMutexLocker locker(&shards_[i].mutex); // unlocks when locker goes out of scope
+
+            for (Cache::const_iterator it = shards_[i].cache.begin();
+                 it != shards_[i].cache.end();
+                 ++it)
+            {
+                const string& serverUri = it->second.expandedNodeId.serverUri();
+                if (fingerprints.find(serverUri) != fingerprints.end())
+                    entries[serverUri].push_back(it->second);
+            }
+        }
+
+        // write to a temporary file first, so an existing file is never left half-written
+        string tempFileName = fileName + ".tmp";
+        size_t noOfEntries = 0;
+        bool   written;
+        {
+            std::ofstream out(tempFileName.c_str(),
+                              std::ios::out | std::ios::binary | std::ios::trunc);
+
+            writeUInt32(out, FILE_MAGIC);
+            writeUInt32(out, FILE_VERSION);
+            writeUInt32(out, uint32_t(entries.size()));
+
+            for (map<string, vector<Entry> >::const_iterator it = entries.begin();
+                 it != entries.end();
+                 ++it)
+            {
+                uint64_t fingerprint = fingerprints[it->first];
+
+                writeString(out, it->first);
+                writeUInt32(out, uint32_t(fingerprint & 0xFFFFFFFFu));
+                writeUInt32(out, uint32_t(fingerprint >> 32));
+                writeUInt32(out, uint32_t(it->second.size()));
+
+                for (vector<Entry>::const_iterator entry = it->second.begin();
+                     entry != it->second.end();
+                     ++entry)
+                {
+                    writeAddress(out, entry->address);
+                    writeExpandedNodeId(out, entry->expandedNodeId);
+                }
+
+                noOfEntries += it->second.size();
+            }
+
+            out.flush();
+            written = out.good();
+        }
+
+        // on POSIX, std::rename replaces an existing file atomically
+        bool renamed = written && std::rename(tempFileName.c_str(), fileName.c_str()) == 0;
+
+#ifdef _WIN32
+        // on Windows, std::rename fails if the file exists already, so it must be removed first
+        if (written && !renamed)
+        {
+            std::remove(fileName.c_str());
+            renamed = std::rename(tempFileName.c_str(), fileName.c_str()) == 0;
+        }
+#endif
+
+        if (!renamed)
+        {
+            logger_->warning("The address cache could not be saved to '%s'", fileName.c_str());
+            std::remove(tempFileName.c_str());
+            return false;
+        }
+
+        logger_->info("%d cached addresses of %d servers have been saved to '%s'",
+                      noOfEntries, entries.size(), fileName.c_str());
+        return true;
+    }
+
+
+    // Load the cache from a file
+    // =============================================================================================
+    size_t AddressCache::load(const string& fileName)
+    {
+        logger_->debug("Loading the address cache from '%s'", fileName.c_str());
+
+        std::ifstream in(fileName.c_str(), std::ios::in | std::ios::binary);
+
+        if (!in)
+        {
+            logger_->info("No address cache could be loaded from '%s'", fileName.c_str());
+            return 0;
+        }
+
+        uint32_t magic, version, noOfServers;
+
+        if (   !readUInt32(in, magic)
+            || !readUInt32(in, version)
+            || !readUInt32(in, noOfServers)
+            || magic != FILE_MAGIC
+            || version != FILE_VERSION)
+        {
+            logger_->warning("'%s' is not a valid address cache file", fileName.c_str());
+            return 0;
+        }
+
+        size_t noOfLoaded = 0;
+        bool   valid      = true;
+
+        for (uint32_t i = 0; i < noOfServers && valid; i++)
+        {
+            string serverUri;
+            uint32_t fingerprintLow, fingerprintHigh, noOfEntries;
+
+            valid =    readString(in, serverUri)
+                    && readUInt32(in, fingerprintLow)
+                    && readUInt32(in, fingerprintHigh)
+                    && readUInt32(in, noOfEntries);
+
+            vector<Address>        addresses;
+            vector<ExpandedNodeId> expandedNodeIds;
+
+            for (uint32_t j = 0; j < noOfEntries && valid; j++)
+            {
+                Address        address;
+                ExpandedNodeId expandedNodeId;
+
+                valid = readAddress(in, address) && readExpandedNodeId(in, expandedNodeId);
+
+                if (valid)
+                {
+                    addresses.push_back(address);
+                    expandedNodeIds.push_back(expandedNodeId);
+                }
+            }
+
+            if (!valid)
+                break;
+
+            uint64_t fingerprint = (uint64_t(fingerprintHigh) << 32) | fingerprintLow;
+
+            UaMutexLocker locker(&serversMutex_); // unlocks when locker goes out of scope
+
+            // the entries are used right away, and are removed again when the server (once
+            // connected) turns out to have a different NamespaceArray
+            map<string, uint64_t>::iterator iter = fingerprints_.find(serverUri);
+
+            if (iter == fingerprints_.end())
+                fingerprints_[serverUri] = fingerprint;
+            else if (iter->second != fingerprint)
+            {
+                logger_->info("Ignoring the saved addresses of ServerUri '%s' (its "
+                              "NamespaceArray has changed)", serverUri.c_str());
+                continue;
+            }
+
+            add(addresses, expandedNodeIds, false);
+            noOfLoaded += addresses.size();
+        }
+
+        if (!valid)
+            logger_->warning("The address cache file '%s' is corrupt, only %d addresses were "
+                             "loaded", fileName.c_str(), noOfLoaded);
+        else
+            logger_->info("%d cached addresses have been loaded from '%s'",
+                          noOfLoaded, fileName.c_str());
+
+        return noOfLoaded;
+    }
+
+
+}
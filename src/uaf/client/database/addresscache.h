@@ -33,6 +33,12 @@
 #include "uaf/util/status.h"
 #include "uaf/util/logger.h"
 #include "uaf/util/address.h"
+#include "uaf/util/mask.h"
+#include "uaf/util/handles.h"
+#include "uaf/util/variant.h"
+#include "uaf/util/namespacearray.h"
+#include "uaf/util/eventfilter.h"
+#include "uaf/util/datetime.h"
 #include "uaf/client/clientexport.h"
 
 
@@ -44,6 +50,25 @@ namespace uaf
     * A uaf::AddressCache can speed up address resolution by storing the ExpandedNodeId for each
     * Address.
     *
+    * The addresses are hashed, and spread over a number of shards that each have their own
+    * mutex, so that many threads can use the cache at the same time without waiting for each
+    * other. Within a shard, only the addresses with the same hash need to be compared.
+    *
+    * The cache can be saved to a file and loaded again (see ClientSettings::addressCacheFile),
+    * so that a restarted client doesn't need to resolve all of its addresses again. The cached
+    * addresses of a server are stored together with the fingerprint of the NamespaceArray of
+    * the server, and they are removed as soon as the server turns out to have a different
+    * NamespaceArray.
+    *
+    * If the client monitors the GeneralModelChangeEvents of a server (see
+    * ClientSettings::addressCacheModelChangeEventsEnable), only the cached addresses that resolve
+    * to, or are browsed from, the nodes that were changed are removed.
+    *
+    * Addresses that could not be resolved by the server can also be cached, for a limited time
+    * that is doubled each time the address fails again (see
+    * ClientSettings::resolutionFailureTtlSec), so that they don't need to be translated over
+    * and over again.
+    *
     * @ingroup ClientDatabase
     ***********************************************************************************************/
     class UAF_EXPORT AddressCache
@@ -113,6 +138,189 @@ namespace uaf
         bool find(const uaf::Address& address, uaf::ExpandedNodeId& expandedNodeId);
 
 
+        /**
+         * Find the resolved expanded node ids of a number of addresses in the cache.
+         *
+         * The mutex of each shard is locked only once for all addresses.
+         *
+         * @param addresses         The addresses to look up.
+         * @param expandedNodeIds   The found expandedNodeIds (resized to the number of addresses,
+         *                          only the found ones are updated).
+         * @param found             The mask indicating which addresses were found (resized to
+         *                          the number of addresses).
+         * @return                  The number of addresses that were found.
+         */
+        std::size_t find(
+                const std::vector<uaf::Address>&    addresses,
+                std::vector<uaf::ExpandedNodeId>&   expandedNodeIds,
+                uaf::Mask&                          found);
+
+
+        /**
+         * Add an address that could not be resolved.
+         *
+         * The failure is cached for ttlSec seconds the first time, and twice as long each time
+         * the address fails again after the failure has expired (but never longer than
+         * maxTtlSec seconds). Adding the resolved ExpandedNodeId of the address removes the
+         * failure.
+         *
+         * @param address   The address that could not be resolved.
+         * @param status    The resolution status.
+         * @param ttlSec    The time (in seconds) to cache the first failure.
+         * @param maxTtlSec The maximum time (in seconds) to cache a failure.
+         */
+        void addFailure(
+                const uaf::Address& address,
+                const uaf::Status&  status,
+                double              ttlSec,
+                double              maxTtlSec);
+
+
+        /**
+         * Find the cached (and not yet expired) failures of a number of addresses.
+         *
+         * Expired failures are kept for another maxTtlSec seconds (see addFailure()), to
+         * remember how often the address failed. After that, they are removed by this function.
+         *
+         * @param addresses The addresses to find.
+         * @param mask      Only the addresses indicated by the mask are looked up.
+         * @param statuses  Output parameter: the statuses of the failures that were found (the
+         *                  other statuses are left untouched).
+         * @param found     Output parameter: a mask indicating the failures that were found.
+         * @return          The number of failures that were found.
+         */
+        std::size_t findFailures(
+                const std::vector<uaf::Address>&    addresses,
+                const uaf::Mask&                    mask,
+                std::vector<uaf::Status>&           statuses,
+                uaf::Mask&                          found);
+
+
+        /**
+         * Check if a resolution status is a failure of the server that can be cached.
+         *
+         * @param status    The resolution status.
+         * @return          True if the server could not translate the address, or if the
+         *                  address corresponds to multiple nodes.
+         */
+        static bool isCacheableFailure(const uaf::Status& status);
+
+
+        /**
+         * Update the NamespaceArray of a server. If its fingerprint (see
+         * NamespaceArray::fingerprint()) differs from the known one (e.g. the one that was loaded
+         * from a file), all cached addresses of the server are removed.
+         *
+         * @param serverUri         The URI of the server.
+         * @param namespaceArray    The current NamespaceArray of the server.
+         */
+        void updateNamespaceArray(
+                const std::string&          serverUri,
+                const uaf::NamespaceArray&  namespaceArray);
+
+
+        /**
+         * Remove the cached addresses of a server that resolve to one of the given nodes, or
+         * that are browsed from one of them (directly, or via another cached address).
+         *
+         * Since the intermediate nodes of a relative path with more than one element are not
+         * known, the cached addresses that contain such a path are always removed.
+         *
+         * @param serverUri         The URI of the server.
+         * @param affectedNodeIds   The nodes that were changed (the namespace URI or the
+         *                          namespace index of the server may be given).
+         */
+        void invalidate(
+                const std::string&              serverUri,
+                const std::vector<uaf::NodeId>& affectedNodeIds);
+
+
+        /**
+         * Register a monitored item that receives the model change events of a server.
+         *
+         * @param clientHandle  The ClientHandle of the monitored item.
+         * @param serverUri     The URI of the server.
+         */
+        void addModelChangeMonitoredItem(
+                uaf::ClientHandle   clientHandle,
+                const std::string&  serverUri);
+
+
+        /**
+         * Unregister a monitored item that receives the model change events of a server.
+         *
+         * @param clientHandle  The ClientHandle of the monitored item.
+         */
+        void removeModelChangeMonitoredItem(uaf::ClientHandle clientHandle);
+
+
+        /**
+         * Check if the model change events of a server are monitored.
+         *
+         * @param serverUri     The URI of the server.
+         * @return              True if a monitored item has been registered for the server.
+         */
+        bool hasModelChangeMonitoredItem(const std::string& serverUri);
+
+
+        /**
+         * Find the server of a monitored item that receives the model change events.
+         *
+         * @param clientHandle  The ClientHandle of the monitored item.
+         * @param serverUri     Output parameter: the URI of the server, if the monitored item
+         *                      was registered by addModelChangeMonitoredItem().
+         * @return              True if the monitored item was registered by
+         *                      addModelChangeMonitoredItem() (so its events are meant for the
+         *                      cache), false if not.
+         */
+        bool findModelChangeMonitoredItem(
+                uaf::ClientHandle   clientHandle,
+                std::string&        serverUri);
+
+
+        /**
+         * Process a model change event of a server.
+         *
+         * The fields of the event must be the EventType and the Changes (see
+         * modelChangeEventFilter()). A GeneralModelChangeEvent invalidates the cached addresses
+         * of the affected nodes, a BaseModelChangeEvent (which doesn't tell which nodes were
+         * changed) invalidates all cached addresses of the server. Other events are ignored.
+         *
+         * @param serverUri     The URI of the server (see findModelChangeMonitoredItem()).
+         * @param fields        The fields of the event.
+         */
+        void processModelChangeEvent(
+                const std::string&                  serverUri,
+                const std::vector<uaf::Variant>&    fields);
+
+
+        /**
+         * Get the event filter of the monitored items that receive the model change events.
+         *
+         * @return  The event filter, selecting the EventType and the Changes of the events.
+         */
+        static uaf::EventFilter modelChangeEventFilter();
+
+
+        /**
+         * Save the cached addresses of the servers with a known NamespaceArray fingerprint.
+         *
+         * @param fileName  The name of the file to (over)write.
+         * @return          True if the file could be written.
+         */
+        bool save(const std::string& fileName);
+
+
+        /**
+         * Load the cached addresses from a file that was written by save(). Existing entries
+         * are not replaced.
+         *
+         * @param fileName  The name of the file to read.
+         * @return          The number of cached addresses that were loaded.
+         */
+        std::size_t load(const std::string& fileName);
+
+
 
     private:
 
@@ -121,11 +329,94 @@ namespace uaf
         DISALLOW_COPY_AND_ASSIGN(AddressCache);
 
 
-        // private typedefs
+        // private typedefs and constants
+
+
+        /** The number of shards (a power of 2). */
+        static const uint32_t NO_OF_SHARDS = 16;
+
+        /** A cached address and its corresponding ExpandedNodeId. */
+        struct Entry
+        {
+            Entry(const uaf::Address& address, const uaf::ExpandedNodeId& expandedNodeId)
+            : address(address), expandedNodeId(expandedNodeId)
+            {}
+
+            uaf::Address        address;
+            uaf::ExpandedNodeId expandedNodeId;
+        };
+
+        /** A cache stores the entries by the hash of their address. */
+        typedef std::multimap<uint32_t, Entry> Cache;
 
+        /** An address that could not be resolved. */
+        struct Failure
+        {
+            Failure(const uaf::Address& address, const std::string& serverUri)
+            : address(address), serverUri(serverUri), count(0)
+            {}
 
-        /** A cache stores the addresses and their corresponding ExpandedNodeIds. */
-        typedef std::map<uaf::Address, uaf::ExpandedNodeId> Cache;
+            uaf::Address    address;
+            std::string     serverUri;
+            uaf::Status     status;
+            uaf::DateTime   expiryTime;
+            uaf::DateTime   forgetTime;
+            uint32_t        count;
+        };
+
+        /** The failures are also stored by the hash of their address. */
+        typedef std::multimap<uint32_t, Failure> Failures;
+
+        /** A shard holds a part of the cache, and the mutex to safely manipulate it. */
+        struct Shard
+        {
+            Shard() : noOfFailuresAfterPruning(0) {}
+
+            Cache       cache;
+            Failures    failures;
+            std::size_t noOfFailuresAfterPruning;
+            UaMutex     mutex;
+        };
+
+
+        // private methods
+
+
+        /**
+         * Find an address in the cache (the mutex of the shard must be locked).
+         */
+        static Cache::iterator findEntry(Cache& cache, uint32_t hash, const uaf::Address& address);
+
+        /**
+         * Find an address that could not be resolved (the mutex of the shard must be locked).
+         */
+        static Failures::iterator findFailure(
+                Failures&           failures,
+                uint32_t            hash,
+                const uaf::Address& address);
+
+        /**
+         * Remove the failures of a server (the mutex of the shard must be locked).
+         */
+        static void clearFailures(Failures& failures, const std::string& serverUri);
+
+        /**
+         * Remove the failures of a shard that have been forgotten, if the number of failures
+         * has doubled since they were last pruned (the mutex of the shard must be locked).
+         */
+        static void pruneFailuresIfNeeded(Shard& shard, const uaf::DateTime& now);
+
+        /**
+         * Get the server URI of the (starting) ExpandedNodeId of an address.
+         */
+        static std::string serverUriOf(const uaf::Address& address);
+
+        /**
+         * Get a NodeId with the namespace URI instead of the namespace index, if possible.
+         */
+        static uaf::NodeId normalize(
+                const uaf::NodeId&          nodeId,
+                const uaf::NamespaceArray*  namespaceArray);
 
 
         // private members
@@ -134,11 +425,21 @@ namespace uaf
         /** The logger of the address cache. */
         uaf::Logger* logger_;
 
-        /** The map containing the cached addresses. */
-        Cache cache_;
+        /** The shards containing the cached addresses. */
+        Shard shards_[NO_OF_SHARDS];
+
+        /** The fingerprints of the NamespaceArrays of the servers (by server URI). */
+        std::map<std::string, uint64_t> fingerprints_;
+
+        /** The NamespaceArrays of the connected servers (by server URI). */
+        std::map<std::string, uaf::NamespaceArray> namespaceArrays_;
+
+        /** The server URIs of the monitored items that receive model change events. */
+        std::map<uaf::ClientHandle, std::string> modelChangeMonitoredItems_;
 
-        /** The mutex to safely manipulate the map. */
-        UaMutex mutex_;
+        /** The mutex to safely manipulate the information of the servers (to be locked before
+         *  any shard). */
+        UaMutex serversMutex_;
 
     };
 
@@ -32,6 +32,9 @@ namespace uaf
     : createMonitoredDataRequestStore   (loggerFactory, "MonDataReqStore"),
       createMonitoredEventsRequestStore (loggerFactory, "MonEvtsReqStore"),
       addressCache                      (loggerFactory),
+      valueCache                        (loggerFactory),
+      notificationDispatcher            (loggerFactory),
+      latestValueStore                  (loggerFactory),
       clientConnectionId_(0),
       clientSubscriptionHandle_(0),
       clientHandle_(0)
@@ -30,6 +30,9 @@
 #include "uaf/client/clientservices.h"
 #include "uaf/client/database/requeststore.h"
 #include "uaf/client/database/addresscache.h"
+#include "uaf/client/database/valuecache.h"
+#include "uaf/client/database/latestvaluestore.h"
+#include "uaf/client/subscriptions/notificationdispatcher.h"
 #include "uaf/client/settings/clientsettings.h"
 
 
@@ -37,7 +40,8 @@ namespace uaf
 {
 
     /*******************************************************************************************//**
-    * A client database holds notification buffers, an address cache and client settings.
+    * A client database holds notification buffers, an address cache, the notification dispatcher
+    * and client settings.
     *
     * The uaf::Client holds a single instance of this class, and shares its pointer to all
     * sessions, subscriptions and their factories.
@@ -69,6 +73,15 @@ namespace uaf
         /** The cache used by the resolver. */
         uaf::AddressCache addressCache;
 
+        /** The cache of the values that were read (see ClientSettings::valueCacheEnable). */
+        uaf::ValueCache valueCache;
+
+        /** The dispatcher of the notifications (see ClientSettings::notificationDispatchEnable). */
+        uaf::NotificationDispatcher notificationDispatcher;
+
+        /** The latest values of the monitored data items (see ClientSettings::latestValueStoreEnable). */
+        uaf::LatestValueStore latestValueStore;
+
         /** A vector storing all the client handles that were ever assigned. */
         std::vector<uaf::ClientHandle> allClientHandles;
 
@@ -372,6 +385,142 @@ namespace uaf
     }
 
 
+    /**
+     * Template function to "catch" all requests that can't be answered from the value cache.
+     *
+     * Requests that *can* be answered from the value cache, will have a specialized
+     * readFromValueCacheIfNeeded() function.
+     *
+     * @param request   The resolved request.
+     * @param mask      The targets to answer. The targets that were answered from the cache
+     *                  will be unset (never the case for this particular template function).
+     * @param result    The result.
+     * @param database  The database.
+     */
+    template <typename _Service>
+    void UAF_EXPORT readFromValueCacheIfNeeded(
+            const typename _Service::Request&   request,
+            uaf::Mask&                          mask,
+            typename _Service::Result&          result,
+            uaf::Database*                      database)
+    {}
+
+
+    /**
+     * Answer the targets of a resolved uaf::ReadRequest from the value cache, if enabled.
+     *
+     * @param request   The resolved request.
+     * @param mask      The targets to answer. The targets that were answered from the cache
+     *                  will be unset.
+     * @param result    The result.
+     * @param database  The database.
+     */
+    template <>
+    inline void UAF_EXPORT readFromValueCacheIfNeeded<uaf::ReadService>(
+            const uaf::ReadRequest&             request,
+            uaf::Mask&                          mask,
+            uaf::ReadResult&                    result,
+            uaf::Database*                      database)
+    {
+        if (database->clientSettings.valueCacheEnable)
+        {
+            double maxAgeSec = request.serviceSettingsGiven
+                    ? request.serviceSettings.maxAgeSec
+                    : database->clientSettings.defaultReadSettings.maxAgeSec;
+
+            if (maxAgeSec > 0.0)
+                database->valueCache.readCachedValues(request, maxAgeSec, mask, result);
+        }
+    }
+
+
+    /**
+     * Template function to "catch" all requests that don't affect the value cache.
+     *
+     * Requests that *do* affect the value cache, will have a specialized
+     * updateValueCacheIfNeeded() function.
+     *
+     * @param request   The resolved request.
+     * @param mask      The targets that were invoked.
+     * @param result    The result.
+     * @param database  The database.
+     */
+    template <typename _Service>
+    void UAF_EXPORT updateValueCacheIfNeeded(
+            const typename _Service::Request&   request,
+            const uaf::Mask&                    mask,
+            const typename _Service::Result&    result,
+            uaf::Database*                      database)
+    {}
+
+
+    /**
+     * Add the values of a resolved uaf::ReadRequest to the value cache, if enabled.
+     *
+     * @param request   The resolved request.
+     * @param mask      The targets that were read from the server.
+     * @param result    The result.
+     * @param database  The database.
+     */
+    template <>
+    inline void UAF_EXPORT updateValueCacheIfNeeded<uaf::ReadService>(
+            const uaf::ReadRequest&             request,
+            const uaf::Mask&                    mask,
+            const uaf::ReadResult&              result,
+            uaf::Database*                      database)
+    {
+        if (database->clientSettings.valueCacheEnable)
+            database->valueCache.addReadValues(
+                    request,
+                    mask,
+                    result,
+                    database->clientSettings.valueCacheMaxEntries);
+    }
+
+
+    /**
+     * Remove the values of a resolved uaf::WriteRequest from the value cache.
+     *
+     * @param request   The resolved request.
+     * @param mask      The targets that were written.
+     * @param result    The result.
+     * @param database  The database.
+     */
+    template <>
+    inline void UAF_EXPORT updateValueCacheIfNeeded<uaf::WriteService>(
+            const uaf::WriteRequest&            request,
+            const uaf::Mask&                    mask,
+            const uaf::WriteResult&             result,
+            uaf::Database*                      database)
+    {
+        // remove them even if the cache is disabled now, since it may have been enabled before
+        database->valueCache.removeWrittenValues(request, mask);
+    }
+
+
+    /**
+     * Remove the values of a resolved uaf::AsyncWriteRequest from the value cache.
+     *
+     * The values are removed as soon as the request is sent, since the server may have written
+     * them before the result arrives.
+     *
+     * @param request   The resolved request.
+     * @param mask      The targets that were sent.
+     * @param result    The result.
+     * @param database  The database.
+     */
+    template <>
+    inline void UAF_EXPORT updateValueCacheIfNeeded<uaf::AsyncWriteService>(
+            const uaf::AsyncWriteRequest&       request,
+            const uaf::Mask&                    mask,
+            const uaf::AsyncWriteResult&        result,
+            uaf::Database*                      database)
+    {
+        // remove them even if the cache is disabled now, since it may have been enabled before
+        database->valueCache.removeWrittenValues(request, mask);
+    }
+
+
 }
 
 
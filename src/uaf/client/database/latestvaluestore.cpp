@@ -0,0 +1,217 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/client/database/latestvaluestore.h"
+
+// STD
+#include <algorithm>
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::vector;
+
+
+    // Constructor
+    // =============================================================================================
+    LatestValueStore::LatestValueStore(LoggerFactory* loggerFactory)
+    {
+        logger_ = new Logger(loggerFactory, "LatestValues");
+    }
+
+
+    // Destructor
+    // =============================================================================================
+    LatestValueStore::~LatestValueStore()
+    {
+        delete logger_;
+        logger_ = 0;
+    }
+
+
+    // Add a slot
+    // =============================================================================================
+    void LatestValueStore::addItem(ClientHandle clientHandle, const ExpandedNodeId& nodeId)
+    {
+        {
+            Bucket& b = bucket(clientHandle);
+            UaMutexLocker locker(&b.mutex); // unlocks when locker goes out of scope
+
+            // a monitored item that is re-created (e.g. after a reconnection) keeps its slot
+            if (b.slots.find(clientHandle) == b.slots.end())
+                b.slots[clientHandle].clientHandle = clientHandle;
+        }
+
+        UaMutexLocker locker(&nodesMutex_); // unlocks when locker goes out of scope
+
+        // a re-created monitored item becomes the last added item of its node
+        ItemNodes::iterator itemIter = itemNodes_.find(clientHandle);
+        if (itemIter != itemNodes_.end())
+        {
+            removeFromNode(clientHandle, itemIter->second);
+            itemIter->second = nodeId;
+        }
+        else
+        {
+            itemNodes_[clientHandle] = nodeId;
+        }
+
+        Nodes::iterator nodeIter = findNode(nodeId);
+        if (nodeIter == nodes_.end())
+        {
+            NodeEntry entry;
+            entry.nodeId = nodeId;
+            nodeIter = nodes_.insert(std::make_pair(nodeId.hash(), entry));
+        }
+
+        nodeIter->second.clientHandles.push_back(clientHandle);
+
+        logger_->debug("Monitored item %d has been added", clientHandle);
+    }
+
+
+    // Remove a slot
+    // =============================================================================================
+    void LatestValueStore::removeItem(ClientHandle clientHandle)
+    {
+        {
+            Bucket& b = bucket(clientHandle);
+            UaMutexLocker locker(&b.mutex); // unlocks when locker goes out of scope
+            b.slots.erase(clientHandle);
+        }
+
+        UaMutexLocker locker(&nodesMutex_); // unlocks when locker goes out of scope
+
+        ItemNodes::iterator itemIter = itemNodes_.find(clientHandle);
+        if (itemIter != itemNodes_.end())
+        {
+            removeFromNode(clientHandle, itemIter->second);
+            itemNodes_.erase(itemIter);
+        }
+    }
+
+
+    // Find the entry of a monitored node
+    // =============================================================================================
+    LatestValueStore::Nodes::iterator LatestValueStore::findNode(const ExpandedNodeId& nodeId)
+    {
+        std::pair<Nodes::iterator, Nodes::iterator> range = nodes_.equal_range(nodeId.hash());
+
+        for (Nodes::iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second.nodeId == nodeId)
+                return it;
+        }
+
+        return nodes_.end();
+    }
+
+
+    // Remove a monitored item from the entry of its node
+    // =============================================================================================
+    void LatestValueStore::removeFromNode(ClientHandle clientHandle, const ExpandedNodeId& nodeId)
+    {
+        Nodes::iterator nodeIter = findNode(nodeId);
+        if (nodeIter == nodes_.end())
+            return;
+
+        // the other monitored items of the node (if any) keep providing its values
+        vector<ClientHandle>& clientHandles = nodeIter->second.clientHandles;
+        clientHandles.erase(std::remove(clientHandles.begin(), clientHandles.end(), clientHandle),
+                            clientHandles.end());
+
+        if (clientHandles.empty())
+            nodes_.erase(nodeIter);
+    }
+
+
+    // Store a value
+    // =============================================================================================
+    void LatestValueStore::update(ClientHandle clientHandle, const DataValue& value)
+    {
+        Bucket& b = bucket(clientHandle);
+        UaMutexLocker locker(&b.mutex); // unlocks when locker goes out of scope
+
+        Slots::iterator it = b.slots.find(clientHandle);
+
+        if (it != b.slots.end())
+        {
+            it->second.value = value;
+            it->second.sequenceNumber++;
+        }
+    }
+
+
+    // Get the latest value of a monitored item
+    // =============================================================================================
+    bool LatestValueStore::find(ClientHandle clientHandle, LatestValue& latestValue)
+    {
+        Bucket& b = bucket(clientHandle);
+        UaMutexLocker locker(&b.mutex); // unlocks when locker goes out of scope
+
+        Slots::const_iterator it = b.slots.find(clientHandle);
+
+        if (it == b.slots.end())
+            return false;
+
+        latestValue = it->second;
+        return true;
+    }
+
+
+    // Get the latest value of a monitored node
+    // =============================================================================================
+    bool LatestValueStore::find(const ExpandedNodeId& nodeId, LatestValue& latestValue)
+    {
+        bool isFound = false;
+        ClientHandle clientHandle = 0;
+
+        {
+            UaMutexLocker locker(&nodesMutex_); // unlocks when locker goes out of scope
+
+            Nodes::const_iterator it = findNode(nodeId);
+            if (it != nodes_.end())
+            {
+                clientHandle = it->second.clientHandles.back();
+                isFound = true;
+            }
+        }
+
+        return isFound && find(clientHandle, latestValue);
+    }
+
+
+    // Get the latest values of all monitored items
+    // =============================================================================================
+    void LatestValueStore::snapshot(vector<LatestValue>& latestValues)
+    {
+        for (uint32_t i = 0; i < NO_OF_BUCKETS; i++)
+        {
+            UaMutexLocker locker(&buckets_[i].mutex); // unlocks when locker goes out of scope
+
+            for (Slots::const_iterator it = buckets_[i].slots.begin();
+                 it != buckets_[i].slots.end();
+                 ++it)
+                latestValues.push_back(it->second);
+        }
+    }
+
+}
@@ -0,0 +1,190 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_LATESTVALUESTORE_H_
+#define UAF_LATESTVALUESTORE_H_
+
+// STD
+#include <vector>
+#include <map>
+// SDK
+#include "uabase/uamutex.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/expandednodeid.h"
+#include "uaf/util/datavalue.h"
+#include "uaf/util/handles.h"
+#include "uaf/util/logger.h"
+#include "uaf/client/clientexport.h"
+#include "uaf/client/subscriptions/latestvalue.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::LatestValueStore holds one slot per monitored data item, containing the most recent
+    * value that was received by the item (see ClientSettings::latestValueStoreEnable).
+    *
+    * The slots are spread over a number of separately locked buckets (by ClientHandle), so that
+    * the subscriptions that update the slots and the consumers that read them hardly ever have
+    * to wait for each other.
+    *
+    * @ingroup ClientDatabase
+    ***********************************************************************************************/
+    class UAF_EXPORT LatestValueStore
+    {
+    public:
+
+
+        /**
+         * Create an empty store which logs to the specified logger factory.
+         *
+         * @param loggerFactory The logger factory to log to.
+         */
+        LatestValueStore(uaf::LoggerFactory* loggerFactory);
+
+
+        /**
+         * Destruct the store.
+         */
+        virtual ~LatestValueStore();
+
+
+        /**
+         * Add a slot for a monitored item (if it doesn't have one yet).
+         *
+         * @param clientHandle  The client handle of the monitored item.
+         * @param nodeId        The resolved node that is being monitored.
+         */
+        void addItem(uaf::ClientHandle clientHandle, const uaf::ExpandedNodeId& nodeId);
+
+
+        /**
+         * Remove the slot of a monitored item.
+         *
+         * @param clientHandle  The client handle of the monitored item.
+         */
+        void removeItem(uaf::ClientHandle clientHandle);
+
+
+        /**
+         * Store a value that was received by a monitored item (if it has a slot).
+         *
+         * @param clientHandle  The client handle of the monitored item.
+         * @param value         The value that was received just now.
+         */
+        void update(uaf::ClientHandle clientHandle, const uaf::DataValue& value);
+
+
+        /**
+         * Get the latest value of a monitored item.
+         *
+         * @param clientHandle  The client handle of the monitored item.
+         * @param latestValue   The latest value (output).
+         * @return              True if the monitored item has a slot, false if not.
+         */
+        bool find(uaf::ClientHandle clientHandle, uaf::LatestValue& latestValue);
+
+
+        /**
+         * Get the latest value of a monitored node. If several monitored items monitor the same
+         * node, the one that was added last (and that was not removed yet) is used.
+         *
+         * @param nodeId        The resolved node.
+         * @param latestValue   The latest value (output).
+         * @return              True if the node is monitored, false if not.
+         */
+        bool find(const uaf::ExpandedNodeId& nodeId, uaf::LatestValue& latestValue);
+
+
+        /**
+         * Get the latest values of all monitored items.
+         *
+         * Each bucket is copied at once, so all values of a bucket are consistent, but the
+         * values of different buckets may have been copied while new values were stored.
+         *
+         * @param latestValues  The latest values (output, the values are appended).
+         */
+        void snapshot(std::vector<uaf::LatestValue>& latestValues);
+
+
+    private:
+
+
+        // no copying or assigning allowed
+        DISALLOW_COPY_AND_ASSIGN(LatestValueStore);
+
+
+        // the number of buckets to spread the ClientHandles over
+        static const uint32_t NO_OF_BUCKETS = 64;
+
+        // the slots of the monitored items (by ClientHandle)
+        typedef std::map<uaf::ClientHandle, uaf::LatestValue> Slots;
+
+        // a bucket holds the slots of the ClientHandles with the same remainder
+        struct Bucket
+        {
+            Slots   slots;
+            UaMutex mutex;
+        };
+
+        // a monitored node and the monitored items that provide its values (the last one is
+        // the one that was added last)
+        struct NodeEntry
+        {
+            uaf::ExpandedNodeId             nodeId;
+            std::vector<uaf::ClientHandle>  clientHandles;
+        };
+
+        // the monitored nodes are stored by the hash of their ExpandedNodeId
+        typedef std::multimap<uint32_t, NodeEntry> Nodes;
+
+        // the monitored node of each monitored item
+        typedef std::map<uaf::ClientHandle, uaf::ExpandedNodeId> ItemNodes;
+
+        // find the entry of a monitored node
+        Nodes::iterator findNode(const uaf::ExpandedNodeId& nodeId);
+
+        // remove a monitored item from the entry of its node
+        void removeFromNode(uaf::ClientHandle clientHandle, const uaf::ExpandedNodeId& nodeId);
+
+        // get the bucket of a ClientHandle
+        Bucket& bucket(uaf::ClientHandle clientHandle)
+        { return buckets_[clientHandle % NO_OF_BUCKETS]; }
+
+
+        // the logger of the store
+        uaf::Logger*    logger_;
+
+        // the slots
+        Bucket          buckets_[NO_OF_BUCKETS];
+
+        // the monitored nodes (and the node of each monitored item), and the mutex to protect them
+        Nodes           nodes_;
+        ItemNodes       itemNodes_;
+        UaMutex         nodesMutex_;
+    };
+
+}
+
+
+#endif /* UAF_LATESTVALUESTORE_H_ */
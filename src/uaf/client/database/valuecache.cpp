@@ -0,0 +1,341 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/client/database/valuecache.h"
+#include "uaf/util/helperfunctions.h"
+
+
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::string;
+    using std::vector;
+    using std::map;
+    using std::size_t;
+
+
+    // Constructor
+    // =============================================================================================
+    ValueCache::ValueCache(LoggerFactory* loggerFactory)
+    {
+        logger_ = new Logger(loggerFactory, "ValueCache");
+        logger_->debug("The value cache has been constructed");
+    }
+
+
+    // Destructor
+    // =============================================================================================
+    ValueCache::~ValueCache()
+    {
+        logger_->debug("Destructing the value cache");
+
+        clear();
+
+        delete logger_;
+        logger_ = 0;
+    }
+
+
+    // Compute the hash of a key
+    // =============================================================================================
+    uint32_t ValueCache::hash(const Key& key)
+    {
+        uint32_t ret = key.first.hash();
+        hashCombine(ret, uint32_t(key.second));
+        return ret;
+    }
+
+
+    // Find the entry of a key
+    // =============================================================================================
+    ValueCache::Cache::iterator ValueCache::findEntry(const Key& key)
+    {
+        std::pair<Cache::iterator, Cache::iterator> range = cache_.equal_range(hash(key));
+
+        for (Cache::iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second.key == key)
+                return it;
+        }
+
+        return cache_.end();
+    }
+
+
+    // Store a value that was received just now
+    // =============================================================================================
+    void ValueCache::storeEntry(const Key& key, const DataValue& value, size_t maxEntries)
+    {
+        Cache::iterator it = findEntry(key);
+
+        if (it == cache_.end())
+        {
+            if (maxEntries == 0)
+                return;
+
+            // make room by removing the values that were received the longest time ago
+            while (cache_.size() >= maxEntries)
+                eraseEntry(findEntry(updateOrder_.front()));
+
+            Entry entry;
+            entry.key             = key;
+            entry.updateOrderIter = updateOrder_.insert(updateOrder_.end(), key);
+            it = cache_.insert(std::make_pair(hash(key), entry));
+        }
+        else
+        {
+            // the entry now holds the most recently received value
+            updateOrder_.splice(updateOrder_.end(), updateOrder_, it->second.updateOrderIter);
+        }
+
+        it->second.value       = value;
+        it->second.receiveTime = DateTime::now();
+    }
+
+
+    // Remove an entry
+    // =============================================================================================
+    void ValueCache::eraseEntry(Cache::iterator iter)
+    {
+        updateOrder_.erase(iter->second.updateOrderIter);
+        cache_.erase(iter);
+    }
+
+
+    // Remove all values from the cache
+    // =============================================================================================
+    void ValueCache::clear()
+    {
+        logger_->info("Clearing the value cache");
+
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        cache_.clear();
+        updateOrder_.clear();
+    }
+
+
+    // Remove all values from the cache with the given server URI
+    // =============================================================================================
+    void ValueCache::clear(const string& serverUri)
+    {
+        logger_->info("Clearing the cached values for ServerUri '%s'", serverUri.c_str());
+
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        Cache::iterator it = cache_.begin();
+        while (it != cache_.end())
+        {
+            if (it->second.key.first.serverUri() == serverUri)
+                eraseEntry(it++);
+            else
+                ++it;
+        }
+    }
+
+
+    // Add a value to the cache
+    // =============================================================================================
+    void ValueCache::add(
+            const ExpandedNodeId&       nodeId,
+            attributeids::AttributeId   attributeId,
+            const DataValue&            value,
+            size_t                      maxEntries)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        storeEntry(Key(nodeId, attributeId), value, maxEntries);
+    }
+
+
+    // Remove a value from the cache
+    // =============================================================================================
+    void ValueCache::remove(const ExpandedNodeId& nodeId, attributeids::AttributeId attributeId)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        Cache::iterator iter = findEntry(Key(nodeId, attributeId));
+        if (iter != cache_.end())
+            eraseEntry(iter);
+    }
+
+
+    // Find a value in the cache
+    // =============================================================================================
+    bool ValueCache::find(
+            const ExpandedNodeId&       nodeId,
+            attributeids::AttributeId   attributeId,
+            double                      maxAgeSec,
+            DataValue&                  value)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        Cache::const_iterator iter = findEntry(Key(nodeId, attributeId));
+
+        bool found = (iter != cache_.end())
+                  && (iter->second.receiveTime.msecsTo(DateTime::now()) <= maxAgeSec * 1000.0);
+
+        if (found)
+            value = iter->second.value;
+
+        return found;
+    }
+
+
+    // Answer the targets of a read request from the cache
+    // =============================================================================================
+    void ValueCache::readCachedValues(
+            const ReadRequest&  request,
+            double              maxAgeSec,
+            Mask&               mask,
+            ReadResult&         result)
+    {
+        size_t noOfCachedValues = 0;
+
+        DataValue value;
+
+        for (size_t i = 0; i < request.targets.size(); i++)
+        {
+            // the cache only holds complete values
+            if (mask.isSet(i)
+                    && request.targets[i].address.isExpandedNodeId()
+                    && request.targets[i].indexRange.empty()
+                    && find(request.targets[i].address.getExpandedNodeId(),
+                            request.targets[i].attributeId,
+                            maxAgeSec,
+                            value))
+            {
+                static_cast<DataValue&>(result.targets[i]) = value;
+                result.targets[i].status = statuscodes::Good;
+                mask.unset(i);
+                noOfCachedValues++;
+            }
+        }
+
+        if (noOfCachedValues > 0)
+            logger_->debug("%d of the targets were read from the value cache", noOfCachedValues);
+    }
+
+
+    // Add the values of a read result to the cache
+    // =============================================================================================
+    void ValueCache::addReadValues(
+            const ReadRequest&  request,
+            const Mask&         mask,
+            const ReadResult&   result,
+            size_t              maxEntries)
+    {
+        for (size_t i = 0; i < request.targets.size(); i++)
+        {
+            // a part of an array must not answer the reads of the complete value
+            if (mask.isSet(i)
+                    && result.targets[i].status.isGood()
+                    && OpcUa_IsGood(result.targets[i].opcUaStatusCode)
+                    && request.targets[i].address.isExpandedNodeId()
+                    && request.targets[i].indexRange.empty())
+                add(request.targets[i].address.getExpandedNodeId(),
+                    request.targets[i].attributeId,
+                    result.targets[i],
+                    maxEntries);
+        }
+    }
+
+
+    // Remove the written values from the cache
+    // =============================================================================================
+    void ValueCache::removeWrittenValues(const WriteRequest& request, const Mask& mask)
+    {
+        removeWrittenTargets(request.targets, mask);
+    }
+
+
+    // Remove the asynchronously written values from the cache
+    // =============================================================================================
+    void ValueCache::removeWrittenValues(const AsyncWriteRequest& request, const Mask& mask)
+    {
+        removeWrittenTargets(request.targets, mask);
+    }
+
+
+    // Remove the values of the written targets from the cache
+    // =============================================================================================
+    void ValueCache::removeWrittenTargets(const vector<WriteRequestTarget>& targets, const Mask& mask)
+    {
+        for (size_t i = 0; i < targets.size(); i++)
+        {
+            if (mask.isSet(i) && targets[i].address.isExpandedNodeId())
+                remove(targets[i].address.getExpandedNodeId(), targets[i].attributeId);
+        }
+    }
+
+
+    // Let a monitored item update the cache
+    // =============================================================================================
+    void ValueCache::addMonitoredItem(
+            ClientHandle                clientHandle,
+            const ExpandedNodeId&       nodeId,
+            attributeids::AttributeId   attributeId)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        monitoredItems_[clientHandle] = Key(nodeId, attributeId);
+    }
+
+
+    // Stop letting a monitored item update the cache
+    // =============================================================================================
+    void ValueCache::removeMonitoredItem(ClientHandle clientHandle)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        monitoredItems_.erase(clientHandle);
+    }
+
+
+    // Update the cache with the data change of a monitored item
+    // =============================================================================================
+    void ValueCache::update(ClientHandle clientHandle, const DataValue& value, size_t maxEntries)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        MonitoredItems::const_iterator iter = monitoredItems_.find(clientHandle);
+
+        if (iter != monitoredItems_.end())
+        {
+            // bad values are not cached, but they invalidate the previous value
+            if (OpcUa_IsGood(value.opcUaStatusCode))
+            {
+                storeEntry(iter->second, value, maxEntries);
+            }
+            else
+            {
+                Cache::iterator entryIter = findEntry(iter->second);
+                if (entryIter != cache_.end())
+                    eraseEntry(entryIter);
+            }
+        }
+    }
+
+
+
+
+}
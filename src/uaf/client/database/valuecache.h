@@ -0,0 +1,318 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_VALUECACHE_H_
+#define UAF_VALUECACHE_H_
+
+// STD
+#include <string>
+#include <vector>
+#include <map>
+#include <list>
+// SDK
+#include "uabase/uamutex.h"
+// UAF
+#include "uaf/util/expandednodeid.h"
+#include "uaf/util/datavalue.h"
+#include "uaf/util/datetime.h"
+#include "uaf/util/attributeids.h"
+#include "uaf/util/handles.h"
+#include "uaf/util/logger.h"
+#include "uaf/util/mask.h"
+#include "uaf/client/clientexport.h"
+#include "uaf/client/clientservices.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::ValueCache can avoid Read service calls by storing the most recent values that were
+    * read (or received by monitored items) for each resolved node and attribute.
+    *
+    * A cached value is only used to answer a read if it was received by the client less than
+    * ReadSettings::maxAgeSec ago. The age is measured on the client side (from the moment the
+    * value was received), so it is not affected by clock differences with the server.
+    *
+    * The number of cached values is bounded: when the cache is full, the value that was received
+    * the longest time ago is removed to make room for a new one.
+    *
+    * Only complete values are cached: reads and monitored items with an index range neither
+    * update the cache nor are answered by it. The cached values always hold both the source and
+    * the server timestamp, since the Read service and the monitored items always request both.
+    *
+    * @ingroup ClientDatabase
+    ***********************************************************************************************/
+    class UAF_EXPORT ValueCache
+    {
+    public:
+
+
+        /**
+         * Create a value cache which logs to the specified logger factory.
+         *
+         * @param loggerFactory The logger factory to log to.
+         */
+        ValueCache(uaf::LoggerFactory* loggerFactory);
+
+
+        /**
+         * Destruct the cache.
+         */
+        virtual ~ValueCache();
+
+
+        /**
+         * Clear the cache.
+         */
+        void clear();
+
+
+        /**
+         * Remove all cached values that belong to the given server URI.
+         */
+        void clear(const std::string& serverUri);
+
+
+        /**
+         * Add (or replace) the value of an attribute of a node.
+         *
+         * @param nodeId        The resolved node.
+         * @param attributeId   The attribute of the node.
+         * @param value         The value that was received just now.
+         * @param maxEntries    The maximum number of values in the cache.
+         */
+        void add(
+                const uaf::ExpandedNodeId&          nodeId,
+                uaf::attributeids::AttributeId      attributeId,
+                const uaf::DataValue&               value,
+                std::size_t                         maxEntries);
+
+
+        /**
+         * Remove the value of an attribute of a node (e.g. because it was written).
+         *
+         * @param nodeId        The resolved node.
+         * @param attributeId   The attribute of the node.
+         */
+        void remove(
+                const uaf::ExpandedNodeId&          nodeId,
+                uaf::attributeids::AttributeId      attributeId);
+
+
+        /**
+         * Find the value of an attribute of a node, if it's not older than the given age.
+         *
+         * @param nodeId        The resolved node.
+         * @param attributeId   The attribute of the node.
+         * @param maxAgeSec     The maximum age of the value, in seconds.
+         * @param value         The found value (if it was found of course).
+         * @return              True if a value was found, false if not.
+         */
+        bool find(
+                const uaf::ExpandedNodeId&          nodeId,
+                uaf::attributeids::AttributeId      attributeId,
+                double                              maxAgeSec,
+                uaf::DataValue&                     value);
+
+
+        /**
+         * Answer the masked targets of a resolved read request from the cache, as far as
+         * possible. The targets that were answered are unset from the mask, so only the
+         * remaining targets need to be read from the server. Targets with an index range are
+         * never answered from the cache.
+         *
+         * @param request       The resolved request.
+         * @param maxAgeSec     The maximum age of the values, in seconds.
+         * @param mask          The targets to answer (updated).
+         * @param result        The result to update.
+         */
+        void readCachedValues(
+                const uaf::ReadRequest&             request,
+                double                              maxAgeSec,
+                uaf::Mask&                          mask,
+                uaf::ReadResult&                    result);
+
+
+        /**
+         * Add the good values of the masked targets of a resolved read request to the cache.
+         * The values of targets with an index range are not added, since they only hold a part
+         * of the value.
+         *
+         * @param request       The resolved request.
+         * @param mask          The targets that were read from the server.
+         * @param result        The result.
+         * @param maxEntries    The maximum number of values in the cache.
+         */
+        void addReadValues(
+                const uaf::ReadRequest&             request,
+                const uaf::Mask&                    mask,
+                const uaf::ReadResult&              result,
+                std::size_t                         maxEntries);
+
+
+        /**
+         * Remove the values of the masked targets of a resolved write request from the cache.
+         *
+         * @param request       The resolved request.
+         * @param mask          The targets that were written.
+         */
+        void removeWrittenValues(
+                const uaf::WriteRequest&            request,
+                const uaf::Mask&                    mask);
+
+
+        /**
+         * Remove the values of the masked targets of a resolved asynchronous write request from
+         * the cache.
+         *
+         * @param request       The resolved request.
+         * @param mask          The targets that were written.
+         */
+        void removeWrittenValues(
+                const uaf::AsyncWriteRequest&       request,
+                const uaf::Mask&                    mask);
+
+
+        /**
+         * Let the data changes of a monitored item update the cache.
+         *
+         * @param clientHandle  The client handle of the monitored item.
+         * @param nodeId        The resolved node that is being monitored.
+         * @param attributeId   The attribute that is being monitored.
+         */
+        void addMonitoredItem(
+                uaf::ClientHandle                   clientHandle,
+                const uaf::ExpandedNodeId&          nodeId,
+                uaf::attributeids::AttributeId      attributeId);
+
+
+        /**
+         * Stop updating the cache with the data changes of a monitored item.
+         *
+         * @param clientHandle  The client handle of the monitored item.
+         */
+        void removeMonitoredItem(uaf::ClientHandle clientHandle);
+
+
+        /**
+         * Update the cache with a data change of a monitored item (if the monitored item was
+         * added, see addMonitoredItem()).
+         *
+         * @param clientHandle  The client handle of the monitored item.
+         * @param value         The value that was received just now.
+         * @param maxEntries    The maximum number of values in the cache.
+         */
+        void update(
+                uaf::ClientHandle                   clientHandle,
+                const uaf::DataValue&               value,
+                std::size_t                         maxEntries);
+
+
+
+    private:
+
+
+        // no copying or assigning allowed
+        DISALLOW_COPY_AND_ASSIGN(ValueCache);
+
+
+        // private typedefs
+
+
+        /** The key of a cached value: a resolved node and one of its attributes. */
+        typedef std::pair<uaf::ExpandedNodeId, uaf::attributeids::AttributeId> Key;
+
+        /** The keys of the cached values, from the least to the most recently received value. */
+        typedef std::list<Key> UpdateOrder;
+
+        /** A cached value of a node and attribute, and the time it was received by the client. */
+        struct Entry
+        {
+            Key                     key;
+            uaf::DataValue          value;
+            uaf::DateTime           receiveTime;
+            UpdateOrder::iterator   updateOrderIter;
+        };
+
+        /** A cache stores the entries by the hash of their key. */
+        typedef std::multimap<uint32_t, Entry> Cache;
+
+        /** The monitored items that update the cache. */
+        typedef std::map<uaf::ClientHandle, Key> MonitoredItems;
+
+
+        // private methods
+
+
+        /**
+         * Compute the hash of a key.
+         */
+        static uint32_t hash(const Key& key);
+
+        /**
+         * Find the entry of a key (the mutex must be locked).
+         */
+        Cache::iterator findEntry(const Key& key);
+
+        /**
+         * Store a value that was received just now, and remove the least recently received
+         * values if the cache is full (the mutex must be locked).
+         */
+        void storeEntry(const Key& key, const uaf::DataValue& value, std::size_t maxEntries);
+
+        /**
+         * Remove an entry (the mutex must be locked).
+         */
+        void eraseEntry(Cache::iterator iter);
+
+        /**
+         * Remove the values of the masked targets of a write request.
+         */
+        void removeWrittenTargets(
+                const std::vector<uaf::WriteRequestTarget>& targets,
+                const uaf::Mask&                            mask);
+
+
+        // private members
+
+
+        /** The logger of the value cache. */
+        uaf::Logger* logger_;
+
+        /** The map containing the cached values. */
+        Cache cache_;
+
+        /** The order in which the cached values were received. */
+        UpdateOrder updateOrder_;
+
+        /** The map containing the monitored items that update the cache. */
+        MonitoredItems monitoredItems_;
+
+        /** The mutex to safely manipulate the maps. */
+        UaMutex mutex_;
+
+    };
+
+}
+
+
+#endif /* UAF_VALUECACHE_H_ */
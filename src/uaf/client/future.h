@@ -0,0 +1,383 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_FUTURE_H_
+#define UAF_FUTURE_H_
+
+// STD
+#include <vector>
+#include <algorithm>
+// SDK
+#include "uabase/uamutex.h"
+#include "uabase/uasemaphore.h"
+// UAF
+#include "uaf/util/handles.h"
+#include "uaf/util/constants.h"
+#include "uaf/util/callbacks.h"
+#include "uaf/client/clientexport.h"
+
+
+namespace uaf
+{
+
+    // forward declarations
+    class Client;
+    class SessionFactory;
+
+
+    /*******************************************************************************************//**
+    * A uaf::Future holds the result of a request that is still being processed (see e.g.
+    * Client::readAsync()).
+    *
+    * Futures are cheap to copy: all copies share the same state. You can wait for the result
+    * (wait(), get(), waitAll(), waitAny()), or register continuations that are called as soon as
+    * the result is available (then()).
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    template<typename _Result>
+    class Future
+    {
+    public:
+
+
+        /**
+         * Create an invalid future (i.e. one that is not associated with a request).
+         */
+        Future()
+        : state_(0)
+        {}
+
+
+        /**
+         * Create a copy that shares the state of the given future.
+         */
+        Future(const Future& other)
+        : state_(other.state_)
+        {
+            attach();
+        }
+
+
+        /**
+         * Share the state of the given future.
+         */
+        Future& operator=(const Future& other)
+        {
+            if (state_ != other.state_)
+            {
+                detach();
+                state_ = other.state_;
+                attach();
+            }
+            return *this;
+        }
+
+
+        /**
+         * Destruct the future (the shared state is deleted together with the last copy).
+         */
+        ~Future()
+        {
+            detach();
+        }
+
+
+        /**
+         * Is the future associated with a request?
+         */
+        bool isValid() const
+        {
+            return state_ != 0;
+        }
+
+
+        /**
+         * Get the handle of the request of which the future will hold the result.
+         */
+        uaf::RequestHandle requestHandle() const
+        {
+            return state_ == 0 ? uaf::constants::REQUESTHANDLE_NOT_ASSIGNED : state_->requestHandle;
+        }
+
+
+        /**
+         * Is the result available? (False for an invalid future.)
+         */
+        bool isReady() const
+        {
+            if (state_ == 0)
+                return false;
+
+            UaMutexLocker locker(&state_->mutex); // auto-unlocks when out of scope
+            return state_->ready;
+        }
+
+
+        /**
+         * Block until the result is available (returns immediately for an invalid future).
+         */
+        void wait() const
+        {
+            if (state_ == 0)
+                return;
+
+            UaSemaphore semaphore(0);
+
+            state_->mutex.lock();
+            bool ready = state_->ready;
+            if (!ready)
+                state_->waiters.push_back(&semaphore);
+            state_->mutex.unlock();
+
+            if (!ready)
+            {
+                semaphore.wait();
+
+                // the semaphore is posted while the mutex is locked, so once we own the mutex
+                // the semaphore can safely go out of scope
+                state_->mutex.lock();
+                state_->mutex.unlock();
+            }
+        }
+
+
+        /**
+         * Block until the result is available, and get it.
+         *
+         * @return  The result (a default result for an invalid future).
+         */
+        _Result get() const
+        {
+            if (state_ == 0)
+                return _Result();
+
+            wait();
+            return state_->result;
+        }
+
+
+        /**
+         * Register a continuation, to be called with the result as soon as it is available.
+         *
+         * If the result is already available, the continuation is called immediately (by the
+         * calling thread). If not, it is called by the thread that provides the result (so it
+         * should return quickly, and it should not wait for other futures).
+         *
+         * @param callback  The continuation (which remains owned by the caller, and must be
+         *                  kept alive until it has been called).
+         */
+        void then(uaf::Callback<_Result>* callback)
+        {
+            if (state_ == 0 || callback == 0)
+                return;
+
+            state_->mutex.lock();
+            bool ready = state_->ready;
+            if (!ready)
+                state_->continuations.push_back(callback);
+            state_->mutex.unlock();
+
+            if (ready)
+                (*callback)(state_->result);
+        }
+
+
+        /**
+         * Block until the results of all given futures are available.
+         *
+         * @param futures   The futures to wait for.
+         */
+        static void waitAll(const std::vector<Future>& futures)
+        {
+            for (std::size_t i = 0; i < futures.size(); i++)
+                futures[i].wait();
+        }
+
+
+        /**
+         * Block until the result of at least one of the given futures is available.
+         *
+         * @param futures   The futures to wait for.
+         * @return          The index of the first future that has its result available, or
+         *                  futures.size() if there are no valid futures to wait for.
+         */
+        static std::size_t waitAny(const std::vector<Future>& futures)
+        {
+            UaSemaphore semaphore(0);
+            std::size_t readyIndex = futures.size();
+            std::size_t noOfWaits  = 0;
+
+            // register the semaphore at each future, until we find one that is ready already
+            std::size_t noOfRegistrations = 0;
+            for (; noOfRegistrations < futures.size() && readyIndex == futures.size(); noOfRegistrations++)
+            {
+                State* state = futures[noOfRegistrations].state_;
+
+                if (state != 0)
+                {
+                    UaMutexLocker locker(&state->mutex); // auto-unlocks when out of scope
+
+                    if (state->ready)
+                        readyIndex = noOfRegistrations;
+                    else
+                    {
+                        state->waiters.push_back(&semaphore);
+                        noOfWaits++;
+                    }
+                }
+            }
+
+            // wait for any of the futures, if none was ready already
+            if (readyIndex == futures.size() && noOfWaits > 0)
+                semaphore.wait();
+
+            // unregister the semaphore from the futures that are not ready (the futures that
+            // are ready have forgotten their waiters already), and find the first ready future
+            for (std::size_t i = 0; i < noOfRegistrations; i++)
+            {
+                State* state = futures[i].state_;
+
+                if (state != 0)
+                {
+                    UaMutexLocker locker(&state->mutex); // auto-unlocks when out of scope
+
+                    if (state->ready)
+                    {
+                        if (readyIndex == futures.size())
+                            readyIndex = i;
+                    }
+                    else
+                    {
+                        state->waiters.erase(
+                                std::remove(state->waiters.begin(), state->waiters.end(), &semaphore),
+                                state->waiters.end());
+                    }
+                }
+            }
+
+            return readyIndex;
+        }
+
+
+    private:
+
+        // the futures are created and completed by the client
+        friend class uaf::Client;
+        friend class uaf::SessionFactory;
+
+
+        // the state that is shared by all copies of a future
+        struct State
+        {
+            State(uaf::RequestHandle requestHandle)
+            : refCount(1),
+              requestHandle(requestHandle),
+              ready(false)
+            {}
+
+            UaMutex                                 mutex;
+            uint32_t                                refCount;
+            uaf::RequestHandle                      requestHandle;
+            bool                                    ready;
+            _Result                                 result;
+            std::vector<UaSemaphore*>               waiters;
+            std::vector<uaf::Callback<_Result>*>    continuations;
+        };
+
+
+        /**
+         * Create a valid future, for the request with the given handle.
+         */
+        explicit Future(uaf::RequestHandle requestHandle)
+        : state_(new State(requestHandle))
+        {}
+
+
+        /**
+         * Provide the result: wake up the waiting threads and call the continuations.
+         * Only the first result that is provided is taken into account.
+         */
+        void setResult(const _Result& result) const
+        {
+            if (state_ == 0)
+                return;
+
+            std::vector<uaf::Callback<_Result>*> continuations;
+
+            state_->mutex.lock();
+            bool alreadyReady = state_->ready;
+            if (!alreadyReady)
+            {
+                state_->result = result;
+                state_->ready  = true;
+
+                // post the waiters while the mutex is locked, see wait() and waitAny()
+                for (std::size_t i = 0; i < state_->waiters.size(); i++)
+                    state_->waiters[i]->post(1);
+
+                state_->waiters.clear();
+                continuations.swap(state_->continuations);
+            }
+            state_->mutex.unlock();
+
+            // the result cannot change anymore, so the continuations don't need the lock
+            for (std::size_t i = 0; i < continuations.size(); i++)
+                (*continuations[i])(state_->result);
+        }
+
+
+        // share the state
+        void attach()
+        {
+            if (state_ != 0)
+            {
+                UaMutexLocker locker(&state_->mutex); // auto-unlocks when out of scope
+                state_->refCount++;
+            }
+        }
+
+
+        // stop sharing the state, and delete it if it's not shared anymore
+        void detach()
+        {
+            if (state_ != 0)
+            {
+                state_->mutex.lock();
+                bool last = (--state_->refCount == 0);
+                state_->mutex.unlock();
+
+                if (last)
+                    delete state_;
+
+                state_ = 0;
+            }
+        }
+
+
+        // the shared state (0 for an invalid future)
+        State* state_;
+    };
+
+
+}
+
+
+#endif /* UAF_FUTURE_H_ */
@@ -35,6 +35,7 @@
 #include "uaf/util/constants.h"
 #include "uaf/client/clientexport.h"
 #include "uaf/client/sessions/sessioninformation.h"
+#include "uaf/client/sessions/registerednodes.h"
 #include "uaf/client/subscriptions/subscriptioninformation.h"
 #include "uaf/client/requests/requests.h"
 #include "uaf/client/results/results.h"
@@ -90,7 +91,12 @@ namespace uaf
         : asynchronous_(async),
           transactionId_(0),
           requestHandle_(requestHandle),
-          invocationLevel_(uaf::SessionLevel)
+          invocationLevel_(uaf::SessionLevel),
+          keepEncoded_(false),
+          encoded_(false),
+          registeredNodes_(0),
+          registeredNodesMax_(0),
+          registeredNodesMinAccessCount_(0)
         {}
 
 
@@ -135,6 +141,9 @@ namespace uaf
         /** Get the level at which the service should be invoked. */
         uaf::InvocationLevel               invocationLevel()       const { return invocationLevel_; }
 
+        /** Is the SDK request data kept between successive invocations? */
+        bool                                keepEncoded()           const { return keepEncoded_; }
+
 
         ///@} //////////////////////////////////////////////////////////////////////////////////////
         /**
@@ -181,6 +190,22 @@ namespace uaf
         { transactionId_ = transactionId; }
 
 
+        /**
+         * Keep the SDK request data after a synchronous invocation at the session level, so that
+         * it doesn't have to be copied again when the same invocation is invoked again (as is done
+         * for prepared requests).
+         */
+        void setKeepEncoded(bool keepEncoded)
+        {
+            keepEncoded_ = keepEncoded;
+            encoded_     = false;
+        }
+
+        /** Discard the kept SDK request data, so that it will be copied again by the next invocation. */
+        void resetEncoding()
+        { encoded_ = false; }
+
+
         /** Provide the information about the session. */
         void setSessionInformation(const uaf::SessionInformation& sessionInformation)
         {
@@ -188,6 +213,21 @@ namespace uaf
         }
 
 
+        /**
+         * Provide the registered nodes of the session, so that the targets can use the aliases
+         * of the registered nodes (or 0 if the nodes should not be registered).
+         */
+        void setRegisteredNodes(
+                uaf::RegisteredNodes*   registeredNodes,
+                uint32_t                maxNodes,
+                uint32_t                minAccessCount)
+        {
+            registeredNodes_                = registeredNodes;
+            registeredNodesMax_             = maxNodes;
+            registeredNodesMinAccessCount_  = minAccessCount;
+        }
+
+
         /** Provide the information about the subscription. */
         void setSubscriptionInformation(const uaf::SubscriptionInformation& subscriptionInformation)
         {
@@ -228,11 +268,11 @@ namespace uaf
         {
             uaf::Status ret;
 
-            logger->debug("Invoking the service at the session level");
+            UAF_LOG_DEBUG(logger, ("Invoking the service at the session level"));
 
             if (asynchronous_)
             {
-                logger->debug("Copying the data from the asynchronous UAF request to the SDK level");
+                UAF_LOG_DEBUG(logger, ("Copying the data from the asynchronous UAF request to the SDK level"));
                 ret = fromAsyncUafToSdk(
                         requestTargets_,
                         serviceSettings_,
@@ -241,34 +281,44 @@ namespace uaf
 
                 if (ret.isGood())
                 {
-                    logger->debug("Invoking the asynchronous request at the SDK level");
+                    UAF_LOG_DEBUG(logger, ("Invoking the asynchronous request at the SDK level"));
                     ret = invokeAsyncSdkService(uaSession, transactionId_);
                 }
             }
             else
             {
-                logger->debug("Copying the data from the synchronous UAF request to the SDK level");
-                ret = fromSyncUafToSdk(
-                        requestTargets_,
-                        serviceSettings_,
-                        nameSpaceArray,
-                        serverArray);
+                // prepared requests keep their SDK data, so it only needs to be copied once
+                if (keepEncoded_ && encoded_)
+                {
+                    UAF_LOG_DEBUG(logger, ("Reusing the SDK data of the previous invocation"));
+                    ret = uaf::statuscodes::Good;
+                }
+                else
+                {
+                    UAF_LOG_DEBUG(logger, ("Copying the data from the synchronous UAF request to the SDK level"));
+                    ret = fromSyncUafToSdk(
+                            requestTargets_,
+                            serviceSettings_,
+                            nameSpaceArray,
+                            serverArray);
+                    encoded_ = keepEncoded_ && ret.isGood();
+                }
 
                 if (ret.isGood())
                 {
-                    logger->debug("Invoking the synchronous request at the SDK level");
+                    UAF_LOG_DEBUG(logger, ("Invoking the synchronous request at the SDK level"));
                     ret = invokeSyncSdkService(uaSession);
                 }
 
                 if (ret.isGood())
                 {
-                    logger->debug("Copying the data from SDK level to the UAF result");
+                    UAF_LOG_DEBUG(logger, ("Copying the data from SDK level to the UAF result"));
                     ret = fromSyncSdkToUaf(nameSpaceArray, serverArray, resultTargets_);
                 }
             }
 
             if (ret.isGood())
-                logger->debug("The request has been invoked successfully");
+                UAF_LOG_DEBUG(logger, ("The request has been invoked successfully"));
             else
             {
                 logger->error("The service invocation failed");
@@ -296,11 +346,11 @@ namespace uaf
         {
             uaf::Status ret;
 
-            logger->debug("Invoking the service at the subscription level");
+            UAF_LOG_DEBUG(logger, ("Invoking the service at the subscription level"));
 
             if (this->asynchronous())
             {
-                logger->debug("Copying the data from the asynchronous UAF request to the SDK level");
+                UAF_LOG_DEBUG(logger, ("Copying the data from the asynchronous UAF request to the SDK level"));
                 ret = this->fromAsyncUafToSdk(
                         this->requestTargets(),
                         this->serviceSettings(),
@@ -309,13 +359,13 @@ namespace uaf
 
                 if (ret.isGood())
                 {
-                    logger->debug("Invoking the asynchronous request at the SDK level");
+                    UAF_LOG_DEBUG(logger, ("Invoking the asynchronous request at the SDK level"));
                     ret = this->invokeAsyncSdkService(uaSubscription, this->transactionId());
                 }
             }
             else
             {
-                logger->debug("Copying the data from the synchronous UAF request to the SDK level");
+                UAF_LOG_DEBUG(logger, ("Copying the data from the synchronous UAF request to the SDK level"));
                 ret = this->fromSyncUafToSdk(
                         this->requestTargets(),
                         this->serviceSettings(),
@@ -324,13 +374,13 @@ namespace uaf
 
                 if (ret.isGood())
                 {
-                    logger->debug("Invoking the synchronous request at the SDK level");
+                    UAF_LOG_DEBUG(logger, ("Invoking the synchronous request at the SDK level"));
                     ret = this->invokeSyncSdkService(uaSubscription);
                 }
 
                 if (ret.isGood())
                 {
-                    logger->debug("Copying the data from SDK level to the UAF result");
+                    UAF_LOG_DEBUG(logger, ("Copying the data from SDK level to the UAF result"));
                     ret = this->fromSyncSdkToUaf(nameSpaceArray, serverArray, this->resultTargets());
                 }
             }
@@ -521,6 +571,27 @@ namespace uaf
         ///@}
 
 
+    protected:
+
+
+        /**
+         * Replace the NodeId of a target by the alias of the registered node (if the nodes of
+         * the session should be registered, and the node has been registered already).
+         *
+         * @param address       The (resolved) address of the target.
+         * @param opcUaNodeId   The NodeId of the target, as it will be sent to the server.
+         */
+        void substituteRegisteredNode(const uaf::Address& address, OpcUa_NodeId& opcUaNodeId)
+        {
+            if (registeredNodes_ != 0)
+                registeredNodes_->substitute(
+                        address,
+                        registeredNodesMax_,
+                        registeredNodesMinAccessCount_,
+                        opcUaNodeId);
+        }
+
+
     private:
 
 
@@ -713,6 +784,13 @@ namespace uaf
         uaf::SubscriptionInformation subscriptionInformation_;
         // the level at which the service should be invoked
         uaf::InvocationLevel       invocationLevel_;
+        // should the SDK request data be kept between invocations, and is it currently kept?
+        bool                       keepEncoded_;
+        bool                       encoded_;
+        // the registered nodes of the session (if the nodes should be registered)
+        uaf::RegisteredNodes*      registeredNodes_;
+        uint32_t                   registeredNodesMax_;
+        uint32_t                   registeredNodesMinAccessCount_;
 
     };
 
@@ -53,6 +53,10 @@ namespace uaf
             // update the node id of the target
             ret = nameSpaceArray.fillOpcUaNodeId(targets[i].address, uaWriteValues_[i].NodeId);
 
+            // use the alias of the node if it was registered
+            if (ret.isGood())
+                substituteRegisteredNode(targets[i].address, uaWriteValues_[i].NodeId);
+
             // only update the rest of the SDK variables if no error has occurred yet
             if (ret.isGood())
             {
@@ -0,0 +1,86 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/client/preparedread.h"
+#include "uaf/client/client.h"
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::vector;
+
+
+    // Constructor
+    // =============================================================================================
+    PreparedRead::PreparedRead()
+    : client_(NULL),
+      prepared_(false)
+    {}
+
+
+    // Destructor
+    // =============================================================================================
+    PreparedRead::~PreparedRead()
+    {
+        clear();
+    }
+
+
+    // Was the read prepared successfully?
+    // =============================================================================================
+    bool PreparedRead::isPrepared() const
+    {
+        return prepared_;
+    }
+
+
+    // Get the request
+    // =============================================================================================
+    ReadRequest PreparedRead::request() const
+    {
+        return request_;
+    }
+
+
+    // Execute the prepared read
+    // =============================================================================================
+    Status PreparedRead::execute(ReadResult& result)
+    {
+        if (client_ == NULL)
+            return ReadNotPreparedError();
+        else
+            return client_->execute(*this, result);
+    }
+
+
+    // Delete the prepared invocations
+    // =============================================================================================
+    void PreparedRead::clear()
+    {
+        for (vector< PreparedInvocation<ReadService> >::iterator it = invocations_.begin();
+             it != invocations_.end();
+             ++it)
+            delete it->invocation;
+
+        invocations_.clear();
+        prepared_ = false;
+    }
+
+}
@@ -0,0 +1,131 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_PREPAREDREAD_H_
+#define UAF_PREPAREDREAD_H_
+
+// STD
+#include <vector>
+// SDK
+#include "uabase/uamutex.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/mask.h"
+#include "uaf/util/status.h"
+#include "uaf/client/clientexport.h"
+#include "uaf/client/clientservices.h"
+#include "uaf/client/sessions/preparedinvocation.h"
+
+
+namespace uaf
+{
+
+    // forward declaration
+    class Client;
+
+
+    /*******************************************************************************************//**
+    * A PreparedRead is a read request that was prepared by Client::prepare(), so that it can be
+    * executed many times (e.g. for cyclic polling) with a minimum of overhead.
+    *
+    * The targets of the request are only resolved once, and the Read service calls are only built
+    * and encoded once. Executing the prepared read therefore only involves sending the service
+    * calls to the server(s) and decoding the values that they return.
+    *
+    * When a session of the prepared read is reconnected (so the NamespaceArray of the server
+    * may have changed) or when it no longer exists, the read is prepared again automatically
+    * during the next execution.
+    *
+    * A PreparedRead must not outlive the Client that prepared it.
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    class UAF_EXPORT PreparedRead
+    {
+    public:
+
+
+        /**
+         * Create an empty prepared read (see Client::prepare()).
+         */
+        PreparedRead();
+
+
+        /**
+         * Destruct the prepared read.
+         */
+        ~PreparedRead();
+
+
+        /**
+         * Was the read prepared successfully?
+         */
+        bool isPrepared() const;
+
+
+        /**
+         * Get the request, as it was given to Client::prepare().
+         */
+        uaf::ReadRequest request() const;
+
+
+        /**
+         * Execute the prepared read.
+         *
+         * This is the same as calling Client::execute() on the client that prepared the read.
+         *
+         * @param result    The result.
+         * @return          The client-side status.
+         */
+        uaf::Status execute(uaf::ReadResult& result);
+
+
+    private:
+
+        DISALLOW_COPY_AND_ASSIGN(PreparedRead);
+
+        // the client prepares and executes the read
+        friend class uaf::Client;
+
+        /**
+         * Delete the prepared invocations.
+         */
+        void clear();
+
+        // the client that prepared the read (NULL if not prepared yet)
+        uaf::Client*                                            client_;
+        // the request as it was given, and the request after resolution
+        uaf::ReadRequest                                        request_;
+        uaf::ReadRequest                                        resolvedRequest_;
+        // the result after resolution (holding the statuses of the unresolved targets)
+        uaf::ReadResult                                         resolvedResult_;
+        // the prepared invocations
+        std::vector< uaf::PreparedInvocation<uaf::ReadService> > invocations_;
+        // true if the invocations have been prepared successfully
+        bool                                                    prepared_;
+        // mutex to make sure that the read isn't prepared or executed concurrently
+        UaMutex                                                 mutex_;
+    };
+
+
+}
+
+
+#endif /* UAF_PREPAREDREAD_H_ */
@@ -0,0 +1,86 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_READBATCH_H_
+#define UAF_READBATCH_H_
+
+// STD
+// SDK
+#include "uabase/uasemaphore.h"
+// UAF
+#include "uaf/util/status.h"
+#include "uaf/client/clientexport.h"
+#include "uaf/client/clientservices.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * An uaf::ReadBatch collects the targets of concurrent synchronous read requests that have
+    * the same settings, so that they can be read at once (see ClientSettings::readCoalescingEnable).
+    *
+    * The first request that opens the batch (the "leader") processes the combined request, the
+    * other requests (the "followers") wait until the leader has posted the result.
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    struct ReadBatch
+    {
+        ReadBatch()
+        : closed(false),
+          refCount(1),
+          full(0),
+          done(0)
+        {}
+
+        /** The combined request (with the settings of the first request). */
+        uaf::ReadRequest    request;
+
+        /** The combined result. */
+        uaf::ReadResult     result;
+
+        /** The status of the processing of the combined request. */
+        uaf::Status         status;
+
+        /** True if no more requests can join the batch. */
+        bool                closed;
+
+        /** The number of requests that still need the batch (the last one deletes it). */
+        uint32_t            refCount;
+
+        /** Posted when the batch is closed by a follower (so the leader doesn't need to wait
+         *  any longer). */
+        UaSemaphore         full;
+
+        /** Posted once for each follower, when the combined result is available. */
+        UaSemaphore         done;
+
+    private:
+        ReadBatch(const ReadBatch&);
+        ReadBatch& operator=(const ReadBatch&);
+    };
+
+
+}
+
+
+#endif /* UAF_READBATCH_H_ */
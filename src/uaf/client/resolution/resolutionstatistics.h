@@ -0,0 +1,86 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_RESOLUTIONSTATISTICS_H_
+#define UAF_RESOLUTIONSTATISTICS_H_
+
+
+// STD
+#include <string>
+#include <sstream>
+#include <stdint.h>
+// SDK
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/stringifiable.h"
+#include "uaf/client/clientexport.h"
+
+
+namespace uaf
+{
+
+    /*******************************************************************************************//**
+    * A uaf::ResolutionStatistics object holds the counters of the resolver, which show how many
+    * addresses were resolved from the address cache and how many had to be translated by the
+    * servers.
+    *
+    * All counters are accumulated since the client was created.
+    *
+    * @ingroup ClientResolution
+    ***********************************************************************************************/
+    class UAF_EXPORT ResolutionStatistics
+    {
+    public:
+
+
+        /**
+         * Construct statistics with all counters set to zero.
+         */
+        ResolutionStatistics();
+
+
+        /** The number of addresses that were loaded from the ClientSettings::addressCacheFile. */
+        uint32_t loadedAddresses;
+
+        /** The number of addresses that were resolved by the address cache. */
+        uint32_t cachedAddresses;
+
+        /** The number of relative paths that failed immediately because they failed recently
+         *  (see ClientSettings::resolutionFailureTtlSec). */
+        uint32_t cachedFailures;
+
+        /** The number of TranslateBrowsePathsToNodeIds requests that were sent to the servers. */
+        uint32_t translationRequests;
+
+        /** The number of browse paths that were translated by the servers. */
+        uint32_t translatedBrowsePaths;
+
+
+        /**
+         * Get a string representation of the statistics.
+         */
+        std::string toString(const std::string& indent="", std::size_t colon=24) const;
+    };
+
+
+}
+
+
+#endif /* UAF_RESOLUTIONSTATISTICS_H_ */
@@ -39,6 +39,7 @@ namespace uaf
       database_(database)
     {
         logger_ = new Logger(loggerFactory, "Resolver");
+        translationPool_ = new InvocationPool(loggerFactory);
         logger_->debug("The resolver has been constructed");
     }
 
@@ -48,11 +49,42 @@ namespace uaf
     {
         logger_->debug("Destructing the resolver");
 
+        delete translationPool_;
+        translationPool_ = 0;
+
         delete logger_;
         logger_ = 0;
     }
 
 
+    // Get the statistics
+    //==============================================================================================
+    ResolutionStatistics Resolver::statistics()
+    {
+        UaMutexLocker locker(&statisticsMutex_); // unlocks when locker goes out of scope
+        return statistics_;
+    }
+
+
+    // Count the addresses that were loaded from a file
+    //==============================================================================================
+    void Resolver::countLoadedAddresses(size_t noOfAddresses)
+    {
+        UaMutexLocker locker(&statisticsMutex_); // unlocks when locker goes out of scope
+        statistics_.loadedAddresses += uint32_t(noOfAddresses);
+    }
+
+
+    // Count a translation request
+    //==============================================================================================
+    void Resolver::countTranslation(size_t noOfBrowsePaths)
+    {
+        UaMutexLocker locker(&statisticsMutex_); // unlocks when locker goes out of scope
+        statistics_.translationRequests++;
+        statistics_.translatedBrowsePaths += uint32_t(noOfBrowsePaths);
+    }
+
+
 
     Status Resolver::resolveCached(
             const vector<Address>&  addresses,
@@ -73,15 +105,21 @@ namespace uaf
         expandedNodeIdMask.resize(noOfAddresses);
         relativePathMask.resize(noOfAddresses);
 
+        // look up all addresses at once
+        Mask cachedMask;
+        database_->addressCache.find(addresses, expandedNodeIds, cachedMask);
+
+        statisticsMutex_.lock();
+        statistics_.cachedAddresses += uint32_t(cachedMask.setCount());
+        statisticsMutex_.unlock();
+
         // loop through the addresses
         for (size_t i=0; i<noOfAddresses; i++)
         {
-            logger_->debug("Trying to find address %d in the cache", i);
-
-            if (database_->addressCache.find(addresses[i], expandedNodeIds[i]))
+            if (cachedMask.isSet(i))
             {
                 statuses[i] = statuscodes::Good;
-                logger_->debug("Address %d was already cached", i);
+                UAF_LOG_DEBUG(logger_, ("Address %d was already cached", i));
             }
             else
             {
@@ -104,6 +142,28 @@ namespace uaf
             }
         }
 
+        // the relative paths that recently failed, fail immediately again
+        if (ret.isGood()
+                && relativePathMask.setCount() > 0
+                && database_->clientSettings.resolutionFailureTtlSec > 0.0)
+        {
+            Mask failedMask;
+            database_->addressCache.findFailures(addresses, relativePathMask, statuses, failedMask);
+
+            statisticsMutex_.lock();
+            statistics_.cachedFailures += uint32_t(failedMask.setCount());
+            statisticsMutex_.unlock();
+
+            for (size_t i = 0; i < noOfAddresses; i++)
+            {
+                if (failedMask.isSet(i))
+                {
+                    relativePathMask.unset(i);
+                    logger_->debug("Address %d is a RelativePath that recently failed", i);
+                }
+            }
+        }
+
         return ret;
     }
 
@@ -125,11 +185,14 @@ namespace uaf
         size_t noOfAddresses = addresses.size();
 
         // log a nice message
-        logger_->debug("Resolving the following addresses:");
-        for (size_t i=0; i<noOfAddresses; i++)
+        if (logger_->isDebugEnabled())
         {
-            logger_->debug(" - Address %d", i);
-            logger_->debug(addresses[i].toString("   ", 28));
+            logger_->debug("Resolving the following addresses:");
+            for (size_t i=0; i<noOfAddresses; i++)
+            {
+                logger_->debug(" - Address %d", i);
+                logger_->debug(addresses[i].toString("   ", 28));
+            }
         }
 
         // prepare the output parameters by resizing them
@@ -241,16 +304,29 @@ namespace uaf
 
         // now try to resolve the relative paths (essentially browse paths since their starting
         // addresses have been resolved)
-        if (ret.isGood())
+        if (ret.isGood() && database_->clientSettings.sharedPrefixResolutionEnable)
+            ret = resolveBrowsePathsSharedPrefixes(browsePaths, remainingMask, results, statuses);
+        else if (ret.isGood())
             ret = resolveBrowsePaths(browsePaths, remainingMask, results, statuses);
 
-        // add the resolved addresses to the cache
+        // add the resolved addresses to the cache (and also the failed ones, if needed)
+        const ClientSettings& settings = database_->clientSettings;
+
         for (size_t i = 0; i < addresses.size() && ret.isGood(); i++)
         {
             if (mask.isSet(i) && statuses[i].isGood())
             {
                 database_->addressCache.add(addresses[i], results[i], true);
             }
+            else if (mask.isSet(i)
+                    && settings.resolutionFailureTtlSec > 0.0
+                    && AddressCache::isCacheableFailure(statuses[i]))
+            {
+                database_->addressCache.addFailure(addresses[i],
+                                                   statuses[i],
+                                                   settings.resolutionFailureTtlSec,
+                                                   settings.resolutionFailureMaxTtlSec);
+            }
         }
 
         return ret;
@@ -343,6 +419,10 @@ namespace uaf
         {
             logger_->debug("Nothing to do, no browse paths are marked with the mask");
         }
+        else if (database_->clientSettings.parallelResolutionEnable)
+        {
+            ret = resolveBrowsePathsPipelined(browsePaths, mask, results, statuses);
+        }
         else
         {
             // create a request and a result
@@ -356,6 +436,8 @@ namespace uaf
                             TranslateBrowsePathsToNodeIdsRequestTarget(browsePaths[i]));
             }
 
+            countTranslation(request.targets.size());
+
             ret = sessionFactory_->invokeRequest<TranslateBrowsePathsToNodeIdsService>(
                     request,
                     Mask(request.targets.size(), true),
@@ -387,6 +469,463 @@ namespace uaf
 
 
 
+    // Job that executes a single translation hop
+    //==============================================================================================
+    class Resolver::TranslationJob : public uaf::InvocationJob
+    {
+    public:
+
+        TranslationJob(
+                SessionFactory* sessionFactory,
+                TranslationHop* hop,
+                FinishedHops*   finishedHops)
+        : sessionFactory_(sessionFactory),
+          hop_(hop),
+          finishedHops_(finishedHops)
+        {}
+
+        virtual void execute()
+        {
+            hop_->status = sessionFactory_->invokeRequest<TranslateBrowsePathsToNodeIdsService>(
+                    hop_->request,
+                    Mask(hop_->request.targets.size(), true),
+                    hop_->result);
+
+            // hand the hop back to the resolving thread
+            // (don't touch the finishedHops_ anymore after posting the semaphore, since the
+            // resolving thread may return as soon as it has taken the last hop)
+            finishedHops_->mutex.lock();
+            finishedHops_->hops.push_back(hop_);
+            finishedHops_->mutex.unlock();
+            finishedHops_->semaphore.post(1);
+        }
+
+    private:
+        SessionFactory* sessionFactory_;
+        TranslationHop* hop_;
+        FinishedHops*   finishedHops_;
+    };
+
+
+    // Start the translation hops for the given browse paths
+    //==============================================================================================
+    void Resolver::startTranslationHops(
+            const vector<BrowsePath>&   browsePaths,
+            const vector<size_t>&       ranks,
+            FinishedHops&               finishedHops,
+            size_t&                     noOfPending)
+    {
+        // group the browse paths by the server in which they start
+        map<string, TranslationHop*> hops;
+        for (size_t i = 0; i < ranks.size(); i++)
+        {
+            const BrowsePath& browsePath = browsePaths[ranks[i]];
+            const string& serverUri = browsePath.startingExpandedNodeId.serverUri();
+
+            map<string, TranslationHop*>::iterator it = hops.find(serverUri);
+            if (it == hops.end())
+            {
+                it = hops.insert(std::make_pair(serverUri, new TranslationHop())).first;
+                it->second->serverUri = serverUri;
+            }
+
+            it->second->ranks.push_back(ranks[i]);
+            it->second->request.targets.push_back(
+                    TranslateBrowsePathsToNodeIdsRequestTarget(browsePath));
+        }
+
+        // if nothing else is going on, we might as well translate a single hop ourselves
+        bool executeInline = (noOfPending == 0 && hops.size() == 1);
+
+        for (map<string, TranslationHop*>::iterator it = hops.begin(); it != hops.end(); ++it)
+        {
+            logger_->debug("Translating %d browse paths starting in server %s",
+                           it->second->ranks.size(), it->first.c_str());
+
+            countTranslation(it->second->request.targets.size());
+
+            TranslationJob* job = new TranslationJob(sessionFactory_, it->second, &finishedHops);
+            noOfPending++;
+
+            if (executeInline)
+            {
+                job->execute();
+                delete job;
+            }
+            else
+            {
+                translationPool_->post(job, database_->clientSettings.parallelInvocationMaxThreads);
+            }
+        }
+    }
+
+
+    // Resolve browse paths per server concurrently, pipelining the out-of-server references
+    //==============================================================================================
+    Status Resolver::resolveBrowsePathsPipelined(
+            vector<BrowsePath>&       browsePaths,
+            Mask&                     mask,
+            vector<ExpandedNodeId>&   results,
+            vector<Status>&           statuses)
+    {
+        logger_->debug("Resolving %d browse paths, per server concurrently", mask.setCount());
+
+        // declare the return status
+        Status ret = statuscodes::Good;
+
+        FinishedHops finishedHops;
+        size_t noOfPending = 0;
+
+        // start the first hops
+        vector<size_t> ranks;
+        for (size_t i = 0; i < browsePaths.size(); i++)
+        {
+            if (mask.isSet(i))
+                ranks.push_back(i);
+        }
+        startTranslationHops(browsePaths, ranks, finishedHops, noOfPending);
+
+        // process the hops in the order in which they finish
+        while (noOfPending > 0)
+        {
+            finishedHops.semaphore.wait();
+
+            finishedHops.mutex.lock();
+            TranslationHop* hop = finishedHops.hops.front();
+            finishedHops.hops.pop_front();
+            finishedHops.mutex.unlock();
+
+            noOfPending--;
+
+            vector<size_t> nextRanks;
+
+            for (size_t i = 0; i < hop->ranks.size(); i++)
+            {
+                size_t rank = hop->ranks[i];
+
+                if (hop->status.isGood())
+                {
+                    processBrowsePathsResolutionResultTarget(
+                            hop->result.targets[i], rank, browsePaths, mask, results, statuses);
+
+                    // if the browse path is still set, it continues in another server
+                    if (mask.isSet(rank))
+                        nextRanks.push_back(rank);
+                }
+                else
+                {
+                    statuses[rank] = hop->status;
+                    mask.unset(rank);
+                }
+            }
+
+            if (hop->status.isNotGood())
+            {
+                logger_->error("The browse paths starting in server %s could not be translated",
+                               hop->serverUri.c_str());
+                logger_->error(hop->status);
+
+                // report the first error, but continue with the other servers
+                if (ret.isGood())
+                    ret = hop->status;
+            }
+
+            delete hop;
+
+            // pipeline the next hops, without waiting for the other servers
+            if (!nextRanks.empty())
+                startTranslationHops(browsePaths, nextRanks, finishedHops, noOfPending);
+        }
+
+        return ret;
+    }
+
+
+
+    // Check if a status means that a browse path did not match any node
+    //==============================================================================================
+    static bool isNoMatchError(const Status& status)
+    {
+        return status.statusCode == statuscodes::ServerCouldNotTranslateBrowsePathsToNodeIdsError
+            && status.raisedBy_ServerCouldNotTranslateBrowsePathsToNodeIdsError.sdkStatus.statusCode
+                   == OpcUa_BadNoMatch;
+    }
+
+
+    // Resolve browse paths via a prefix tree, translating their common prefixes only once
+    //==============================================================================================
+    Status Resolver::resolveBrowsePathsSharedPrefixes(
+            vector<BrowsePath>&       browsePaths,
+            Mask&                     mask,
+            vector<ExpandedNodeId>&   results,
+            vector<Status>&           statuses)
+    {
+        // declare the number of browse paths to resolve
+        size_t noOfMasked = mask.setCount();
+
+        logger_->debug("Resolving %d browse paths via their shared prefixes", noOfMasked);
+
+        // declare the return status
+        Status ret(statuscodes::Good);
+
+        // declare the number of browsePaths
+        size_t noOfBrowsePaths = browsePaths.size();
+
+        // resize the output arguments
+        results.resize(noOfBrowsePaths);
+        statuses.resize(noOfBrowsePaths);
+
+        if (mask.size() != noOfBrowsePaths)
+            return UnexpectedError("Mask does not have the correct size!");
+
+        // 1) build the prefix tree: one root per starting node, one node per distinct prefix
+        //    (a parent is always stored before its children)
+        vector<PrefixNode>              nodes;
+        map<ExpandedNodeId, size_t>     roots;
+        vector<size_t>                  ends(noOfBrowsePaths, 0);
+
+        for (size_t i = 0; i < noOfBrowsePaths; i++)
+        {
+            if (!mask.isSet(i))
+                continue;
+
+            map<ExpandedNodeId, size_t>::iterator rootIter
+                = roots.find(browsePaths[i].startingExpandedNodeId);
+
+            size_t current;
+            if (rootIter == roots.end())
+            {
+                current = nodes.size();
+                roots[browsePaths[i].startingExpandedNodeId] = current;
+                nodes.push_back(PrefixNode());
+                nodes[current].parent         = current;
+                nodes[current].isResolved     = true;
+                nodes[current].expandedNodeId = browsePaths[i].startingExpandedNodeId;
+                nodes[current].status         = statuscodes::Good;
+            }
+            else
+            {
+                current = rootIter->second;
+            }
+
+            const vector<RelativePathElement>& elements = browsePaths[i].relativePath;
+            for (size_t j = 0; j < elements.size(); j++)
+            {
+                map<RelativePathElement, size_t>::iterator childIter
+                    = nodes[current].children.find(elements[j]);
+
+                if (childIter == nodes[current].children.end())
+                {
+                    size_t child = nodes.size();
+                    nodes[current].children[elements[j]] = child;
+                    nodes.push_back(PrefixNode());
+                    nodes[child].parent  = current;
+                    nodes[child].element = elements[j];
+                    current = child;
+                }
+                else
+                {
+                    current = childIter->second;
+                }
+            }
+
+            nodes[current].isEnd = true;
+            ends[i] = current;
+        }
+
+        // 2) only the nodes where a browse path ends or branches off need to be translated,
+        //    starting from the closest such ancestor (the "anchor")
+        size_t noOfNodes = nodes.size();
+        vector<size_t> anchors(noOfNodes);
+        vector<bool>   isStop(noOfNodes, false);
+
+        for (size_t n = 0; n < noOfNodes; n++)
+        {
+            const PrefixNode& node = nodes[n];
+            isStop[n] = (node.parent == n) || node.isEnd || node.children.size() > 1;
+
+            if (node.parent != n)
+                anchors[n] = isStop[node.parent] ? node.parent : anchors[node.parent];
+            else
+                anchors[n] = n;
+        }
+
+        // get the relative path from the root to a node, or from its anchor to the node
+        vector< vector<RelativePathElement> > prefixes(noOfNodes);
+        vector< vector<RelativePathElement> > segments(noOfNodes);
+        vector<size_t>                        rootOf(noOfNodes);
+
+        for (size_t n = 0; n < noOfNodes; n++)
+        {
+            const PrefixNode& node = nodes[n];
+
+            if (node.parent == n)
+            {
+                rootOf[n] = n;
+            }
+            else
+            {
+                rootOf[n]   = rootOf[node.parent];
+                prefixes[n] = prefixes[node.parent];
+                prefixes[n].push_back(node.element);
+
+                if (!isStop[node.parent])
+                    segments[n] = segments[node.parent];
+                segments[n].push_back(node.element);
+            }
+        }
+
+        // the intermediate nodes where the paths branch off are cached with the resolved
+        // starting node as their starting address
+        vector<Address> prefixAddresses;
+        vector<size_t>  prefixNodes;
+
+        for (size_t n = 0; n < noOfNodes; n++)
+        {
+            if (isStop[n] && nodes[n].parent != n && !nodes[n].isEnd)
+            {
+                Address startingAddress(nodes[rootOf[n]].expandedNodeId);
+                prefixAddresses.push_back(Address(&startingAddress, prefixes[n]));
+                prefixNodes.push_back(n);
+            }
+        }
+
+        // 3) use the prefixes that were already cached
+        if (!prefixAddresses.empty())
+        {
+            vector<ExpandedNodeId> cachedExpandedNodeIds;
+            Mask cachedMask;
+            database_->addressCache.find(prefixAddresses, cachedExpandedNodeIds, cachedMask);
+
+            for (size_t k = 0; k < prefixNodes.size(); k++)
+            {
+                if (cachedMask.isSet(k))
+                {
+                    nodes[prefixNodes[k]].isResolved     = true;
+                    nodes[prefixNodes[k]].expandedNodeId = cachedExpandedNodeIds[k];
+                    nodes[prefixNodes[k]].status         = statuscodes::Good;
+                }
+            }
+
+            logger_->debug("%d of the %d shared prefixes were cached",
+                           cachedMask.setCount(), prefixNodes.size());
+        }
+
+        // 4) translate the segments of which the anchor has been resolved, level by level
+        bool pending = true;
+
+        while (pending && ret.isGood())
+        {
+            vector<BrowsePath> segmentBrowsePaths;
+            vector<size_t>     segmentNodes;
+
+            for (size_t n = 0; n < noOfNodes; n++)
+            {
+                PrefixNode& node = nodes[n];
+                const PrefixNode& anchor = nodes[anchors[n]];
+
+                if (!isStop[n] || node.isResolved || !anchor.isResolved)
+                    continue;
+
+                if (anchor.status.isGood())
+                {
+                    segmentBrowsePaths.push_back(BrowsePath(anchor.expandedNodeId, segments[n]));
+                    segmentNodes.push_back(n);
+                }
+                else
+                {
+                    // the nodes below a node that could not be resolved, can't be resolved either
+                    // (unless the full path is unique, see below)
+                    node.isResolved = true;
+                    node.status     = anchor.status;
+                    node.failedAt   = anchor.failedAt;
+                }
+            }
+
+            pending = !segmentNodes.empty();
+
+            if (pending)
+            {
+                logger_->debug("Translating %d segments of the shared prefixes",
+                               segmentNodes.size());
+
+                size_t noOfSegments = segmentNodes.size();
+                Mask                   segmentMask(noOfSegments, true);
+                vector<ExpandedNodeId> segmentResults(noOfSegments);
+                vector<Status>         segmentStatuses(noOfSegments, Status(statuscodes::Good));
+
+                ret = resolveBrowsePaths(segmentBrowsePaths,
+                                         segmentMask,
+                                         segmentResults,
+                                         segmentStatuses);
+
+                for (size_t k = 0; k < noOfSegments && ret.isGood(); k++)
+                {
+                    PrefixNode& node = nodes[segmentNodes[k]];
+                    node.isResolved     = true;
+                    node.expandedNodeId = segmentResults[k];
+                    node.status         = segmentStatuses[k];
+                    node.failedAt       = segmentNodes[k];
+                }
+            }
+        }
+
+        // 5) cache the newly resolved intermediate nodes, and update the results
+        if (ret.isGood())
+        {
+            for (size_t k = 0; k < prefixNodes.size(); k++)
+            {
+                if (nodes[prefixNodes[k]].status.isGood())
+                    database_->addressCache.add(prefixAddresses[k],
+                                                nodes[prefixNodes[k]].expandedNodeId);
+            }
+
+            // if a shared prefix could not be resolved because it matched several nodes (or
+            // because of any other reason than not matching any node), the full paths below it
+            // may still match a single node, so they are resolved without sharing their prefix
+            Mask fullPathMask(noOfBrowsePaths, false);
+
+            for (size_t i = 0; i < noOfBrowsePaths; i++)
+            {
+                if (mask.isSet(i))
+                {
+                    const PrefixNode& end = nodes[ends[i]];
+
+                    if (end.status.isNotGood()
+                            && end.failedAt != ends[i]
+                            && !isNoMatchError(end.status))
+                    {
+                        fullPathMask.set(i);
+                        continue;
+                    }
+
+                    results[i]  = end.expandedNodeId;
+                    statuses[i] = end.status;
+                    mask.unset(i);
+                }
+            }
+
+            if (fullPathMask.setCount() > 0)
+            {
+                logger_->debug("%d browse paths are resolved via their full path, since their "
+                               "shared prefix could not be resolved", fullPathMask.setCount());
+
+                // (the masked browse paths are all resolved, unless ret is not Good)
+                ret = resolveBrowsePaths(browsePaths, fullPathMask, results, statuses);
+
+                for (size_t i = 0; i < noOfBrowsePaths && ret.isGood(); i++)
+                    mask.unset(i);
+            }
+
+            logger_->debug("%d browse paths were resolved via %d distinct prefixes",
+                           noOfMasked, noOfNodes);
+        }
+
+        return ret;
+    }
+
+
+
     void Resolver::processBrowsePathsResolutionResultTarget(
             const TranslateBrowsePathsToNodeIdsResultTarget&    target,
             size_t                                              rank,
@@ -431,10 +970,10 @@ namespace uaf
                 {
                     // update the result and status
                     results[rank]  = target.expandedNodeIds[0];
-                    statuses[rank] = statuses[0];
+                    statuses[rank] = target.status;
 
                     logger_->debug("Target %d was successfully resolved to:", rank);
-                    logger_->debug(results[rank].toString());
+                    UAF_LOG_DEBUG(logger_, (results[rank].toString()));
 
                     // we're finished with this target, so unset the mask item
                     mask.unset(rank);
@@ -475,7 +1014,7 @@ namespace uaf
                         // set the new browse path based on the just created elements
                         browsePaths[rank] = BrowsePath(target.expandedNodeIds[0], newElements);
 
-                        logger_->debug("New browse path: %s", browsePaths[rank].toString().c_str());
+                        UAF_LOG_DEBUG(logger_, ("New browse path: %s", browsePaths[rank].toString().c_str()));
 
                         // we're not finished with this target, so leave the mask item 'set'
                     }
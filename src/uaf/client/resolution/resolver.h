@@ -23,6 +23,7 @@
 
 
 // STD
+#include <deque>
 #include <vector>
 #include <string>
 #include <map>
@@ -38,6 +39,7 @@
 #include "uaf/client/sessions/sessionfactory.h"
 #include "uaf/client/database/database.h"
 #include "uaf/client/requests/requests.h"
+#include "uaf/client/resolution/resolutionstatistics.h"
 
 
 namespace uaf
@@ -50,6 +52,16 @@ namespace uaf
     * The uaf::Resolver uses the TranslateBrowsePathsToNodeIds service to resolve the relative
     * addresses, and uses the uaf::AddressCache to cache the resolution results.
     *
+    * If ClientSettings::sharedPrefixResolutionEnable is true, the relative paths are first
+    * stored in a prefix tree, so that the common prefixes of the relative paths (and therefore
+    * the nodes where the paths branch off) are translated and cached only once. The remaining
+    * parts of the paths are then translated starting from these intermediate nodes.
+    *
+    * If ClientSettings::parallelResolutionEnable is true, the browse paths are translated by
+    * the different servers concurrently (by the worker threads of a resolver-owned
+    * uaf::InvocationPool), and each out-of-server remainder is sent to the next server as soon
+    * as the partial result is received.
+    *
     * @ingroup ClientResolution
     ***********************************************************************************************/
     class UAF_EXPORT Resolver
@@ -76,6 +88,22 @@ namespace uaf
         virtual ~Resolver();
 
 
+        /**
+         * Get the statistics of the resolver.
+         *
+         * @return The current statistics.
+         */
+        uaf::ResolutionStatistics statistics();
+
+
+        /**
+         * Count the addresses that were loaded into the address cache from a file.
+         *
+         * @param noOfAddresses The number of loaded addresses.
+         */
+        void countLoadedAddresses(std::size_t noOfAddresses);
+
+
         /**
          * Resolve an address.
          *
@@ -175,6 +203,66 @@ namespace uaf
         DISALLOW_COPY_AND_ASSIGN(Resolver);
 
 
+        /** A node of the prefix tree of browse paths (see resolveBrowsePathsSharedPrefixes()). */
+        struct PrefixNode
+        {
+            PrefixNode() : parent(0), isEnd(false), isResolved(false), failedAt(0) {}
+
+            /** The index of the parent node (a root node is its own parent). */
+            std::size_t parent;
+            /** The element of the relative path that leads from the parent to this node. */
+            uaf::RelativePathElement element;
+            /** The indexes of the child nodes, by their element. */
+            std::map<uaf::RelativePathElement, std::size_t> children;
+            /** True if a browse path ends at this node. */
+            bool isEnd;
+            /** True if the node has been resolved (successfully or not). */
+            bool isResolved;
+            /** The resolved node (if isResolved and status is Good). */
+            uaf::ExpandedNodeId expandedNodeId;
+            /** The resolution status (if isResolved). */
+            uaf::Status status;
+            /** The index of the node that could not be resolved (if isResolved and status is
+             *  not Good): either this node, or the ancestor from which the status was copied. */
+            std::size_t failedAt;
+        };
+
+
+        /** The translation of the browse paths that start in the same server
+         *  (see resolveBrowsePathsPipelined()). */
+        struct TranslationHop
+        {
+            /** The server that translates the browse paths. */
+            std::string serverUri;
+            /** The order numbers of the translated browse paths. */
+            std::vector<std::size_t> ranks;
+            /** The request, with one target per rank. */
+            uaf::TranslateBrowsePathsToNodeIdsRequest request;
+            /** The result of the request. */
+            uaf::TranslateBrowsePathsToNodeIdsResult result;
+            /** The status of the invocation of the request. */
+            uaf::Status status;
+        };
+
+
+        /** The translation hops that have been executed, in the order in which they finished. */
+        struct FinishedHops
+        {
+            FinishedHops() : semaphore(0) {}
+
+            /** The finished hops (owned by the resolving thread). */
+            std::deque<TranslationHop*> hops;
+            /** The mutex that protects the hops. */
+            UaMutex mutex;
+            /** The semaphore that is posted once for every finished hop. */
+            UaSemaphore semaphore;
+        };
+
+
+        /** Job that executes a single translation hop on a worker thread. */
+        class TranslationJob;
+
+
         /**
          * Resolve an address by only checking the cache.
          *
@@ -272,6 +360,70 @@ namespace uaf
                 std::vector<uaf::Status>&           statuses);
 
 
+        /**
+         * Resolve BrowsePaths by translating them per server concurrently, and by translating
+         * the out-of-server remainders as soon as the partial results of a server arrive.
+         *
+         * @param browsePaths   The browse paths of which those indicated by the mask, will
+         *                      be resolved.
+         * @param mask          The mask that indicates the browse paths that will be resolved.
+         * @param results       The resulting ExpandedNodeIds.
+         * @param statuses      The resulting resolution statuses.
+         * @return              Good if there were no errors on the client side (e.g. malformed
+         *                      addresses), Bad otherwise.
+         */
+        uaf::Status resolveBrowsePathsPipelined(
+                std::vector<uaf::BrowsePath>&       browsePaths,
+                uaf::Mask&                          mask,
+                std::vector<uaf::ExpandedNodeId>&   results,
+                std::vector<uaf::Status>&           statuses);
+
+
+        /**
+         * Count a TranslateBrowsePathsToNodeIds request that is sent to a server.
+         *
+         * @param noOfBrowsePaths   The number of browse paths of the request.
+         */
+        void countTranslation(std::size_t noOfBrowsePaths);
+
+
+        /**
+         * Start the translation hops for the indicated browse paths: one hop per starting server.
+         *
+         * If no other hops are pending and only one hop is needed, the hop is executed by the
+         * calling thread. Otherwise the hops are posted to the worker threads.
+         *
+         * @param browsePaths   The browse paths that are being resolved.
+         * @param ranks         The order numbers of the browse paths to translate.
+         * @param finishedHops  The queue to which the hops are added when they are finished.
+         * @param noOfPending   In-out parameter: the number of hops that are not finished yet.
+         */
+        void startTranslationHops(
+                const std::vector<uaf::BrowsePath>& browsePaths,
+                const std::vector<std::size_t>&     ranks,
+                FinishedHops&                       finishedHops,
+                std::size_t&                        noOfPending);
+
+
+        /**
+         * Resolve BrowsePaths via a prefix tree, so that their common prefixes are only
+         * translated (and cached) once.
+         *
+         * @param browsePaths   The browse paths of which those indicated by the mask, will
+         *                      be resolved.
+         * @param mask          The mask that indicates the browse paths that will be resolved.
+         * @param results       The resulting ExpandedNodeIds.
+         * @param statuses      The resulting resolution statuses.
+         * @return              Good if there were no errors on the client side (e.g. malformed
+         *                      addresses), Bad otherwise.
+         */
+        uaf::Status resolveBrowsePathsSharedPrefixes(
+                std::vector<uaf::BrowsePath>&       browsePaths,
+                uaf::Mask&                          mask,
+                std::vector<uaf::ExpandedNodeId>&   results,
+                std::vector<uaf::Status>&           statuses);
+
+
         /**
          * Process the result of a browse path translation result, to see if the resolution was
          * OK, or whether the translation was not completed and additional translations are needed.
@@ -423,6 +575,11 @@ namespace uaf
         uaf::SessionFactory* sessionFactory_; // not owned!
         // pointer to the shared database
         uaf::Database* database_; // not owned!
+        // the worker threads that translate the browse paths of different servers concurrently
+        uaf::InvocationPool* translationPool_;
+        // the statistics of the resolver, and the mutex that protects them
+        uaf::ResolutionStatistics statistics_;
+        UaMutex statisticsMutex_;
 
     };
 
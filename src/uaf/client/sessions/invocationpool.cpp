@@ -0,0 +1,196 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/client/sessions/invocationpool.h"
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::vector;
+    using std::size_t;
+
+
+    // Constructor
+    // =============================================================================================
+    InvocationPool::InvocationPool(LoggerFactory* loggerFactory)
+    : queueSemaphore_(0)
+    {
+        logger_ = new Logger(loggerFactory, "InvocationPool");
+        logger_->debug("The invocation pool has been constructed");
+    }
+
+
+    // Destructor
+    // =============================================================================================
+    InvocationPool::~InvocationPool()
+    {
+        UaMutexLocker workersLocker(&workersMutex_); // unlocks when locker goes out of scope
+
+        logger_->debug("Stopping %d worker threads", workers_.size());
+
+        // an entry without a job tells a worker to stop
+        queueMutex_.lock();
+        for (size_t i = 0; i < workers_.size(); i++)
+            queue_.push_back(Entry());
+        queueMutex_.unlock();
+        queueSemaphore_.post(workers_.size());
+
+        for (size_t i = 0; i < workers_.size(); i++)
+        {
+            workers_[i]->wait();
+            delete workers_[i];
+        }
+        workers_.clear();
+
+        delete logger_;
+        logger_ = 0;
+    }
+
+
+    // Get the number of workers
+    // =============================================================================================
+    size_t InvocationPool::noOfWorkers()
+    {
+        UaMutexLocker locker(&workersMutex_); // unlocks when locker goes out of scope
+        return workers_.size();
+    }
+
+
+    // Start worker threads if needed
+    // =============================================================================================
+    void InvocationPool::startWorkers(size_t noOfWorkers)
+    {
+        UaMutexLocker locker(&workersMutex_); // unlocks when locker goes out of scope
+
+        while (workers_.size() < noOfWorkers)
+        {
+            Worker* worker = new Worker(this);
+            worker->start();
+            workers_.push_back(worker);
+            logger_->debug("Worker thread %d has been started", workers_.size());
+        }
+    }
+
+
+    // Take an entry from the queue
+    // =============================================================================================
+    InvocationPool::Entry InvocationPool::takeEntry()
+    {
+        queueSemaphore_.wait();
+
+        UaMutexLocker locker(&queueMutex_); // unlocks when locker goes out of scope
+        Entry entry = queue_.front();
+        queue_.pop_front();
+        return entry;
+    }
+
+
+    // Execute the given jobs
+    // =============================================================================================
+    void InvocationPool::executeAll(const vector<InvocationJob*>& jobs, uint32_t maxThreads)
+    {
+        if (jobs.size() == 0)
+            return;
+
+        if (jobs.size() == 1 || maxThreads == 0)
+        {
+            for (size_t i = 0; i < jobs.size(); i++)
+                jobs[i]->execute();
+            return;
+        }
+
+        // the first job will be executed by the calling thread, so we don't need a worker for it
+        size_t noOfQueuedJobs = jobs.size() - 1;
+        startWorkers(noOfQueuedJobs < maxThreads ? noOfQueuedJobs : maxThreads);
+
+        Batch batch;
+
+        queueMutex_.lock();
+        for (size_t i = 1; i < jobs.size(); i++)
+        {
+            Entry entry;
+            entry.job   = jobs[i];
+            entry.batch = &batch;
+            queue_.push_back(entry);
+        }
+        queueMutex_.unlock();
+        queueSemaphore_.post(noOfQueuedJobs);
+
+        logger_->debug("%d jobs have been queued for the worker threads", noOfQueuedJobs);
+
+        jobs[0]->execute();
+
+        for (size_t i = 0; i < noOfQueuedJobs; i++)
+            batch.finished.wait();
+    }
+
+
+    // Post a single job
+    // =============================================================================================
+    void InvocationPool::post(InvocationJob* job, uint32_t maxThreads)
+    {
+        if (maxThreads == 0)
+            maxThreads = 1;
+
+        size_t noOfQueuedJobs;
+
+        Entry entry;
+        entry.job = job;
+
+        queueMutex_.lock();
+        queue_.push_back(entry);
+        noOfQueuedJobs = queue_.size();
+        queueMutex_.unlock();
+
+        startWorkers(noOfQueuedJobs < maxThreads ? noOfQueuedJobs : maxThreads);
+
+        queueSemaphore_.post(1);
+    }
+
+
+    // Run a worker thread
+    // =============================================================================================
+    void InvocationPool::Worker::run()
+    {
+        bool stop = false;
+
+        while (!stop)
+        {
+            Entry entry = pool_->takeEntry();
+
+            if (entry.job == 0)
+            {
+                stop = true;
+            }
+            else
+            {
+                entry.job->execute();
+
+                if (entry.batch == 0)
+                    delete entry.job;
+                else
+                    entry.batch->finished.post(1);
+            }
+        }
+    }
+
+
+}
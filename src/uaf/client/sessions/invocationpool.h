@@ -0,0 +1,180 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_INVOCATIONPOOL_H_
+#define UAF_INVOCATIONPOOL_H_
+
+
+// STD
+#include <deque>
+#include <vector>
+// SDK
+#include "uabase/uamutex.h"
+#include "uabase/uasemaphore.h"
+#include "uabase/uathread.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/logger.h"
+#include "uaf/client/clientexport.h"
+
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * An uaf::InvocationJob is a unit of work (typically: invoking a service on a single session)
+    * that can be executed by an uaf::InvocationPool.
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    class UAF_EXPORT InvocationJob
+    {
+    public:
+
+        /**
+         * Destruct the job.
+         */
+        virtual ~InvocationJob() {}
+
+        /**
+         * Execute the job. Implementations must not throw, and must store their own result.
+         */
+        virtual void execute() = 0;
+    };
+
+
+
+    /*******************************************************************************************//**
+    * An uaf::InvocationPool executes uaf::InvocationJob instances concurrently on a bounded number
+    * of worker threads.
+    *
+    * The worker threads are started lazily (i.e. only when a batch of jobs really needs them), and
+    * are kept alive until the pool is destroyed.
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    class UAF_EXPORT InvocationPool
+    {
+    public:
+
+
+        /**
+         * Construct an invocation pool.
+         *
+         * @param loggerFactory Logger factory to log all messages to.
+         */
+        InvocationPool(uaf::LoggerFactory* loggerFactory);
+
+
+        /**
+         * Destruct the invocation pool, and stop all worker threads.
+         */
+        virtual ~InvocationPool();
+
+
+        /**
+         * Execute the given jobs and block until all of them have finished.
+         *
+         * The first job is executed by the calling thread, the others are handed over to the
+         * worker threads.
+         *
+         * @param jobs          The jobs to execute (they remain owned by the caller).
+         * @param maxThreads    The maximum number of worker threads that the pool may start.
+         *                      If 0, all jobs are executed sequentially by the calling thread.
+         */
+        void executeAll(const std::vector<uaf::InvocationJob*>& jobs, uint32_t maxThreads);
+
+
+        /**
+         * Hand over a single job to the worker threads, without waiting for it to finish.
+         *
+         * @param job           The job to execute. The pool takes ownership of the job: it is
+         *                      deleted by the worker thread as soon as it has been executed.
+         * @param maxThreads    The maximum number of worker threads that the pool may start
+         *                      (at least one worker thread is started).
+         */
+        void post(uaf::InvocationJob* job, uint32_t maxThreads);
+
+
+        /**
+         * Get the number of worker threads that are currently started.
+         *
+         * @return The number of worker threads.
+         */
+        std::size_t noOfWorkers();
+
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(InvocationPool);
+
+
+        // a batch of jobs is finished when its semaphore has been posted once for every job
+        struct Batch
+        {
+            Batch() : finished(0) {}
+            UaSemaphore finished;
+        };
+
+        // a job that is queued, together with the batch it belongs to (a posted job doesn't
+        // belong to a batch)
+        struct Entry
+        {
+            Entry() : job(0), batch(0) {}
+            uaf::InvocationJob* job;
+            Batch*              batch;
+        };
+
+        // a worker thread takes entries from the queue until it finds an entry without a job
+        class Worker : public UaThread
+        {
+        public:
+            Worker(InvocationPool* pool) : pool_(pool) {}
+            void run();
+        private:
+            InvocationPool* pool_;
+        };
+
+        // start worker threads until there are at least the given number of them
+        void startWorkers(std::size_t noOfWorkers);
+
+        // block until an entry can be taken from the queue
+        Entry takeEntry();
+
+
+        // logger of the invocation pool
+        uaf::Logger*        logger_;
+
+        // the queue of pending jobs, and the semaphore that counts them
+        std::deque<Entry>   queue_;
+        UaMutex             queueMutex_;
+        UaSemaphore         queueSemaphore_;
+
+        // the worker threads
+        std::vector<Worker*> workers_;
+        UaMutex              workersMutex_;
+    };
+
+
+}
+
+
+#endif /* UAF_INVOCATIONPOOL_H_ */
@@ -0,0 +1,119 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_OPERATIONLIMITS_H_
+#define UAF_OPERATIONLIMITS_H_
+
+
+// STD
+#include <string>
+#include <sstream>
+// SDK
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/stringifiable.h"
+#include "uaf/client/clientexport.h"
+#include "uaf/client/clientservices.h"
+
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * An uaf::OperationLimits object holds the OperationLimits that a server exposes in its
+    * ServerCapabilities, i.e. the maximum number of nodes that it accepts in a single service call.
+    *
+    * A limit of 0 means that the server did not specify a limit (or that it could not be read).
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    class UAF_EXPORT OperationLimits
+    {
+    public:
+
+
+        /**
+         * Create an OperationLimits object without any limits.
+         */
+        OperationLimits();
+
+
+        /** The maximum number of nodes per Read service call. */
+        uint32_t maxNodesPerRead;
+
+        /** The maximum number of nodes per Write service call. */
+        uint32_t maxNodesPerWrite;
+
+        /** The maximum number of nodes per Call service call. */
+        uint32_t maxNodesPerMethodCall;
+
+        /** The maximum number of nodes per Browse service call. */
+        uint32_t maxNodesPerBrowse;
+
+        /** The maximum number of nodes per TranslateBrowsePathsToNodeIds service call. */
+        uint32_t maxNodesPerTranslateBrowsePathsToNodeIds;
+
+        /** The maximum number of nodes per HistoryRead service call (for raw/modified data). */
+        uint32_t maxNodesPerHistoryReadData;
+
+
+        /**
+         * Get the maximum number of targets that a single invocation of the given service may
+         * contain.
+         *
+         * @return The maximum number of targets, or 0 if there is no limit.
+         */
+        template<typename _Service>
+        uint32_t maxTargets() const { return 0; }
+
+
+        /**
+         * Get a string representation of the limits.
+         */
+        std::string toString(const std::string& indent="", std::size_t colon=45) const;
+    };
+
+
+    // the services for which the server may specify a limit
+    template<> inline uint32_t OperationLimits::maxTargets<uaf::ReadService>() const
+    { return maxNodesPerRead; }
+    template<> inline uint32_t OperationLimits::maxTargets<uaf::AsyncReadService>() const
+    { return maxNodesPerRead; }
+    template<> inline uint32_t OperationLimits::maxTargets<uaf::WriteService>() const
+    { return maxNodesPerWrite; }
+    template<> inline uint32_t OperationLimits::maxTargets<uaf::AsyncWriteService>() const
+    { return maxNodesPerWrite; }
+    template<> inline uint32_t OperationLimits::maxTargets<uaf::MethodCallService>() const
+    { return maxNodesPerMethodCall; }
+    template<> inline uint32_t OperationLimits::maxTargets<uaf::BrowseService>() const
+    { return maxNodesPerBrowse; }
+    template<> inline uint32_t OperationLimits::maxTargets<
+            uaf::TranslateBrowsePathsToNodeIdsService>() const
+    { return maxNodesPerTranslateBrowsePathsToNodeIds; }
+    template<> inline uint32_t OperationLimits::maxTargets<
+            uaf::HistoryReadRawModifiedService>() const
+    { return maxNodesPerHistoryReadData; }
+
+}
+
+
+#endif /* UAF_OPERATIONLIMITS_H_ */
@@ -0,0 +1,62 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_PREPAREDINVOCATION_H_
+#define UAF_PREPAREDINVOCATION_H_
+
+// STD
+// SDK
+// UAF
+#include "uaf/util/handles.h"
+#include "uaf/client/clientexport.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * An uaf::PreparedInvocation is an invocation that is built once (by
+    * uaf::SessionFactory::prepareRequest()), so that it can be invoked many times (by
+    * uaf::SessionFactory::invokePreparedRequest()) without being rebuilt.
+    *
+    * The invocation keeps its SDK request data between the invocations, as long as the session
+    * keeps the same connection revision.
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    template<typename _Service>
+    struct PreparedInvocation
+    {
+        /** The id of the session to invoke the invocation on. */
+        uaf::ClientConnectionId             clientConnectionId;
+
+        /** The connection revision of the session at the time the invocation was prepared. */
+        uint32_t                            connectionRevision;
+
+        /** The invocation (to be deleted by the owner of the prepared invocation). */
+        typename _Service::Invocation*      invocation;
+    };
+
+
+}
+
+
+#endif /* UAF_PREPAREDINVOCATION_H_ */
@@ -0,0 +1,316 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/client/sessions/registerednodes.h"
+
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::vector;
+
+
+    // Constructor
+    // =============================================================================================
+    RegisteredNodes::RegisteredNodes()
+    : noOfRegisteredNodes_(0),
+      noOfHits_(0),
+      generation_(0)
+    {}
+
+
+    // Find the entry of a node
+    // =============================================================================================
+    RegisteredNodes::Entries::iterator RegisteredNodes::findEntry(
+            const NodeId&   nodeId,
+            uint32_t        hash)
+    {
+        std::pair<Entries::iterator, Entries::iterator> range = entries_.equal_range(hash);
+
+        for (Entries::iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second.nodeId == nodeId)
+                return it;
+        }
+
+        return entries_.end();
+    }
+
+
+    // Mark an entry as hot
+    // =============================================================================================
+    void RegisteredNodes::makeHot(Entry& entry)
+    {
+        if (!entry.hot)
+        {
+            accessOrder_.erase(entry.accessOrderIter);
+            hotNodeIds_.push_back(entry.nodeId);
+            entry.hot = true;
+        }
+    }
+
+
+    // Check if an entry is in the access order
+    // =============================================================================================
+    bool RegisteredNodes::isEvictable(const Entry& entry)
+    {
+        return (entry.state == Counting && !entry.hot) || entry.state == Registered;
+    }
+
+
+    // Count an access and substitute the alias
+    // =============================================================================================
+    bool RegisteredNodes::substitute(
+            const Address&  address,
+            uint32_t        maxNodes,
+            uint32_t        minAccessCount,
+            OpcUa_NodeId&   opcUaNodeId)
+    {
+        if (!address.isExpandedNodeId())
+            return false;
+
+        NodeId nodeId = address.getExpandedNodeId().nodeId();
+        uint32_t hash = nodeId.hash();
+
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+
+        Entries::iterator it = findEntry(nodeId, hash);
+
+        if (it == entries_.end())
+        {
+            // make room by forgetting the nodes that were accessed the longest time ago
+            // (the hot nodes and the nodes being registered are kept), and remember the aliases
+            // of the registered ones so that they can be unregistered
+            while (entries_.size() >= maxNodes && !accessOrder_.empty())
+            {
+                const NodeId& coldNodeId = accessOrder_.front();
+                Entries::iterator coldIter = findEntry(coldNodeId, coldNodeId.hash());
+
+                if (coldIter->second.state == Registered)
+                {
+                    evictedAliases_.push_back(coldIter->second.alias);
+                    noOfRegisteredNodes_--;
+                }
+
+                entries_.erase(coldIter);
+                accessOrder_.pop_front();
+            }
+
+            // don't keep track of more nodes than allowed
+            if (entries_.size() >= maxNodes)
+                return false;
+
+            Entry entry;
+            entry.nodeId          = nodeId;
+            entry.accessOrderIter = accessOrder_.insert(accessOrder_.end(), nodeId);
+            it = entries_.insert(std::make_pair(hash, entry));
+        }
+        else if (isEvictable(it->second))
+        {
+            // the node is now the most recently accessed one
+            accessOrder_.splice(accessOrder_.end(), accessOrder_, it->second.accessOrderIter);
+        }
+
+        Entry& entry = it->second;
+
+        // only the accesses of nodes that may still be registered need to be counted
+        if (entry.state == Counting)
+        {
+            entry.accessCount++;
+
+            if (entry.accessCount >= minAccessCount)
+                makeHot(entry);
+        }
+
+        if (entry.state != Registered)
+            return false;
+
+        OpcUa_NodeId_Clear(&opcUaNodeId);
+        entry.alias.copyTo(&opcUaNodeId);
+        noOfHits_++;
+        return true;
+    }
+
+
+    // Get the nodes to register
+    // =============================================================================================
+    uint32_t RegisteredNodes::startRegistration(vector<NodeId>& nodeIds)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+
+        // only the nodes that have become hot need to be visited
+        for (vector<NodeId>::const_iterator nodeIdIter = hotNodeIds_.begin();
+             nodeIdIter != hotNodeIds_.end();
+             ++nodeIdIter)
+        {
+            Entries::iterator it = findEntry(*nodeIdIter, nodeIdIter->hash());
+
+            if (it != entries_.end() && it->second.state == Counting)
+            {
+                it->second.state = Registering;
+                it->second.hot   = false;
+                nodeIds.push_back(it->second.nodeId);
+            }
+        }
+
+        hotNodeIds_.clear();
+
+        return generation_;
+    }
+
+
+    // Store the aliases of the registered nodes
+    // =============================================================================================
+    void RegisteredNodes::setRegistered(
+            uint32_t                generation,
+            const vector<NodeId>&   nodeIds,
+            const UaNodeIdArray&    aliases)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+
+        if (generation != generation_)
+            return;
+
+        for (vector<NodeId>::size_type i = 0; i < nodeIds.size() && i < aliases.length(); i++)
+        {
+            Entries::iterator it = findEntry(nodeIds[i], nodeIds[i].hash());
+
+            if (it != entries_.end() && it->second.state == Registering)
+            {
+                it->second.alias  = aliases[i];
+                it->second.state  = Registered;
+                it->second.accessOrderIter = accessOrder_.insert(accessOrder_.end(), nodeIds[i]);
+                noOfRegisteredNodes_++;
+            }
+        }
+    }
+
+
+    // Mark the nodes as not registrable
+    // =============================================================================================
+    void RegisteredNodes::setFailed(uint32_t generation, const vector<NodeId>& nodeIds)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+
+        if (generation != generation_)
+            return;
+
+        for (vector<NodeId>::const_iterator nodeIdIter = nodeIds.begin();
+             nodeIdIter != nodeIds.end();
+             ++nodeIdIter)
+        {
+            Entries::iterator it = findEntry(*nodeIdIter, nodeIdIter->hash());
+
+            if (it != entries_.end() && it->second.state == Registering)
+                it->second.state = Failed;
+        }
+    }
+
+
+    // Get the aliases of the evicted nodes
+    // =============================================================================================
+    void RegisteredNodes::takeEvictedAliases(UaNodeIdArray& aliases)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+
+        aliases.create(evictedAliases_.size());
+        for (vector<UaNodeId>::size_type i = 0; i < evictedAliases_.size(); i++)
+            evictedAliases_[i].copyTo(&aliases[i]);
+
+        evictedAliases_.clear();
+    }
+
+
+    // Get the aliases of all registered nodes
+    // =============================================================================================
+    void RegisteredNodes::takeAllAliases(UaNodeIdArray& aliases)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+
+        for (Entries::const_iterator it = entries_.begin(); it != entries_.end(); ++it)
+        {
+            if (it->second.state == Registered)
+                evictedAliases_.push_back(it->second.alias);
+        }
+
+        aliases.create(evictedAliases_.size());
+        for (vector<UaNodeId>::size_type i = 0; i < evictedAliases_.size(); i++)
+            evictedAliases_[i].copyTo(&aliases[i]);
+
+        doReset();
+    }
+
+
+    // Forget all aliases
+    // =============================================================================================
+    void RegisteredNodes::reset()
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+        doReset();
+    }
+
+
+    // Forget all aliases (not locked!)
+    // =============================================================================================
+    void RegisteredNodes::doReset()
+    {
+        // the nodes that were hot remain hot, so they will be registered again (the nodes that
+        // failed as well, since the new session may accept them)
+        for (Entries::iterator it = entries_.begin(); it != entries_.end(); ++it)
+        {
+            if (it->second.state != Counting)
+            {
+                if (it->second.state == Registered)
+                    accessOrder_.erase(it->second.accessOrderIter);
+
+                it->second.state = Counting;
+                it->second.alias.clear();
+                it->second.hot   = true;
+                hotNodeIds_.push_back(it->second.nodeId);
+            }
+        }
+
+        // the aliases of the lost session cannot be unregistered anymore
+        evictedAliases_.clear();
+
+        noOfRegisteredNodes_ = 0;
+        generation_++;
+    }
+
+
+    // Get the number of registered nodes
+    // =============================================================================================
+    uint32_t RegisteredNodes::noOfRegisteredNodes() const
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+        return noOfRegisteredNodes_;
+    }
+
+
+    // Get the number of hits
+    // =============================================================================================
+    uint32_t RegisteredNodes::noOfHits() const
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when out of scope
+        return noOfHits_;
+    }
+
+}
@@ -0,0 +1,239 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_REGISTEREDNODES_H_
+#define UAF_REGISTEREDNODES_H_
+
+
+// STD
+#include <vector>
+#include <map>
+#include <list>
+// SDK
+#include "uabase/uanodeid.h"
+#include "uabase/uaarraytemplates.h"
+#include "uabase/uamutex.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/address.h"
+#include "uaf/util/nodeid.h"
+#include "uaf/client/clientexport.h"
+
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A RegisteredNodes object keeps track of the nodes that are read or written within a session,
+    * and of the aliases that the server returned for the nodes that were registered (by means of
+    * the RegisterNodes service).
+    *
+    * The nodes are counted and substituted by the Read and Write invocations, while the session
+    * takes care of registering the nodes that have been accessed often enough, and of
+    * unregistering the nodes that have been evicted again.
+    * All methods are thread-safe.
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    class UAF_EXPORT RegisteredNodes
+    {
+    public:
+
+
+        /**
+         * Create an empty table of registered nodes.
+         */
+        RegisteredNodes();
+
+
+        /**
+         * Count an access to the node of the given address, and copy the registered alias of the
+         * node (if any) into the given OPC UA NodeId.
+         *
+         * If maxNodes are tracked already, the node that was accessed the longest time ago (and
+         * that is not about to be registered) is forgotten to make room for the new node. If the
+         * forgotten node was registered, its alias is kept until takeEvictedAliases() is called,
+         * so that it can be unregistered.
+         *
+         * @param address           The (resolved) address of the node that is accessed.
+         * @param maxNodes          The maximum number of nodes to keep track of.
+         * @param minAccessCount    The number of accesses that makes a node "hot".
+         * @param opcUaNodeId       The NodeId to be sent to the server, which will be replaced by
+         *                          the alias of the node, if the node is registered.
+         * @return                  True if the alias was used, false if not.
+         */
+        bool substitute(
+                const uaf::Address& address,
+                uint32_t            maxNodes,
+                uint32_t            minAccessCount,
+                OpcUa_NodeId&       opcUaNodeId);
+
+
+        /**
+         * Get the nodes that have become hot (see substitute()), and that have not been
+         * registered yet. The nodes are marked as being registered, so they are not returned
+         * again by subsequent calls.
+         *
+         * @param nodeIds           The nodes that should be registered (output).
+         * @return                  The current generation, to be passed to setRegistered().
+         */
+        uint32_t startRegistration(std::vector<uaf::NodeId>& nodeIds);
+
+
+        /**
+         * Store the aliases that the server returned for the given nodes.
+         *
+         * Aliases of an older generation (i.e. registered before the last reset()) are ignored.
+         *
+         * @param generation    The generation returned by startRegistration().
+         * @param nodeIds       The nodes that were registered.
+         * @param aliases       The aliases that the server returned, in the same order.
+         */
+        void setRegistered(
+                uint32_t                        generation,
+                const std::vector<uaf::NodeId>& nodeIds,
+                const UaNodeIdArray&            aliases);
+
+
+        /**
+         * Mark the given nodes as not registrable, so that no further attempts are made to
+         * register them.
+         *
+         * @param generation    The generation returned by startRegistration().
+         * @param nodeIds       The nodes that could not be registered.
+         */
+        void setFailed(uint32_t generation, const std::vector<uaf::NodeId>& nodeIds);
+
+
+        /**
+         * Get the aliases of the registered nodes that have been evicted (see substitute()) since
+         * the last call, so that they can be unregistered.
+         *
+         * @param aliases   The aliases that should be unregistered (output).
+         */
+        void takeEvictedAliases(UaNodeIdArray& aliases);
+
+
+        /**
+         * Get the aliases of all registered nodes (including the evicted ones), so that they can
+         * be unregistered before the session is disconnected. The aliases are forgotten in the
+         * same way as by reset().
+         *
+         * @param aliases   The aliases that should be unregistered (output).
+         */
+        void takeAllAliases(UaNodeIdArray& aliases);
+
+
+        /**
+         * Forget all aliases (e.g. because the session with the server was lost), while keeping
+         * the access counts so that the hot nodes will be registered again. The nodes that
+         * could not be registered will also be tried again.
+         */
+        void reset();
+
+
+        /**
+         * Get the number of nodes that are currently registered.
+         */
+        uint32_t noOfRegisteredNodes() const;
+
+
+        /**
+         * Get the number of times that an alias was used instead of the original NodeId.
+         */
+        uint32_t noOfHits() const;
+
+
+    private:
+
+
+        DISALLOW_COPY_AND_ASSIGN(RegisteredNodes);
+
+
+        // the registration state of a node
+        enum State
+        {
+            Counting,
+            Registering,
+            Registered,
+            Failed
+        };
+
+        // the nodes that are not hot or being registered, from the least to the most recently
+        // accessed one
+        typedef std::list<uaf::NodeId> AccessOrder;
+
+        // an entry of the table
+        struct Entry
+        {
+            Entry() : state(Counting), accessCount(0), hot(false) {}
+
+            uaf::NodeId             nodeId;
+            UaNodeId                alias;
+            State                   state;
+            uint32_t                accessCount;
+            // true if the node is waiting in hotNodeIds_ (if so, it's not in accessOrder_)
+            bool                    hot;
+            // only valid if the node is in accessOrder_ (see isEvictable())
+            AccessOrder::iterator   accessOrderIter;
+        };
+
+        // entries are stored by the hash of their NodeId
+        typedef std::multimap<uint32_t, Entry> Entries;
+
+
+        // find the entry of a node, or return entries_.end() (not locked!)
+        Entries::iterator findEntry(const uaf::NodeId& nodeId, uint32_t hash);
+
+        // mark a counting entry as hot, so that it will be registered (not locked!)
+        void makeHot(Entry& entry);
+
+        // true if the entry is in accessOrder_, so it may be evicted
+        static bool isEvictable(const Entry& entry);
+
+        // forget all aliases, see reset() (not locked!)
+        void doReset();
+
+
+        // the table of nodes
+        Entries             entries_;
+        // the order in which the nodes that are not hot were accessed (to evict the coldest one)
+        AccessOrder         accessOrder_;
+        // the counting nodes that have become hot since the last startRegistration()
+        std::vector<uaf::NodeId> hotNodeIds_;
+        // the aliases of the registered nodes that were evicted since the last
+        // takeEvictedAliases()
+        std::vector<UaNodeId> evictedAliases_;
+        // the number of registered nodes and the number of times an alias was used
+        uint32_t            noOfRegisteredNodes_;
+        uint32_t            noOfHits_;
+        // incremented by each reset(), to discard the results of outdated registrations
+        uint32_t            generation_;
+        // mutex to protect the members
+        mutable UaMutex     mutex_;
+    };
+
+
+}
+
+
+#endif /* UAF_REGISTEREDNODES_H_ */
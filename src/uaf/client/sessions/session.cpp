@@ -42,11 +42,15 @@ namespace uaf
             Discoverer*                     discoverer,
             Database*                       database)
     : uaSessionCallback_(uaSessionCallback),
+      connectionRevision_(0),
+      structureDefinitionsRevision_(0),
+      structureDefinitionHits_(0),
       sessionState_(uaf::sessionstates::Disconnected),
       lastConnectionAttemptStep_(connectionsteps::NoAttemptYet),
       clientConnectionId_(clientConnectionId),
       serverUri_(serverUri),
       sessionSettings_(sessionSettings),
+      sessionSettingsFingerprint_(sessionSettings.fingerprint()),
       database_(database),
       clientInterface_(clientInterface),
       discoverer_(discoverer)
@@ -433,7 +437,7 @@ namespace uaf
         EndpointDescription     suitableEndpoint;
 
         // get the discovery URL(s) for this server URI
-        ret = discoverer_->getDiscoveryUrls(serverUri_, discoveryUrls);
+        ret = discoverer_->getDiscoveryUrls(serverUri(), discoveryUrls);
 
         // use the discoverer to request the endpoint URLs for the given discovery URL(s)
         for (vector<string>::const_iterator it = discoveryUrls.begin();
@@ -648,6 +652,11 @@ namespace uaf
             logger_->debug("Now disconnecting %s and thereby deleting all subscriptions",
                            toString().c_str());
 
+            // release the aliases of the registered nodes on the server
+            UaNodeIdArray uaRegisteredNodeIds;
+            registeredNodes_.takeAllAliases(uaRegisteredNodeIds);
+            unregisterNodes(uaRegisteredNodeIds);
+
             // try to disconnect (and delete subscriptions)
             UaClientSdk::ServiceSettings serviceSettings;
             UaStatus uaStatus = uaSession_->disconnect(serviceSettings, OpcUa_True);
@@ -683,10 +692,17 @@ namespace uaf
                 clientConnectionId_,
                 sessionState_,
                 uaf::serverstates::fromSdkToUaf(uaSession_->serverState()),
-                serverUri_,
+                serverUri(),
                 sessionSettings_,
                 lastConnectionAttemptStep_,
                 lastConnectionAttemptStatus_);
+        info.registeredNodes    = registeredNodes_.noOfRegisteredNodes();
+        info.registeredNodeHits = registeredNodes_.noOfHits();
+        {
+            UaMutexLocker locker(&structureDefinitionsMutex_); // unlocks when out of scope
+            info.structureDefinitions       = structureDefinitions_.size();
+            info.structureDefinitionHits    = structureDefinitionHits_;
+        }
         logger_->debug("Fetching session information:");
         logger_->debug(info.toString());
         return info;
@@ -765,14 +781,18 @@ namespace uaf
                 else
                 {
                     string thisServerUri;
-                    if (serverArray_.findServerUri(0, thisServerUri) && thisServerUri != serverUri_)
+                    string knownServerUri = serverUri();
+                    if (serverArray_.findServerUri(0, thisServerUri) && thisServerUri != knownServerUri)
                     {
                         // when manually connecting to an endpoint, no server URI is known yet
                         // In this case serverUri_ is an empty string.
-                        if (serverUri_.length() == 0)
+                        if (knownServerUri.length() == 0)
                         {
                             logger_->debug("No serverUri was known for this session,"
                                            "so we can now update it to %s", thisServerUri.c_str());
+
+                            // other threads may read the server URI in the meantime
+                            UaMutexLocker locker(&serverUriMutex_); // unlocks when out of scope
                             serverUri_ = thisServerUri;
                         }
                         else
@@ -780,13 +800,13 @@ namespace uaf
                             logger_->warning("ServerArray[0] is not the same as the server URI "
                                              "that was found during the discovery process:");
                             logger_->warning(" - ServerArray[0]       : %s", thisServerUri.c_str());
-                            logger_->warning(" - discovered serverUri : %s", serverUri_.c_str());
+                            logger_->warning(" - discovered serverUri : %s", knownServerUri.c_str());
                             logger_->warning("This means that the server is not configured "
                                              "correctly");
                             logger_->warning("The UAF will therefore ignore ServerArray[0] and use "
                                              "the server URI that was found during the discovery "
                                              "process instead");
-                            serverArray_.update(0, serverUri_);
+                            serverArray_.update(0, knownServerUri);
                             logger_->debug("ServerArray with modified ServerArray[0]:");
                         }
                     }
@@ -826,12 +846,345 @@ namespace uaf
     }
 
 
+    // Update the operation limits
+    // =============================================================================================
+    void Session::updateOperationLimits()
+    {
+        logger_->debug("Updating the OperationLimits");
+
+        // forget the limits of any previous connection
+        operationLimits_ = OperationLimits();
+
+        if (!isConnected())
+        {
+            logger_->warning("Cannot update the OperationLimits since the session is not "
+                             "connected");
+            return;
+        }
+
+        // the nodes to read, and the limits where they should be stored
+        const OpcUa_UInt32 nodeIds[] = {
+                OpcUaId_Server_ServerCapabilities_OperationLimits_MaxNodesPerRead,
+                OpcUaId_Server_ServerCapabilities_OperationLimits_MaxNodesPerWrite,
+                OpcUaId_Server_ServerCapabilities_OperationLimits_MaxNodesPerMethodCall,
+                OpcUaId_Server_ServerCapabilities_OperationLimits_MaxNodesPerBrowse,
+                OpcUaId_Server_ServerCapabilities_OperationLimits_MaxNodesPerTranslateBrowsePathsToNodeIds,
+                OpcUaId_Server_ServerCapabilities_OperationLimits_MaxNodesPerHistoryReadData };
+        uint32_t* limits[] = {
+                &operationLimits_.maxNodesPerRead,
+                &operationLimits_.maxNodesPerWrite,
+                &operationLimits_.maxNodesPerMethodCall,
+                &operationLimits_.maxNodesPerBrowse,
+                &operationLimits_.maxNodesPerTranslateBrowsePathsToNodeIds,
+                &operationLimits_.maxNodesPerHistoryReadData };
+        const size_t noOfLimits = sizeof(nodeIds) / sizeof(nodeIds[0]);
+
+        UaStatus                        uaReadStatus;
+        UaReadValueIds                  uaReadValueIds;
+        UaDataValues                    uaDataValues;
+        UaDiagnosticInfos               uaDiagnosticInfos;
+        UaClientSdk::ServiceSettings    uaServiceSettings;
+
+        // update the SDK service settings
+        sessionSettings_.readServerInfoSettings.toSdk(uaServiceSettings);
+
+        uaReadValueIds.create(noOfLimits);
+        for (size_t i = 0; i < noOfLimits; i++)
+        {
+            UaNodeId(nodeIds[i]).copyTo(&uaReadValueIds[i].NodeId);
+            uaReadValueIds[i].AttributeId = OpcUa_Attributes_Value;
+        }
+
+        // perform the read action
+        uaReadStatus = uaSession_->read(
+                uaServiceSettings,                  // service settings
+                0,                                  // max age in milliseconds
+                OpcUa_TimestampsToReturn_Neither,   // no time stamps necessary
+                uaReadValueIds,                     // nodes to read
+                uaDataValues,                       // result
+                uaDiagnosticInfos);                 // diagnostics
+
+        if (uaReadStatus.isBad())
+        {
+            logger_->warning("Could not read the OperationLimits: %s",
+                             SdkStatus(uaReadStatus).toString().c_str());
+        }
+        else
+        {
+            // a limit that could not be read (or that is not a valid number) stays 0 (no limit)
+            for (size_t i = 0; i < noOfLimits && i < uaDataValues.length(); i++)
+            {
+                OpcUa_UInt32 limit = 0;
+                if (OpcUa_IsGood(uaDataValues[i].StatusCode)
+                        && OpcUa_IsGood(UaVariant(uaDataValues[i].Value).toUInt32(limit)))
+                    *limits[i] = limit;
+            }
+
+            logger_->debug("OperationLimits:");
+            logger_->debug(operationLimits_.toString());
+        }
+    }
+
+
+    // Collect the subtypes and the continuation points of a Browse or BrowseNext call
+    // =============================================================================================
+    static void collectSubtypes(
+            const UaBrowseResults&  uaBrowseResults,
+            vector<UaNodeId>&       subtypes,
+            UaByteStringArray&      uaContinuationPoints)
+    {
+        uaContinuationPoints.clear();
+
+        for (OpcUa_UInt32 i = 0; i < uaBrowseResults.length(); i++)
+        {
+            if (OpcUa_IsNotGood(uaBrowseResults[i].StatusCode))
+                continue;
+
+            // only the subtypes within the same server are of interest
+            for (OpcUa_Int32 j = 0; j < uaBrowseResults[i].NoOfReferences; j++)
+            {
+                const OpcUa_ExpandedNodeId& nodeId = uaBrowseResults[i].References[j].NodeId;
+                if (nodeId.ServerIndex == 0)
+                    subtypes.push_back(UaNodeId(nodeId.NodeId));
+            }
+
+            if (uaBrowseResults[i].ContinuationPoint.Length > 0)
+            {
+                OpcUa_UInt32 current = uaContinuationPoints.length();
+                uaContinuationPoints.resize(current + 1);
+                UaByteString(uaBrowseResults[i].ContinuationPoint).copyTo(
+                        &uaContinuationPoints[current]);
+            }
+        }
+    }
+
+
+    // Preload the structure definitions
+    // =============================================================================================
+    void Session::preloadStructureDefinitions()
+    {
+        const vector<string>& nameSpaceUris =
+                database_->clientSettings.structureDefinitionsPreloadNamespaceUris;
+
+        if (nameSpaceUris.size() == 0)
+            return;
+
+        // get the indexes of the namespaces
+        std::set<NameSpaceIndex> nameSpaceIndexes;
+        for (vector<string>::const_iterator it = nameSpaceUris.begin();
+             it != nameSpaceUris.end();
+             ++it)
+        {
+            NameSpaceIndex nameSpaceIndex;
+            if (namespaceArray_.findNamespaceIndex(*it, nameSpaceIndex))
+                nameSpaceIndexes.insert(nameSpaceIndex);
+            else
+                logger_->warning("Cannot preload the structure definitions of namespace %s, since "
+                                 "the server doesn't know this namespace", it->c_str());
+        }
+
+        if (nameSpaceIndexes.size() == 0)
+            return;
+
+        logger_->debug("Preloading the structure definitions");
+
+        UaClientSdk::ServiceSettings uaServiceSettings;
+        sessionSettings_.readServerInfoSettings.toSdk(uaServiceSettings);
+
+        OpcUa_ViewDescription uaViewDescription;
+        OpcUa_ViewDescription_Initialize(&uaViewDescription);
+
+        // browse the subtypes of the Structure datatype, one level at a time
+        vector<UaNodeId> dataTypeIds;
+        vector<UaNodeId> supertypes(1, UaNodeId(OpcUaId_Structure));
+        UaStatus         uaStatus;
+
+        while (supertypes.size() > 0 && uaStatus.isGood())
+        {
+            UaBrowseDescriptions    uaBrowseDescriptions;
+            UaBrowseResults         uaBrowseResults;
+            UaByteStringArray       uaContinuationPoints;
+            UaDiagnosticInfos       uaDiagnosticInfos;
+            vector<UaNodeId>        subtypes;
+
+            uaBrowseDescriptions.create(supertypes.size());
+            for (size_t i = 0; i < supertypes.size(); i++)
+            {
+                supertypes[i].copyTo(&uaBrowseDescriptions[i].NodeId);
+                UaNodeId(OpcUaId_HasSubtype).copyTo(&uaBrowseDescriptions[i].ReferenceTypeId);
+                uaBrowseDescriptions[i].BrowseDirection = OpcUa_BrowseDirection_Forward;
+                uaBrowseDescriptions[i].IncludeSubtypes = OpcUa_False;
+                uaBrowseDescriptions[i].NodeClassMask   = OpcUa_NodeClass_DataType;
+                uaBrowseDescriptions[i].ResultMask      = OpcUa_BrowseResultMask_None;
+            }
+
+            uaStatus = uaSession_->browseList(
+                    uaServiceSettings,
+                    uaViewDescription,
+                    0, // no limit on the number of references
+                    uaBrowseDescriptions,
+                    uaBrowseResults,
+                    uaDiagnosticInfos);
+
+            if (uaStatus.isGood())
+                collectSubtypes(uaBrowseResults, subtypes, uaContinuationPoints);
+
+            while (uaStatus.isGood() && uaContinuationPoints.length() > 0)
+            {
+                uaStatus = uaSession_->browseListNext(
+                        uaServiceSettings,
+                        OpcUa_False,
+                        uaContinuationPoints,
+                        uaBrowseResults,
+                        uaDiagnosticInfos);
+
+                if (uaStatus.isGood())
+                    collectSubtypes(uaBrowseResults, subtypes, uaContinuationPoints);
+            }
+
+            for (vector<UaNodeId>::const_iterator it = subtypes.begin(); it != subtypes.end(); ++it)
+            {
+                if (nameSpaceIndexes.count(it->namespaceIndex()) > 0)
+                    dataTypeIds.push_back(*it);
+            }
+
+            supertypes.swap(subtypes);
+        }
+
+        OpcUa_ViewDescription_Clear(&uaViewDescription);
+
+        if (uaStatus.isBad())
+            logger_->warning("Could not browse all structured datatypes: %s",
+                             SdkStatus(uaStatus).toString().c_str());
+
+        // get the definitions of the datatypes that were found
+        size_t noOfDefinitions = 0;
+        for (vector<UaNodeId>::const_iterator it = dataTypeIds.begin();
+             it != dataTypeIds.end();
+             ++it)
+        {
+            StructureDefinition definition;
+            definition.fromSdk(uaSession_->structureDefinition(*it));
+
+            if (!definition.isNull())
+            {
+                NodeId key;
+                key.fromSdk(*it);
+
+                UaMutexLocker locker(&structureDefinitionsMutex_); // unlocks when out of scope
+                structureDefinitions_[key] = definition;
+                noOfDefinitions++;
+            }
+        }
+
+        logger_->debug("%d structure definitions have been preloaded", noOfDefinitions);
+    }
+
+
+    // Forget the cached structure definitions
+    // =============================================================================================
+    void Session::clearStructureDefinitions()
+    {
+        UaMutexLocker locker(&structureDefinitionsMutex_); // unlocks when out of scope
+        structureDefinitions_.clear();
+        structureDefinitionsRevision_++;
+    }
+
+
+    // Register the hot nodes
+    // =============================================================================================
+    void Session::registerHotNodes()
+    {
+        // the evicted nodes don't need their aliases anymore
+        UaNodeIdArray uaEvictedNodeIds;
+        registeredNodes_.takeEvictedAliases(uaEvictedNodeIds);
+        unregisterNodes(uaEvictedNodeIds);
+
+        vector<NodeId> hotNodeIds;
+        uint32_t generation = registeredNodes_.startRegistration(hotNodeIds);
+
+        if (hotNodeIds.size() == 0)
+            return;
+
+        // convert the nodes, and give up on the nodes that cannot be converted
+        vector<NodeId>  nodeIds;
+        vector<NodeId>  failedNodeIds;
+        UaNodeIdArray   uaNodeIds;
+        uaNodeIds.create(hotNodeIds.size());
+
+        for (vector<NodeId>::const_iterator it = hotNodeIds.begin(); it != hotNodeIds.end(); ++it)
+        {
+            if (namespaceArray_.fillOpcUaNodeId(*it, uaNodeIds[nodeIds.size()]).isGood())
+                nodeIds.push_back(*it);
+            else
+                failedNodeIds.push_back(*it);
+        }
+        uaNodeIds.resize(nodeIds.size());
+
+        if (nodeIds.size() > 0)
+        {
+            logger_->debug("Registering %d nodes", nodeIds.size());
+
+            UaClientSdk::ServiceSettings    uaServiceSettings;
+            UaNodeIdArray                   uaRegisteredNodeIds;
+
+            UaStatus uaStatus = uaSession_->registerNodes(
+                    uaServiceSettings,
+                    uaNodeIds,
+                    uaRegisteredNodeIds);
+
+            if (uaStatus.isGood() && uaRegisteredNodeIds.length() == nodeIds.size())
+            {
+                registeredNodes_.setRegistered(generation, nodeIds, uaRegisteredNodeIds);
+            }
+            else
+            {
+                // e.g. because the server doesn't support the RegisterNodes service
+                logger_->warning("Could not register the nodes: %s",
+                                 SdkStatus(uaStatus).toString().c_str());
+                failedNodeIds.insert(failedNodeIds.end(), nodeIds.begin(), nodeIds.end());
+            }
+        }
+
+        registeredNodes_.setFailed(generation, failedNodeIds);
+    }
+
+
+    // Unregister nodes
+    // =============================================================================================
+    void Session::unregisterNodes(const UaNodeIdArray& aliases)
+    {
+        if (aliases.length() == 0)
+            return;
+
+        logger_->debug("Unregistering %d nodes", aliases.length());
+
+        UaClientSdk::ServiceSettings uaServiceSettings;
+
+        UaStatus uaStatus = uaSession_->unregisterNodes(uaServiceSettings, aliases);
+
+        // the aliases are not used anymore anyway, so a failure is not critical
+        if (uaStatus.isNotGood())
+            logger_->warning("Could not unregister the nodes: %s",
+                             SdkStatus(uaStatus).toString().c_str());
+    }
+
+
+    // Get the server URI
+    // =============================================================================================
+    string Session::serverUri() const
+    {
+        UaMutexLocker locker(&serverUriMutex_); // unlocks when out of scope
+        return serverUri_;
+    }
+
+
     // Get a compact string representation
     // =============================================================================================
     string Session::toString() const
     {
         stringstream ss;
-        ss << "Session-" << clientConnectionId_ << ":" << serverUri_;
+        ss << "Session-" << clientConnectionId_ << ":" << serverUri();
         return ss.str();
     }
 
@@ -913,16 +1266,43 @@ namespace uaf
         // update the session state member
         sessionState_ = sessionState;
 
-        // if the session became connected, update the arrays
+        // if the session became connected, update the arrays and the operation limits
         if (sessionState == uaf::sessionstates::Connected)
-            updateArrays();
+        {
+            // cached addresses (e.g. loaded from a file) are only valid for the same namespaces
+            if (updateArrays().isGood())
+                database_->addressCache.updateNamespaceArray(serverUri(), namespaceArray_);
+
+            updateOperationLimits();
+
+            // the aliases of the previous connection may not be valid anymore, so the nodes
+            // need to be registered again
+            registeredNodes_.reset();
+            if (database_->clientSettings.registerNodesEnable)
+                registerHotNodes();
+
+            // the datatypes (or their namespace indexes) may have changed
+            clearStructureDefinitions();
+            preloadStructureDefinitions();
+
+            connectionRevision_++;
+        }
         // if the session has difficulties, we remove all references to this serverUri from
         // the address resolution cache (because maybe the node resolution is not valid anymore)
+        // and from the value cache (because the cached values may not be updated anymore)
         else if (   (sessionState == uaf::sessionstates::ConnectionErrorApiReconnect)
                  || (sessionState == uaf::sessionstates::ConnectionWarningWatchdogTimeout)
                  || (sessionState == uaf::sessionstates::Disconnected)
                  || (sessionState == uaf::sessionstates::ServerShutdown))
-            database_->addressCache.clear(serverUri_);
+        {
+            database_->addressCache.clear(serverUri());
+            database_->valueCache.clear(serverUri());
+
+            // don't use the aliases of the registered nodes until they are registered again
+            registeredNodes_.reset();
+
+            clearStructureDefinitions();
+        }
 
         // call the callback interface
         clientInterface_->connectionStatusChanged(sessionInformation());
@@ -979,14 +1359,49 @@ namespace uaf
     {
         Status ret;
 
-        UaNodeId uaNodeId;
-        UaStructureDefinition uaDef;
+        // get the NodeId as known by the server
+        OpcUa_NodeId opcUaNodeId;
+        OpcUa_NodeId_Initialize(&opcUaNodeId);
+        ret = namespaceArray_.fillOpcUaNodeId(dataTypeId, opcUaNodeId);
+        UaNodeId uaNodeId(opcUaNodeId);
+        OpcUa_NodeId_Clear(&opcUaNodeId);
+
+        if (ret.isNotGood())
+            return DefinitionNotFoundError();
+
+        NodeId key;
+        key.fromSdk(uaNodeId);
+
+        bool     cached = false;
+        uint32_t revision;
 
-        dataTypeId.toSdk(uaNodeId);
+        // check the cache first
+        {
+            UaMutexLocker locker(&structureDefinitionsMutex_); // unlocks when out of scope
 
-        uaDef = uaSession_->structureDefinition(uaNodeId);
+            StructureDefinitionMap::const_iterator it = structureDefinitions_.find(key);
+            if (it != structureDefinitions_.end())
+            {
+                definition = it->second;
+                cached     = true;
+                structureDefinitionHits_++;
+            }
+
+            revision = structureDefinitionsRevision_;
+        }
 
-        definition.fromSdk(uaDef);
+        // if needed, get the definition from the SDK (outside the lock, since this may require
+        // a service call), and cache it unless the cache was cleared in the meantime
+        // (a missing definition is not cached, since the datatype may still be added later)
+        if (!cached)
+        {
+            definition.fromSdk(uaSession_->structureDefinition(uaNodeId));
+
+            UaMutexLocker locker(&structureDefinitionsMutex_); // unlocks when out of scope
+
+            if (revision == structureDefinitionsRevision_ && !definition.isNull())
+                structureDefinitions_[key] = definition;
+        }
 
         if (definition.isNull())
         	ret = DefinitionNotFoundError();
@@ -25,6 +25,8 @@
 // STD
 #include <string>
 #include <sstream>
+#include <map>
+#include <set>
 // SDK
 #include "uaclient/uaclientsdk.h"
 #include "uaclient/uasession.h"
@@ -44,6 +46,8 @@
 #include "uaf/client/clientexport.h"
 #include "uaf/client/sessions/sessionstates.h"
 #include "uaf/client/sessions/sessioninformation.h"
+#include "uaf/client/sessions/operationlimits.h"
+#include "uaf/client/sessions/registerednodes.h"
 #include "uaf/client/settings/sessionsettings.h"
 #include "uaf/client/subscriptions/subscriptionfactory.h"
 #include "uaf/client/discovery/discoverer.h"
@@ -159,18 +163,35 @@ namespace uaf
         /**
          * Get the server URI of the session.
          */
-        std::string serverUri()                             const { return serverUri_; };
+        std::string serverUri()                             const;
 
         /**
          * Get the settings of the session.
          */
         uaf::SessionSettings sessionSettings()             const { return sessionSettings_; };
 
+        /**
+         * Get the fingerprint of the settings of the session (see SessionSettings::fingerprint()).
+         */
+        uint64_t sessionSettingsFingerprint()               const { return sessionSettingsFingerprint_; };
+
         /**
          * Get the state of the session.
          */
         uaf::sessionstates::SessionState sessionState()    const { return sessionState_; };
 
+        /**
+         * Get the OperationLimits of the server (updated each time the session gets connected).
+         */
+        uaf::OperationLimits operationLimits()             const { return operationLimits_; };
+
+        /**
+         * Get the number of times the session got connected. Anything derived from the
+         * NamespaceArray, ServerArray or OperationLimits of the session (such as the encoded
+         * node ids of a prepared request) is outdated once this number changes.
+         */
+        uint32_t connectionRevision()                       const { return connectionRevision_; };
+
 
         ///@} //////////////////////////////////////////////////////////////////////////////////////
         /**
@@ -273,6 +294,9 @@ namespace uaf
         /**
          * Get the definition of a structured datatype.
          *
+         * The definitions (and the datatypes for which no definition could be found) are cached
+         * until the session gets reconnected.
+         *
          * @param dataTypeId	The NodeId of the structured datatype.
          * @param definition    Output parameter, the definition (if found).
          * @return				DefinitionNotFoundError if no definition was found,
@@ -304,7 +328,22 @@ namespace uaf
                                                _Service::asynchronous>& request,
                 typename _Service::Invocation& invocation)
         {
-            return invocation.invoke(uaSession_, namespaceArray_, serverArray_, logger_);
+            // let the invocation use the aliases of the registered nodes, if needed
+            bool registerNodes = database_->clientSettings.registerNodesEnable;
+            if (registerNodes)
+                invocation.setRegisteredNodes(
+                        &registeredNodes_,
+                        database_->clientSettings.registerNodesMaxNodes,
+                        database_->clientSettings.registerNodesMinAccessCount);
+
+            uaf::Status ret = invocation.invoke(uaSession_, namespaceArray_, serverArray_, logger_);
+
+            // register the nodes that have been accessed often enough by now (and unregister the
+            // ones that have been evicted)
+            if (registerNodes)
+                registerHotNodes();
+
+            return ret;
         }
 
 
@@ -381,6 +420,45 @@ namespace uaf
         uaf::Status updateArrays();
 
 
+        /**
+         * Update the OperationLimits of the server (not locked!).
+         *
+         * Limits that cannot be read are set to 0 (i.e. no limit), since servers are not
+         * obliged to expose them.
+         */
+        void updateOperationLimits();
+
+
+        /**
+         * Register the nodes that have been read or written at least registerNodesMinAccessCount
+         * times (see ClientSettings::registerNodesEnable) and that are not registered yet,
+         * and unregister the registered nodes that have been evicted since the last call
+         * (see ClientSettings::registerNodesMaxNodes).
+         */
+        void registerHotNodes();
+
+
+        /**
+         * Unregister the given aliases by means of the UnregisterNodes service.
+         *
+         * @param aliases   The aliases that were returned by the RegisterNodes service.
+         */
+        void unregisterNodes(const UaNodeIdArray& aliases);
+
+
+        /**
+         * Forget all cached structure definitions.
+         */
+        void clearStructureDefinitions();
+
+
+        /**
+         * Load the definitions of all structured datatypes of the namespaces given by
+         * ClientSettings::structureDefinitionsPreloadNamespaceUris (not locked!).
+         */
+        void preloadStructureDefinitions();
+
+
         /**
          * Update the connection info.
          */
@@ -441,6 +519,25 @@ namespace uaf
         uaf::ServerArray                    serverArray_;
         uaf::NamespaceArray                 namespaceArray_;
 
+        // the operation limits of the server
+        uaf::OperationLimits                operationLimits_;
+
+        // the number of times the session got connected
+        uint32_t                            connectionRevision_;
+
+        // the nodes that are (or may be) registered by the server
+        uaf::RegisteredNodes                registeredNodes_;
+
+        // the cached structure definitions, stored by the datatype NodeId with the namespace
+        // index of the server (datatypes without a definition are not cached)
+        typedef std::map<uaf::NodeId, uaf::StructureDefinition> StructureDefinitionMap;
+        StructureDefinitionMap              structureDefinitions_;
+        // incremented each time the cached definitions are cleared
+        uint32_t                            structureDefinitionsRevision_;
+        // the number of definitions that were taken from the cache
+        uint32_t                            structureDefinitionHits_;
+        mutable UaMutex                     structureDefinitionsMutex_;
+
         // the current session state:
         uaf::sessionstates::SessionState   sessionState_;
 
@@ -451,7 +548,11 @@ namespace uaf
         // fixed session properties:
         uaf::ClientConnectionId             clientConnectionId_;
         std::string                         serverUri_;
+        // the server URI of a session that connects to a specific endpoint is only known after
+        // connecting, so the mutex protects it from the threads that read it in the meantime
+        mutable UaMutex                     serverUriMutex_;
         uaf::SessionSettings               sessionSettings_;
+        uint64_t                            sessionSettingsFingerprint_;
 
         // the logger of the session
         uaf::Logger*                        logger_;
@@ -26,6 +26,7 @@ namespace uaf
     using std::string;
     using std::vector;
     using std::map;
+    using std::size_t;
 
 
     // Constructor
@@ -41,6 +42,8 @@ namespace uaf
     {
         logger_ = new Logger(loggerFactory, "SessionFactory");
 
+        invocationPool_ = new InvocationPool(loggerFactory);
+
         transactionId_ = 0;
 
         logger_->debug("The SessionFactory has been constructed");
@@ -55,6 +58,9 @@ namespace uaf
 
         deleteAllSessions();
 
+        delete invocationPool_;
+        invocationPool_ = 0;
+
         delete logger_;
         logger_ = 0;
 
@@ -87,6 +93,7 @@ namespace uaf
         }
 
         sessionMap_.clear();
+        sessionIndex_.clear();
         activityMap_.clear();
 
         logger_->debug("All sessions have been deleted");
@@ -175,7 +182,7 @@ namespace uaf
         }
 
         // lock the mutex to make sure the sessionMap_ is not being manipulated
-        UaMutexLocker locker(&sessionMapMutex_);
+        sessionMapMutex_.lock();
 
         clientConnectionId = database_->createUniqueClientConnectionId();
         logger_->debug("ClientConnectionId %d was assigned to the session", clientConnectionId);
@@ -193,29 +200,51 @@ namespace uaf
 
         // store the new session instance in the sessionMap
         sessionMap_[clientConnectionId] = session;
+        indexSession(session);
+
+        // create an activity count for the session, so that it can't be deleted while connecting
+        activityMapMutex_.lock();
+        activityMap_[clientConnectionId] = 1;
+        activityMapMutex_.unlock();
+
+        // register the connection attempt
+        ConnectionAttempt* attempt = new ConnectionAttempt;
+        connectionAttempts_[clientConnectionId] = attempt;
+
+        sessionMapMutex_.unlock();
 
         // connect to the session to the specific endpoint
         if (serverCertificatePtr != NULL)
-            ret = session->connectToSpecificEndpoint(endpointUrl, *serverCertificatePtr);
+            ret = connectNewSession(session, attempt, endpointUrl, *serverCertificatePtr);
         else
-            ret = session->connectToSpecificEndpoint(endpointUrl, PkiCertificate()); // NULL certificate
+            ret = connectNewSession(session, attempt, endpointUrl, PkiCertificate()); // NULL certificate
 
         // add some diagnostics
         if (ret.isGood())
         {
-            // create an activity count for the session
             activityMapMutex_.lock();
-            activityMap_[clientConnectionId] = 1;
             logger_->debug("The requested session is created (#activities: %d)",
                            activityMap_[clientConnectionId]);
             activityMapMutex_.unlock();
         }
         else
         {
-            delete session;
-            session = 0;
-            sessionMap_.erase(clientConnectionId);
             logger_->error("The requested session could not be created");
+
+            // delete the session, unless other threads have acquired it in the meantime (then it
+            // will be garbage collected when they release it)
+            UaMutexLocker sessionMapLocker(&sessionMapMutex_);
+            UaMutexLocker activityMapLocker(&activityMapMutex_);
+
+            activityMap_[clientConnectionId] = activityMap_[clientConnectionId] - 1;
+            if (activityMap_[clientConnectionId] == 0)
+            {
+                unindexSession(session);
+                delete session;
+                session = 0;
+                activityMap_.erase(clientConnectionId);
+                sessionMap_.erase(clientConnectionId);
+            }
         }
 
         return ret;
@@ -529,15 +558,28 @@ namespace uaf
     {
         Status ret;
 
-        // lock the mutex to make sure the sessionMap_ is not being manipulated
-        UaMutexLocker locker(&sessionMapMutex_);
+        // get the ids of the sessions, without keeping the sessionMap_ locked while the
+        // definition is looked up (since this may require a service call)
+        vector<ClientConnectionId> clientConnectionIds;
+        {
+            UaMutexLocker locker(&sessionMapMutex_);
+
+            for (SessionMap::const_iterator it = sessionMap_.begin(); it != sessionMap_.end(); ++it)
+                clientConnectionIds.push_back(it->first);
+        }
 
         // loop trough the sessions and let structureDefinition be called (if needed!) on each of them
-        for (SessionMap::const_iterator it = sessionMap_.begin();
-                it != sessionMap_.end() && ret.isNotGood();
+        for (vector<ClientConnectionId>::const_iterator it = clientConnectionIds.begin();
+                it != clientConnectionIds.end() && ret.isNotGood();
                 ++it)
         {
-            ret = it->second->structureDefinition(dataTypeId, definition);
+            Session* session = 0;
+
+            if (acquireExistingSession(*it, session).isGood())
+            {
+                ret = session->structureDefinition(dataTypeId, definition);
+                releaseSession(session);
+            }
         }
 
         return ret;
@@ -553,14 +595,18 @@ namespace uaf
             Session*&               session)
     {
         logger_->debug("Acquiring Session to %s with the following settings:", serverUri.c_str());
-        logger_->debug(sessionSettings.toString());
+        UAF_LOG_DEBUG(logger_, (sessionSettings.toString()));
 
         Status ret;
 
         session = 0;
 
+        // the connection attempt that this thread has to perform, or has to wait for
+        ConnectionAttempt* newAttempt = 0;
+        ConnectionAttempt* joinedAttempt = 0;
+
         // lock the mutex to make sure the sessionMap_ is not being manipulated
-        UaMutexLocker locker(&sessionMapMutex_);
+        sessionMapMutex_.lock();
 
         // first check if we need to create a new session in any case:
         if (sessionSettings.unique)
@@ -569,8 +615,11 @@ namespace uaf
         }
         else
         {
-            // loop trough the sessions ...
-            for (SessionMap::const_iterator it = sessionMap_.begin(); it != sessionMap_.end(); ++it)
+            // loop trough the sessions with the same key ...
+            std::pair<SessionIndex::const_iterator, SessionIndex::const_iterator> range;
+            range = sessionIndex_.equal_range(sessionKey(serverUri, sessionSettings.fingerprint()));
+
+            for (SessionIndex::const_iterator it = range.first; it != range.second; ++it)
             {
                 // ... until a suitable one is found
                 if (    it->second->serverUri() == serverUri
@@ -588,6 +637,9 @@ namespace uaf
                     activityMap_[id] = activityMap_[id] + 1;
                     activityMapMutex_.unlock();
 
+                    // if the session is still being connected by another thread, we wait for it
+                    joinedAttempt = joinConnectionAttempt(id);
+
                     ret = statuscodes::Good;
 
                     break;
@@ -618,20 +670,32 @@ namespace uaf
 
             // store the new session instance in the sessionMap
             sessionMap_[clientConnectionId] = session;
+            indexSession(session);
 
             // create an activity count for the session
             activityMapMutex_.lock();
             activityMap_[clientConnectionId] = 1;
             activityMapMutex_.unlock();
 
-            // connect to the session
-            session->connect();
+            // register the connection attempt, so that other threads acquiring the same session
+            // will wait for it
+            newAttempt = new ConnectionAttempt;
+            connectionAttempts_[clientConnectionId] = newAttempt;
 
-            // regardless of whether the connection succeeded or failed, set the return status
+            // regardless of whether the connection will succeed or fail, set the return status
             // to 'good'
             ret = statuscodes::Good;
         }
 
+        // don't keep the other sessions locked while connecting (which may take a long time if
+        // the server is not reachable)
+        sessionMapMutex_.unlock();
+
+        if (newAttempt != 0)
+            connectNewSession(session, newAttempt);
+        else
+            waitForConnectionAttempt(joinedAttempt);
+
         // add some diagnostics
         if (ret.isGood())
         {
@@ -650,6 +714,121 @@ namespace uaf
     }
 
 
+    // Connect a new session
+    // =============================================================================================
+    Status SessionFactory::connectNewSession(
+            Session*                session,
+            ConnectionAttempt*      attempt,
+            const string&           endpointUrl,
+            const PkiCertificate&   serverCertificate)
+    {
+        Status ret;
+
+        logger_->debug("Connecting session %d (without locking the other sessions)",
+                       session->clientConnectionId());
+
+        if (endpointUrl.empty())
+            ret = session->connect();
+        else
+            ret = session->connectToSpecificEndpoint(endpointUrl, serverCertificate);
+
+        // the attempt has finished, so wake up the threads that were waiting for it
+        UaMutexLocker locker(&sessionMapMutex_);
+
+        connectionAttempts_.erase(session->clientConnectionId());
+
+        // the server URI of a session that is connected to a specific endpoint is only known now
+        unindexSession(session);
+        indexSession(session);
+
+        logger_->debug("The connection attempt of session %d has finished (%d waiting threads)",
+                       session->clientConnectionId(), attempt->noOfWaiters);
+
+        // if threads are waiting, the last one will delete the attempt
+        if (attempt->noOfWaiters > 0)
+            attempt->finished.post(attempt->noOfWaiters);
+        else
+            delete attempt;
+
+        return ret;
+    }
+
+
+    // Add a session to the index
+    // =============================================================================================
+    void SessionFactory::indexSession(Session* session)
+    {
+        sessionIndex_.insert(std::make_pair(
+                sessionKey(session->serverUri(), session->sessionSettingsFingerprint()),
+                session));
+    }
+
+
+    // Remove a session from the index
+    // =============================================================================================
+    void SessionFactory::unindexSession(Session* session)
+    {
+        std::pair<SessionIndex::iterator, SessionIndex::iterator> range;
+        range = sessionIndex_.equal_range(
+                sessionKey(session->serverUri(), session->sessionSettingsFingerprint()));
+
+        for (SessionIndex::iterator it = range.first; it != range.second; ++it)
+        {
+            if (it->second == session)
+            {
+                sessionIndex_.erase(it);
+                return;
+            }
+        }
+
+        // the server URI of the session may have changed since it was indexed
+        for (SessionIndex::iterator it = sessionIndex_.begin(); it != sessionIndex_.end(); ++it)
+        {
+            if (it->second == session)
+            {
+                sessionIndex_.erase(it);
+                return;
+            }
+        }
+    }
+
+
+    // Join a connection attempt in progress
+    // =============================================================================================
+    SessionFactory::ConnectionAttempt* SessionFactory::joinConnectionAttempt(
+            ClientConnectionId clientConnectionId)
+    {
+        ConnectionAttempt* attempt = 0;
+
+        ConnectionAttemptMap::iterator iter = connectionAttempts_.find(clientConnectionId);
+        if (iter != connectionAttempts_.end())
+        {
+            attempt = iter->second;
+            attempt->noOfWaiters++;
+        }
+
+        return attempt;
+    }
+
+
+    // Wait for a connection attempt in progress
+    // =============================================================================================
+    void SessionFactory::waitForConnectionAttempt(ConnectionAttempt* attempt)
+    {
+        if (attempt != 0)
+        {
+            logger_->debug("Waiting until the session is connected by another thread");
+
+            attempt->finished.wait();
+
+            UaMutexLocker locker(&sessionMapMutex_);
+            attempt->noOfWaiters--;
+            if (attempt->noOfWaiters == 0)
+                delete attempt;
+        }
+    }
+
+
     // Acquire an existing session, if one is available.
     // =============================================================================================
     Status SessionFactory::acquireExistingSession(
@@ -662,8 +841,11 @@ namespace uaf
 
         session = 0;
 
+        // the connection attempt of the session that may still be in progress
+        ConnectionAttempt* joinedAttempt = 0;
+
         // lock the mutex to make sure the sessionMap is not being manipulated
-        UaMutexLocker locker(&sessionMapMutex_);
+        sessionMapMutex_.lock();
 
         SessionMap::iterator iter = sessionMap_.find(clientConnectionId);
 
@@ -689,8 +871,15 @@ namespace uaf
 
             logger_->debug("Session %d was acquired (#activities: %d)",
                            clientConnectionId, newActivityCount);
+
+            joinedAttempt = joinConnectionAttempt(clientConnectionId);
         }
 
+        sessionMapMutex_.unlock();
+
+        // wait (without holding the sessionMapMutex_) until the session is connected, if needed
+        waitForConnectionAttempt(joinedAttempt);
+
         return ret;
     }
 
@@ -736,6 +925,7 @@ namespace uaf
                 {
                     logger_->debug("There's no ongoing activity of this disconnected session, so "
                                    "we may delete it");
+                    unindexSession(session);
                     delete session;
                     session = 0;
                     activityMap_.erase(id);
@@ -847,6 +1037,185 @@ namespace uaf
     }
 
 
+    // Store a split asynchronous request
+    // =============================================================================================
+    void SessionFactory::storeAsyncRequest(
+            TransactionId   requestTransactionId,
+            size_t          noOfTargets,
+            size_t          noOfTransactions)
+    {
+        logger_->debug("Asynchronous request transaction %d is split up into %d transactions",
+                       requestTransactionId, noOfTransactions);
+
+        UaMutexLocker locker(&transactionMapMutex_); // unlocks when locker goes out of scope
+
+        AsyncRequest& asyncRequest = asyncRequestMap_[requestTransactionId];
+        asyncRequest.noOfTargets = noOfTargets;
+        asyncRequest.noOfPendingTransactions = noOfTransactions;
+    }
+
+
+    // Store a transaction of a split asynchronous request
+    // =============================================================================================
+    TransactionId SessionFactory::storeAsyncTransaction(
+            TransactionId           requestTransactionId,
+            RequestHandle           requestHandle,
+            const vector<size_t>&   ranks)
+    {
+        UaMutexLocker locker(&transactionMapMutex_); // unlocks when locker goes out of scope
+
+        TransactionId transactionId = getNewTransactionId();
+        transactionMap_[transactionId] = requestHandle;
+
+        AsyncTransaction& asyncTransaction = asyncTransactionMap_[transactionId];
+        asyncTransaction.requestTransactionId = requestTransactionId;
+        asyncTransaction.ranks = ranks;
+
+        logger_->debug("A new transaction id %d was stored for request %d (transaction %d)",
+                       transactionId, requestHandle, requestTransactionId);
+
+        return transactionId;
+    }
+
+
+    // Register the future of an asynchronous request
+    // =============================================================================================
+    void SessionFactory::registerFuture(const Future<ReadResult>& future)
+    {
+        storeFuture(readFutures_, future);
+    }
+
+
+    // Register the future of an asynchronous request
+    // =============================================================================================
+    void SessionFactory::registerFuture(const Future<WriteResult>& future)
+    {
+        storeFuture(writeFutures_, future);
+    }
+
+
+    // Register the future of an asynchronous request
+    // =============================================================================================
+    void SessionFactory::registerFuture(const Future<MethodCallResult>& future)
+    {
+        storeFuture(callFutures_, future);
+    }
+
+
+    // Unregister the future of an asynchronous request
+    // =============================================================================================
+    bool SessionFactory::unregisterFuture(const Future<ReadResult>& future)
+    {
+        Future<ReadResult> registeredFuture;
+        return takeFuture(readFutures_, future.requestHandle(), registeredFuture);
+    }
+
+
+    // Unregister the future of an asynchronous request
+    // =============================================================================================
+    bool SessionFactory::unregisterFuture(const Future<WriteResult>& future)
+    {
+        Future<WriteResult> registeredFuture;
+        return takeFuture(writeFutures_, future.requestHandle(), registeredFuture);
+    }
+
+
+    // Unregister the future of an asynchronous request
+    // =============================================================================================
+    bool SessionFactory::unregisterFuture(const Future<MethodCallResult>& future)
+    {
+        Future<MethodCallResult> registeredFuture;
+        return takeFuture(callFutures_, future.requestHandle(), registeredFuture);
+    }
+
+
+    // Deliver the result of an asynchronous request
+    // =============================================================================================
+    void SessionFactory::deliverAsyncResult(const ReadResult& result)
+    {
+        Future<ReadResult> future;
+
+        if (takeFuture(readFutures_, result.requestHandle, future))
+            future.setResult(result);
+        else
+            clientInterface_->readComplete(result);
+    }
+
+
+    // Deliver the result of an asynchronous request
+    // =============================================================================================
+    void SessionFactory::deliverAsyncResult(const WriteResult& result)
+    {
+        Future<WriteResult> future;
+
+        if (takeFuture(writeFutures_, result.requestHandle, future))
+            future.setResult(result);
+        else
+            clientInterface_->writeComplete(result);
+    }
+
+
+    // Deliver the result of an asynchronous request
+    // =============================================================================================
+    void SessionFactory::deliverAsyncResult(const MethodCallResult& result)
+    {
+        Future<MethodCallResult> future;
+
+        if (takeFuture(callFutures_, result.requestHandle, future))
+            future.setResult(result);
+        else
+            clientInterface_->callComplete(result);
+    }
+
+
+    // Complete a transaction of a split asynchronous read request that could not be sent
+    // =============================================================================================
+    void SessionFactory::asyncTransactionFailed(
+            const AsyncReadRequest& request,
+            TransactionId           transactionId,
+            const Status&           status)
+    {
+        ReadResult result;
+        result.requestHandle = request.requestHandle();
+        result.overallStatus = status;
+
+        if (assembleAsyncResult(transactionId, false, result, &AsyncRequest::readResult))
+            deliverAsyncResult(result);
+    }
+
+
+    // Complete a transaction of a split asynchronous write request that could not be sent
+    // =============================================================================================
+    void SessionFactory::asyncTransactionFailed(
+            const AsyncWriteRequest&    request,
+            TransactionId               transactionId,
+            const Status&               status)
+    {
+        WriteResult result;
+        result.requestHandle = request.requestHandle();
+        result.overallStatus = status;
+
+        if (assembleAsyncResult(transactionId, false, result, &AsyncRequest::writeResult))
+            deliverAsyncResult(result);
+    }
+
+
+    // Complete a transaction of a split asynchronous method call request that could not be sent
+    // =============================================================================================
+    void SessionFactory::asyncTransactionFailed(
+            const AsyncMethodCallRequest&   request,
+            TransactionId                   transactionId,
+            const Status&                   status)
+    {
+        MethodCallResult result;
+        result.requestHandle = request.requestHandle();
+        result.overallStatus = status;
+
+        if (assembleAsyncResult(transactionId, false, result, &AsyncRequest::methodCallResult))
+            deliverAsyncResult(result);
+    }
+
+
     // implemented from the callback interface
     // =============================================================================================
     void SessionFactory::callComplete(
@@ -907,7 +1276,7 @@ namespace uaf
             result.targets[0].inputArgumentOpcUaStatusCodes.push_back(callResponse.inputArgumentResults[i]);
         }
 
-        // if the transaction id was found, put the result in the correct cache
+        // if the transaction id was found, remove it
         if (transactionIdFound)
         {
             logger_->debug("Transaction id %d corresponds to the asynchronous handle %d",
@@ -918,14 +1287,14 @@ namespace uaf
             transactionMap_.erase(transactionId);         // erase the key
             transactionMapMutex_.unlock();    // unlock the map
         }
-        // if the transaction id was not found, we cannot store the result in the cache
         else
         {
-            logger_->error("Unknown transaction id received, so we cannot cache the result");
+            logger_->error("Unknown transaction id %d received", transactionId);
         }
 
-        // call the callback interface
-        clientInterface_->callComplete(result);
+        // call the callback interface, once the result of the whole request is complete
+        if (assembleAsyncResult(transactionId, true, result, &AsyncRequest::methodCallResult))
+            deliverAsyncResult(result);
     }
 
 
@@ -983,30 +1352,27 @@ namespace uaf
             result.targets[i].data = Variant(values[i].Value);
         }
         logger_->debug("ReadResult for request %d (transaction %d):", handle, transactionId);
-        logger_->debug(result.toString());
-
-//        // if the transaction id was found, put the result in the correct cache
-//        if (transactionIdFound)
-//        {
-//            logger_->debug("Transaction id %d corresponds to the asynchronous handle %d",
-//                           transactionId, handle);
-//
-//            // add the result to the database
-//            database_->asyncMethodCallResultCache.set(handle, result);
-//
-//            // remove the transaction id : request handle pair
-//            transactionMapMutex_.lock();      // lock the map
-//            transactionMap_.erase(transactionId);         // erase the key
-//            transactionMapMutex_.unlock();    // unlock the map
-//        }
-//        // if the transaction id was not found, we cannot store the result in the cache
-//        else
-//        {
-//            logger_->error("Unknown transaction id received, so we cannot cache the result");
-//        }
-
-        // call the callback interface
-        clientInterface_->readComplete(result);
+        UAF_LOG_DEBUG(logger_, (result.toString()));
+
+        // if the transaction id was found, remove it
+        if (transactionIdFound)
+        {
+            logger_->debug("Transaction id %d corresponds to the asynchronous handle %d",
+                           transactionId, handle);
+
+            // remove the transaction id : request handle pair
+            transactionMapMutex_.lock();      // lock the map
+            transactionMap_.erase(transactionId);         // erase the key
+            transactionMapMutex_.unlock();    // unlock the map
+        }
+        else
+        {
+            logger_->error("Unknown transaction id %d received", transactionId);
+        }
+
+        // call the callback interface, once the result of the whole request is complete
+        if (assembleAsyncResult(transactionId, true, result, &AsyncRequest::readResult))
+            deliverAsyncResult(result);
     }
 
 
@@ -1059,30 +1425,27 @@ namespace uaf
             result.targets[i].opcUaStatusCode = results[i];
         }
         logger_->debug("WriteResult for request %d (transaction %d):", handle, transactionId);
-        logger_->debug(result.toString());
-
-//        // if the transaction id was found, put the result in the correct cache
-//        if (transactionIdFound)
-//        {
-//            logger_->debug("Transaction id %d corresponds to the asynchronous handle %d",
-//                           transactionId, handle);
-//
-//            // add the result to the database
-//            database_->asyncMethodCallResultCache.set(handle, result);
-//
-//            // remove the transaction id : request handle pair
-//            transactionMapMutex_.lock();      // lock the map
-//            transactionMap_.erase(transactionId);         // erase the key
-//            transactionMapMutex_.unlock();    // unlock the map
-//        }
-//        // if the transaction id was not found, we cannot store the result in the cache
-//        else
-//        {
-//            logger_->error("Unknown transaction id received, so we cannot cache the result");
-//        }
-
-        // call the callback interface
-        clientInterface_->writeComplete(result);
+        UAF_LOG_DEBUG(logger_, (result.toString()));
+
+        // if the transaction id was found, remove it
+        if (transactionIdFound)
+        {
+            logger_->debug("Transaction id %d corresponds to the asynchronous handle %d",
+                           transactionId, handle);
+
+            // remove the transaction id : request handle pair
+            transactionMapMutex_.lock();      // lock the map
+            transactionMap_.erase(transactionId);         // erase the key
+            transactionMapMutex_.unlock();    // unlock the map
+        }
+        else
+        {
+            logger_->error("Unknown transaction id %d received", transactionId);
+        }
+
+        // call the callback interface, once the result of the whole request is complete
+        if (assembleAsyncResult(transactionId, true, result, &AsyncRequest::writeResult))
+            deliverAsyncResult(result);
     }
 
 }
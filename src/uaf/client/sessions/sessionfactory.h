@@ -33,8 +33,11 @@
 #include "uaf/client/clientexport.h"
 #include "uaf/client/database/database.h"
 #include "uaf/client/sessions/session.h"
+#include "uaf/client/sessions/invocationpool.h"
+#include "uaf/client/sessions/preparedinvocation.h"
 #include "uaf/client/discovery/discoverer.h"
 #include "uaf/client/clientinterface.h"
+#include "uaf/client/future.h"
 #include "uaf/client/requests/requests.h"
 #include "uaf/client/results/results.h"
 #include "uaf/client/settings/allsettings.h"
@@ -44,6 +47,76 @@ namespace uaf
 {
 
 
+    /*******************************************************************************************//**
+    * An uaf::ServiceInvocationJob invokes a service for one or more invocations (one after the
+    * other), so that the invocations of a request can be executed by an uaf::InvocationPool.
+    *
+    * @ingroup ClientSessions
+    ***********************************************************************************************/
+    template<typename _Service>
+    class ServiceInvocationJob : public uaf::InvocationJob
+    {
+    public:
+
+        /**
+         * Construct a job.
+         *
+         * @param request       The request to be invoked (must outlive the job).
+         */
+        ServiceInvocationJob(const typename _Service::Request& request)
+        : request_(request)
+        {}
+
+
+        /**
+         * Add an invocation to the job.
+         *
+         * @param session       The (acquired) session to invoke the request on.
+         * @param invocation    The invocation holding the targets for this session.
+         */
+        void addInvocation(uaf::Session* session, typename _Service::Invocation* invocation)
+        {
+            sessions_.push_back(session);
+            invocations_.push_back(invocation);
+        }
+
+
+        /**
+         * Invoke the service for each invocation, if the session is connected.
+         */
+        virtual void execute()
+        {
+            statuses_.resize(invocations_.size());
+            for (std::size_t i = 0; i < invocations_.size(); i++)
+            {
+                if (sessions_[i]->isConnected())
+                    statuses_[i] = sessions_[i]->invokeService<_Service>(request_, *invocations_[i]);
+                else
+                    statuses_[i] = sessions_[i]->sessionInformation().lastConnectionAttemptStatus;
+            }
+        }
+
+
+        /**
+         * Get the status of an invocation.
+         *
+         * @param i     The index of the invocation, in the order in which they were added.
+         * @return      Status of the invocation (only valid after execute() has been called).
+         */
+        uaf::Status status(std::size_t i) const { return statuses_[i]; }
+
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(ServiceInvocationJob);
+
+        const typename _Service::Request&               request_;
+        std::vector<uaf::Session*>                      sessions_;
+        std::vector<typename _Service::Invocation*>     invocations_;
+        std::vector<uaf::Status>                        statuses_;
+    };
+
+
+
     /*******************************************************************************************//**
     * An uaf::SessionFactory creates and owns uaf::Session instances.
     *
@@ -84,6 +157,30 @@ namespace uaf
         void deleteAllSessions();
 
 
+        /**
+         * Register the future of an asynchronous request, so that the result of the request will
+         * be delivered to the future instead of to the client interface.
+         *
+         * @param future    The future (its request handle identifies the request).
+         */
+        void registerFuture(const uaf::Future<uaf::ReadResult>& future);
+        void registerFuture(const uaf::Future<uaf::WriteResult>& future);
+        void registerFuture(const uaf::Future<uaf::MethodCallResult>& future);
+
+
+        /**
+         * Unregister the future of an asynchronous request (e.g. because the request could not
+         * be sent).
+         *
+         * @param future    The future to unregister.
+         * @return          True if the future was unregistered, false if it was not registered
+         *                  (anymore) because the result has already been delivered to it.
+         */
+        bool unregisterFuture(const uaf::Future<uaf::ReadResult>& future);
+        bool unregisterFuture(const uaf::Future<uaf::WriteResult>& future);
+        bool unregisterFuture(const uaf::Future<uaf::MethodCallResult>& future);
+
+
         /**
          * Manually connect to a specific server.
          *
@@ -331,13 +428,11 @@ namespace uaf
                 const uaf::Mask&                   mask,
                 typename _Service::Result&         result)
         {
-            logger_->debug("Invoking %sRequest %d", _Service::name().c_str(), request.requestHandle());
-            logger_->debug("Mask is %s", mask.toString().c_str());
+            UAF_LOG_DEBUG(logger_, ("Invoking %sRequest %d", _Service::name().c_str(), request.requestHandle()));
+            UAF_LOG_DEBUG(logger_, ("Mask is %s", mask.toString().c_str()));
 
             // Invocation details
             typedef typename _Service::Invocation Invocation;
-            bool async = _Service::asynchronous;
-            uaf::RequestHandle requestHandle = request.requestHandle();
 
             // declare the return Status
             uaf::Status ret;
@@ -358,181 +453,239 @@ namespace uaf
             uaf::TransactionId transactionId;
             bool handleStored = storeRequestHandleIfNeeded<_Service>(request, transactionId);
 
-            // create a map to store the invocations that we'll create
-            typedef std::map<uaf::Session*, Invocation*> InvocationMap;
-            InvocationMap invocations;
-
-            logger_->debug("Building the invocations");
-            for (std::size_t i = 0; i < request.targets.size() && ret.isGood(); i++)
+            // create a vector to store the invocations that we'll create: a session gets more than
+            // one invocation if its targets don't fit into a single service call according to the
+            // OperationLimits of the server
+            typedef std::vector< std::pair<uaf::Session*, Invocation*> > InvocationVector;
+            InvocationVector invocations;
+
+            // the acquired sessions
+            std::vector<uaf::Session*> sessions;
+
+            ret = buildInvocations<_Service>(request, mask, result, invocations, sessions);
+
+            // asynchronous requests that need more than one invocation are split up into one
+            // transaction per invocation, and their results are reassembled by the callbacks
+            bool asyncSplit = handleStored && invocations.size() > 1;
+
+            // invoke the services (concurrently, if configured and if there is more than one
+            // invocation involved)
+            std::vector<uaf::Status> invocationStatuses;
+            if (ret.isGood())
+                executeInvocations<_Service>(
+                        request, invocations, handleStored, transactionId, invocationStatuses);
+
+            // if a split asynchronous request could be sent to at least one session, then the
+            // callback will be called, so the failures of the other sessions are reported as
+            // bad target statuses instead of as a bad overall status
+            bool tolerateFailures = false;
+            for (std::size_t i = 0; i < invocationStatuses.size() && asyncSplit; i++)
+                tolerateFailures = tolerateFailures || invocationStatuses[i].isGood();
+
+            // copy all data to the result and delete the invocations
+            for (std::size_t invocationIndex = 0; invocationIndex < invocations.size(); invocationIndex++)
             {
-                if (mask.isSet(i))
+                Invocation* invocation = invocations[invocationIndex].second;
+
+                if (invocationIndex < invocationStatuses.size())
                 {
-                    if (request.clientConnectionIdGiven)
+                    uaf::Status invocationStatus = invocationStatuses[invocationIndex];
+
+                    if (invocationStatus.isGood())
                     {
-                        logger_->debug("ClientConnectionId %d is given", request.clientConnectionId);
+                        logger_->debug("Copying the data of invocation %d to the result",
+                                       invocationIndex);
+                        invocationStatus = invocation->copyToResult(result);
+                    }
+                    else if (tolerateFailures)
+                    {
+                        std::vector<std::size_t> ranks = invocation->ranks();
+                        for (std::size_t j = 0; j < ranks.size(); j++)
+                            result.targets[ranks[j]].status = invocationStatus;
+                        invocationStatus = uaf::statuscodes::Good;
+                    }
 
-                        // we'll only have 0 or 1 invocations in this case
-                        if (invocations.size() == 0)
-                        {
-                            Session* session;
-                            ret = acquireExistingSession(request.clientConnectionId, session);
-                            if (ret.isGood())
-                            {
-                                invocations[session] = new Invocation;
-                                invocations[session]->setAsynchronous(async);
-                                invocations[session]->setRequestHandle(requestHandle);
-                                invocations[session]->setServiceSettings(getServiceSettings<_Service>(request));
-                            }
-                        }
+                    // the overall status is the status of the first failing invocation
+                    if (ret.isGood())
+                        ret = invocationStatus;
+                }
 
-                        // check if we're indeed having just one invocation scheduled
-                        if (ret.isGood() && invocations.size() != 1)
-                            ret = UnexpectedError("Bug in SessionFactory::invokeRequest: #invocations != 1");
+                // don't forget to delete the invocation!!!
+                // (see bugfix https://github.com/uaf/uaf/issues/86)
+                delete invocation;
+            }
 
-                        if (ret.isGood())
-                        {
-                            for (typename InvocationMap::const_iterator it = invocations.begin(); it != invocations.end(); ++it)
-                            {
-                                logger_->debug("Adding target %d", i);
-                                it->second->addTarget(i, request.targets[i], result.targets[i]);
-                            }
-                        }
+            // clear the InvocationVector
+            invocations.clear();
 
-                    }
-                    else
-                    {
-                        logger_->debug("Trying to get the serverUri from the target");
+            // release the sessions
+            for (std::size_t j = 0; j < sessions.size(); j++)
+                releaseSession(sessions[j]);
 
-                        // we first need to determine the server which hosts the target
-                        std::string serverUri;
-                        if (getServerUriFromTarget(request.targets[i], serverUri).isGood())
-                        {
-                            logger_->debug("ServerUri was found: %s", serverUri.c_str());
+            // remove the handle if one was stored, and if there was an unexpected error
+            if (ret.isNotGood() && handleStored)
+            {
+                logger_->debug("Removing the transaction id");
+                // remove the transaction id : request handle pair
+                transactionMapMutex_.lock();            // lock the map
+                transactionMap_.erase(transactionId);   // erase the key
+                transactionMapMutex_.unlock();          // unlock the map
+            }
 
-                            Session* session = NULL;
-                            uaf::SessionSettings sessionSettings = getSessionSettings<_Service>(request, serverUri);
+            return ret;
+        }
 
-                            logger_->debug("Trying to find a scheduled session");
 
-                            // check if the session we need is already scheduled for an invocation
-                            for (typename InvocationMap::const_iterator it = invocations.begin();
-                                    it != invocations.end(); ++it)
-                            {
-                                if (   it->first->serverUri() == serverUri
-                                    && it->first->sessionSettings() == sessionSettings)
-                                {
-                                    logger_->debug("Found a scheduled session");
-                                    session = it->first;
-                                }
-                            }
+        /**
+         * Prepare a synchronous request, so that it can be invoked many times by
+         * invokePreparedRequest().
+         *
+         * The sessions are acquired (and connected if needed) and the invocations are built in the
+         * same way as invokeRequest() does, but the invocations are not invoked. Instead, they
+         * are returned together with the id and the connection revision of their session.
+         *
+         * @param request       The (resolved) request to prepare.
+         * @param mask          The mask identifying the targets of the request that need to be
+         *                      included in the invocations.
+         * @param result        The result, of which the targets are used to initialize the
+         *                      result targets of the invocations.
+         * @param prepared      Output parameter: the prepared invocations. The caller must delete
+         *                      the invocations.
+         * @return              Good if the request could be prepared, bad if not.
+         */
+        template<typename _Service>
+        uaf::Status prepareRequest(
+                const typename _Service::Request&                           request,
+                const uaf::Mask&                                            mask,
+                const typename _Service::Result&                            result,
+                std::vector< uaf::PreparedInvocation<_Service> >&           prepared)
+        {
+            typedef typename _Service::Invocation Invocation;
 
-                            // if the session is not already scheduled, we acquire it first
-                            if (session == NULL)
-                            {
-                                logger_->debug("No session was scheduled, so we acquire one");
+            UAF_LOG_DEBUG(logger_, ("Preparing %sRequest %d", _Service::name().c_str(), request.requestHandle()));
 
-                                ret = acquireSession(serverUri, sessionSettings, session);
+            uaf::Status ret;
 
-                                if (ret.isGood())
-                                {
-                                    logger_->debug("Scheduling an invocation for this session");
-                                    invocations[session] = new Invocation;
-                                    invocations[session]->setAsynchronous(async);
-                                    invocations[session]->setRequestHandle(requestHandle);
-                                    invocations[session]->setServiceSettings(getServiceSettings<_Service>(request));
-                                }
-                            }
+            if (_Service::asynchronous)
+                ret = uaf::UnexpectedError("Only synchronous requests can be prepared");
+            else if (request.targets.size() != mask.size())
+                ret = uaf::UnexpectedError("The mask does not match the number of targets");
+            else
+                ret = uaf::statuscodes::Good;
 
-                            if (ret.isGood())
-                            {
-                                logger_->debug("Adding the target");
-                                invocations[session]->addTarget(i, request.targets[i], result.targets[i]);
-                            }
-                        }
-                        else
-                        {
-                            ret = uaf::InvalidServerUriError(serverUri);
-                        }
-                    }
-                }
-            }
+            std::vector< std::pair<uaf::Session*, Invocation*> > invocations;
+            std::vector<uaf::Session*> sessions;
 
-            logger_->debug("A total of %d invocations were built", invocations.size());
+            if (ret.isGood())
+                ret = buildInvocations<_Service>(request, mask, result, invocations, sessions);
 
-            // the UAF currently does NOT support asynchronous communication to multiple sessions
-            // in one request (because the logic to reconstruct the result from multiple
-            // asynchronous invocations is not implemented). Synchronous communication DOES support
-            // this however. So we check here if, in case of an asynchronous request, we don't have
-            // more than one invocation.
-            if (ret.isGood() && async)
+            for (std::size_t i = 0; i < invocations.size(); i++)
             {
-                if (invocations.size() > 1)
-                    ret = uaf::AsyncInvocationOnMultipleSessionsNotSupportedError();
+                Invocation* invocation = invocations[i].second;
+
+                if (ret.isGood())
+                {
+                    uaf::PreparedInvocation<_Service> preparedInvocation;
+                    preparedInvocation.clientConnectionId = invocations[i].first->clientConnectionId();
+                    preparedInvocation.connectionRevision = invocations[i].first->connectionRevision();
+                    preparedInvocation.invocation         = invocation;
+                    invocation->setKeepEncoded(true);
+                    prepared.push_back(preparedInvocation);
+                }
+                else
+                {
+                    delete invocation;
+                }
             }
 
+            // the sessions are identified by their ClientConnectionId from now on
+            for (std::size_t j = 0; j < sessions.size(); j++)
+                releaseSession(sessions[j]);
 
-            // loop through the invocations (while the return Status is good)
-            int invocationIndex = 0; // index to keep track of the number of processed invocations
-            for (typename InvocationMap::iterator it = invocations.begin();
-                 it != invocations.end() && ret.isGood();
-                 ++it)
-            {
-                logger_->debug("Processing invocation %d", invocationIndex);
+            UAF_LOG_DEBUG(logger_, ("%d invocations were prepared", prepared.size()));
 
-                // create a pointer to the current invocation
-                uaf::Session* session = it->first;
-                Invocation*   invocation = it->second;
+            return ret;
+        }
 
-                // set the transactionId if necessary
-                if (handleStored)
-                {
-                    logger_->debug("Copying the transaction id %d to the invocation",transactionId);
-                    invocation->setTransactionId(transactionId);
-                }
 
-                // copy the session information to the invocation
-                logger_->debug("Copying the session information to the invocation");
-                invocation->setSessionInformation(session->sessionInformation());
+        /**
+         * Invoke the invocations that were prepared by prepareRequest().
+         *
+         * The invocations are only invoked if all of their sessions still exist and still have
+         * the same connection revision. If not, the prepared invocations are outdated (e.g.
+         * because a session reconnected and the NamespaceArray of the server may have changed)
+         * and must be prepared again.
+         *
+         * @param request       The (resolved) request that was prepared.
+         * @param prepared      The prepared invocations.
+         * @param result        Output parameter: the result of the invocation (its targets must
+         *                      already have the same size as the targets of the request).
+         * @param outdated      Output parameter: true if the prepared invocations were outdated,
+         *                      in which case nothing was invoked.
+         * @return              Good if the invocation went fine, bad if not.
+         */
+        template<typename _Service>
+        uaf::Status invokePreparedRequest(
+                const typename _Service::Request&                           request,
+                const std::vector< uaf::PreparedInvocation<_Service> >&     prepared,
+                typename _Service::Result&                                  result,
+                bool&                                                       outdated)
+        {
+            typedef typename _Service::Invocation Invocation;
 
-                // if the session is connected, invoke the service
-                if (session->isConnected())
-                {
-                    logger_->debug("Forwarding the invocation to session %d",
-                                   session->clientConnectionId());
-                    ret = session->invokeService<_Service>(request, *invocation);
-                }
-                else
-                    ret = session->sessionInformation().lastConnectionAttemptStatus;
+            UAF_LOG_DEBUG(logger_, ("Invoking prepared %sRequest %d", _Service::name().c_str(), request.requestHandle()));
 
-                // copy all data to the result
-                if (ret.isGood())
+            uaf::Status ret(uaf::statuscodes::Good);
+            outdated = false;
+
+            std::vector< std::pair<uaf::Session*, Invocation*> > invocations;
+            std::vector<uaf::Session*>                           sessions;
+            std::map<uaf::ClientConnectionId, uaf::Session*>     acquiredSessions;
+
+            for (std::size_t i = 0; i < prepared.size() && !outdated; i++)
+            {
+                uaf::Session*& session = acquiredSessions[prepared[i].clientConnectionId];
+
+                if (session == NULL)
                 {
-                    logger_->debug("Copying the invocation data to the result");
-                    ret = invocation->copyToResult(result);
+                    if (acquireExistingSession(prepared[i].clientConnectionId, session).isGood())
+                        sessions.push_back(session);
+                    else
+                        session = NULL;
                 }
 
-                releaseSession(session);
-
-                // don't forget to delete the invocation!!!
-                // (see bugfix https://github.com/uaf/uaf/issues/86)
-                delete invocation;
+                if (session == NULL || session->connectionRevision() != prepared[i].connectionRevision)
+                    outdated = true;
+                else
+                    invocations.push_back(std::make_pair(session, prepared[i].invocation));
+            }
 
-                invocationIndex++;
+            if (outdated)
+            {
+                logger_->debug("The prepared request is outdated");
             }
+            else
+            {
+                std::vector<uaf::Status> invocationStatuses;
+                executeInvocations<_Service>(request, invocations, false, 0, invocationStatuses);
 
-            // clear the InvocationMap
-            invocations.clear();
+                for (std::size_t j = 0; j < invocations.size(); j++)
+                {
+                    uaf::Status invocationStatus = invocationStatuses[j];
 
-            // remove the handle if one was stored, and if there was an unexpected error
-            if (ret.isNotGood() && handleStored)
-            {
-                logger_->debug("Removing the transaction id");
-                // remove the transaction id : request handle pair
-                transactionMapMutex_.lock();            // lock the map
-                transactionMap_.erase(transactionId);   // erase the key
-                transactionMapMutex_.unlock();          // unlock the map
+                    if (invocationStatus.isGood())
+                        invocationStatus = invocations[j].second->copyToResult(result);
+
+                    // the overall status is the status of the first failing invocation
+                    if (ret.isGood())
+                        ret = invocationStatus;
+                }
             }
 
+            // release the sessions
+            for (std::size_t j = 0; j < sessions.size(); j++)
+                releaseSession(sessions[j]);
+
             return ret;
         }
 
@@ -550,9 +703,64 @@ namespace uaf
         typedef std::map<uaf::ClientConnectionId, uaf::Session*>   SessionMap;
         typedef std::map<uaf::ClientConnectionId, Activity>         ActivityMap;
 
+        // define an index to find the sessions by a key that is computed from their server URI
+        // and the fingerprint of their settings (different sessions may have the same key, so
+        // the candidates must still be compared)
+        typedef std::multimap<uint64_t, uaf::Session*>              SessionIndex;
+
         // define a map to relate transaction ids with request handles
         typedef std::map<uaf::TransactionId, uaf::RequestHandle>  TransactionMap;
 
+        // a connection attempt of a new session, which is in progress without holding the
+        // sessionMapMutex_ (so that only the threads that need this particular session have to
+        // wait for it, while the other sessions remain available)
+        struct ConnectionAttempt
+        {
+            ConnectionAttempt() : finished(0), noOfWaiters(0) {}
+
+            // posted once for each waiter, as soon as the attempt has finished
+            UaSemaphore finished;
+            // the number of threads waiting for the attempt (guarded by the sessionMapMutex_)
+            uint32_t    noOfWaiters;
+        };
+
+        // define a map to store the connection attempts in progress
+        typedef std::map<uaf::ClientConnectionId, ConnectionAttempt*> ConnectionAttemptMap;
+
+        // an asynchronous request that was split up into one transaction per invocation
+        struct AsyncRequest
+        {
+            AsyncRequest()
+            : noOfTargets(0), noOfPendingTransactions(0), noOfReceivedTransactions(0) {}
+
+            // the number of targets of the request
+            std::size_t noOfTargets;
+            // the number of transactions that have not completed yet
+            std::size_t noOfPendingTransactions;
+            // the number of transactions of which the result was received from a server
+            std::size_t noOfReceivedTransactions;
+
+            // the reassembled result (only one of them is used, depending on the service)
+            uaf::ReadResult       readResult;
+            uaf::WriteResult      writeResult;
+            uaf::MethodCallResult methodCallResult;
+        };
+
+        // a transaction that handles a part of a split asynchronous request
+        struct AsyncTransaction
+        {
+            AsyncTransaction() : requestTransactionId(0) {}
+
+            // the transaction id that was stored for the whole request
+            uaf::TransactionId       requestTransactionId;
+            // the ranks of the request targets that are handled by this transaction
+            std::vector<std::size_t> ranks;
+        };
+
+        // define the maps to store the split asynchronous requests and their transactions
+        typedef std::map<uaf::TransactionId, AsyncRequest>      AsyncRequestMap;
+        typedef std::map<uaf::TransactionId, AsyncTransaction>  AsyncTransactionMap;
+
 
         /**
          * Acquire a session with the given properties (by getting an existing one, or creating
@@ -573,6 +781,68 @@ namespace uaf
                 uaf::Session*&                 session);
 
 
+        /**
+         * Connect a newly created session (which must be acquired already), while the other
+         * threads that acquire it wait for the result. The sessionMapMutex_ must NOT be locked.
+         *
+         * @param session           The session to connect.
+         * @param attempt           The attempt that was stored for the session in
+         *                          connectionAttempts_.
+         * @param endpointUrl       Endpoint to connect to, or an empty string to connect the
+         *                          session via the discovery process.
+         * @param serverCertificate The certificate of the endpoint (only used if an endpointUrl
+         *                          is given).
+         * @return                  The status of the connection attempt.
+         */
+        uaf::Status connectNewSession(
+                uaf::Session*               session,
+                ConnectionAttempt*          attempt,
+                const std::string&          endpointUrl = std::string(),
+                const uaf::PkiCertificate&  serverCertificate = uaf::PkiCertificate());
+
+
+        /**
+         * Register the calling thread as a waiter for the connection attempt of the given
+         * session, if such an attempt is in progress. The sessionMapMutex_ must be locked.
+         *
+         * @param clientConnectionId    The id of the session.
+         * @return                      The attempt to wait for, or NULL if there is none.
+         */
+        ConnectionAttempt* joinConnectionAttempt(uaf::ClientConnectionId clientConnectionId);
+
+
+        /**
+         * Wait until the given connection attempt has finished (if the attempt is not NULL).
+         * The sessionMapMutex_ must NOT be locked.
+         *
+         * @param attempt   The attempt as returned by joinConnectionAttempt().
+         */
+        void waitForConnectionAttempt(ConnectionAttempt* attempt);
+
+
+        /**
+         * Compute the key of a session in the sessionIndex_.
+         *
+         * @param serverUri             The server URI of the session.
+         * @param settingsFingerprint   The fingerprint of the settings of the session.
+         * @return                      The key.
+         */
+        static uint64_t sessionKey(const std::string& serverUri, uint64_t settingsFingerprint)
+        { return uaf::hashString(serverUri, settingsFingerprint); }
+
+
+        /**
+         * Add a session to the sessionIndex_. The sessionMapMutex_ must be locked.
+         */
+        void indexSession(uaf::Session* session);
+
+
+        /**
+         * Remove a session from the sessionIndex_. The sessionMapMutex_ must be locked.
+         */
+        void unindexSession(uaf::Session* session);
+
+
         /**
          * Acquire an existing session with the given client connection ID.
          *
@@ -736,6 +1006,478 @@ namespace uaf
         }
 
 
+        /**
+         * Acquire the sessions for a request and build the invocations for them.
+         *
+         * @param request       The request to invoke.
+         * @param mask          The mask identifying the targets to be included in the invocations.
+         * @param result        The result, of which the targets are used to initialize the result
+         *                      targets of the invocations.
+         * @param invocations   Output parameter: the new invocations, together with the session to
+         *                      invoke them on. The caller must delete the invocations.
+         * @param sessions      Output parameter: the acquired sessions. The caller must release
+         *                      them.
+         * @return              Good if all targets could be assigned to an invocation.
+         */
+        template<typename _Service>
+        uaf::Status buildInvocations(
+                const typename _Service::Request&                                       request,
+                const uaf::Mask&                                                        mask,
+                const typename _Service::Result&                                        result,
+                std::vector< std::pair<uaf::Session*,
+                                       typename _Service::Invocation*> >&               invocations,
+                std::vector<uaf::Session*>&                                             sessions)
+        {
+            // Invocation details
+            typedef typename _Service::Invocation Invocation;
+            bool async = _Service::asynchronous;
+            uaf::RequestHandle requestHandle = request.requestHandle();
+
+            uaf::Status ret(uaf::statuscodes::Good);
+
+            // the session of each server, with the invocation that may still receive targets and
+            // the maximum number of targets per invocation (0 = no limit)
+            std::map<std::string, uaf::Session*>    serverSessions;
+            std::map<uaf::Session*, Invocation*>    openInvocations;
+            std::map<uaf::Session*, uint32_t>       maxTargets;
+
+            logger_->debug("Building the invocations");
+            for (std::size_t i = 0; i < request.targets.size() && ret.isGood(); i++)
+            {
+                if (mask.isSet(i))
+                {
+                    Session* session = NULL;
+
+                    if (request.clientConnectionIdGiven)
+                    {
+                        logger_->debug("ClientConnectionId %d is given", request.clientConnectionId);
+
+                        // we'll only have 0 or 1 sessions in this case
+                        if (sessions.size() == 0)
+                        {
+                            ret = acquireExistingSession(request.clientConnectionId, session);
+                            if (ret.isGood())
+                                sessions.push_back(session);
+                        }
+                        else
+                        {
+                            session = sessions[0];
+                        }
+                    }
+                    else
+                    {
+                        logger_->debug("Trying to get the serverUri from the target");
+
+                        // we first need to determine the server which hosts the target
+                        std::string serverUri;
+                        if (getServerUriFromTarget(request.targets[i], serverUri).isGood())
+                        {
+                            logger_->debug("ServerUri was found: %s", serverUri.c_str());
+
+                            logger_->debug("Trying to find a scheduled session");
+
+                            // check if the session we need is already scheduled for an invocation
+                            // (within a request, the session settings only depend on the server
+                            // URI, so the server URI identifies the scheduled session)
+                            Session*& serverSession = serverSessions[serverUri];
+
+                            // if the session is not already scheduled, we acquire it first
+                            if (serverSession == NULL)
+                            {
+                                logger_->debug("No session was scheduled, so we acquire one");
+
+                                ret = acquireSession(
+                                        serverUri,
+                                        getSessionSettings<_Service>(request, serverUri),
+                                        serverSession);
+
+                                if (ret.isGood())
+                                    sessions.push_back(serverSession);
+                                else
+                                    serverSession = NULL;
+                            }
+                            else
+                            {
+                                logger_->debug("Found a scheduled session");
+                            }
+
+                            session = serverSession;
+                        }
+                        else
+                        {
+                            ret = uaf::InvalidServerUriError(serverUri);
+                        }
+                    }
+
+                    if (ret.isGood())
+                    {
+                        Invocation*& invocation = openInvocations[session];
+
+                        // an invocation that reached the operation limit of the server is full,
+                        // so the remaining targets are added to a new invocation
+                        if (invocation == NULL)
+                            maxTargets[session] = session->operationLimits().template maxTargets<_Service>();
+                        else if (   maxTargets[session] > 0
+                                 && invocation->requestTargets().size() >= maxTargets[session])
+                            invocation = NULL;
+
+                        if (invocation == NULL)
+                        {
+                            logger_->debug("Scheduling an invocation for this session");
+                            invocation = new Invocation;
+                            invocation->setAsynchronous(async);
+                            invocation->setRequestHandle(requestHandle);
+                            invocation->setServiceSettings(getServiceSettings<_Service>(request));
+                            invocations.push_back(std::make_pair(session, invocation));
+                        }
+
+                        logger_->debug("Adding target %d", i);
+                        invocation->addTarget(i, request.targets[i], result.targets[i]);
+                    }
+                }
+            }
+
+            logger_->debug("A total of %d invocations were built for %d sessions",
+                           invocations.size(), sessions.size());
+
+            return ret;
+        }
+
+
+        /**
+         * Invoke the service for all given invocations, and store the status of each invocation
+         * (in the same order as the invocation vector) in the 'statuses' argument.
+         *
+         * The invocations of a session are distributed over at most
+         * ClientSettings::operationLimitsChunksInFlight "lanes", which each execute their
+         * invocations one after the other. Synchronous invocations to different sessions get
+         * different lanes only if this is enabled by the ClientSettings
+         * (parallelInvocationEnable). If there is more than one lane, they are executed
+         * concurrently by the invocation pool, otherwise they are executed by the calling thread.
+         *
+         * @param request       The request to be invoked.
+         * @param invocations   The invocations, together with the (acquired) sessions.
+         * @param handleStored  True if a transaction id was stored for the request.
+         * @param transactionId The transaction id, only relevant if handleStored is true.
+         * @param statuses      Output parameter: the status of each invocation.
+         */
+        template<typename _Service>
+        void executeInvocations(
+                const typename _Service::Request&                                       request,
+                const std::vector< std::pair<uaf::Session*,
+                                             typename _Service::Invocation*> >&         invocations,
+                bool                                                                    handleStored,
+                uaf::TransactionId                                                      transactionId,
+                std::vector<uaf::Status>&                                               statuses)
+        {
+            typedef ServiceInvocationJob<_Service> Job;
+
+            // the lanes, and the lane + position within the lane of each invocation
+            std::map<std::size_t, Job*> lanes;
+            std::vector<Job*> invocationJobs;
+            std::vector<std::size_t> invocationPositions;
+            std::map<Job*, std::size_t> jobSizes;
+            std::vector<uaf::TransactionId> transactionIds;
+
+            // the number of concurrent invocations per session
+            std::size_t chunksInFlight = database_->clientSettings.operationLimitsChunksInFlight;
+            if (_Service::asynchronous || chunksInFlight == 0)
+                chunksInFlight = 1;
+
+            // synchronous invocations to different sessions may be executed concurrently
+            bool parallelSessions =    !_Service::asynchronous
+                                    && database_->clientSettings.parallelInvocationEnable;
+
+            // an asynchronous request with multiple invocations gets one transaction per invocation
+            bool asyncSplit = handleStored && invocations.size() > 1;
+            if (asyncSplit)
+                storeAsyncRequest(transactionId, request.targets.size(), invocations.size());
+
+            std::map<uaf::Session*, std::size_t> sessionIndices;
+            std::map<uaf::Session*, std::size_t> chunkIndices;
+
+            for (std::size_t i = 0; i < invocations.size(); i++)
+            {
+                uaf::Session* session = invocations[i].first;
+                typename _Service::Invocation* invocation = invocations[i].second;
+
+                logger_->debug("Preparing invocation %d", i);
+
+                // set the transactionId if necessary
+                if (handleStored)
+                {
+                    uaf::TransactionId invocationTransactionId = transactionId;
+
+                    if (asyncSplit)
+                        invocationTransactionId = storeAsyncTransaction(
+                                transactionId,
+                                request.requestHandle(),
+                                invocation->ranks());
+
+                    logger_->debug("Copying the transaction id %d to the invocation",
+                                   invocationTransactionId);
+                    invocation->setTransactionId(invocationTransactionId);
+                    transactionIds.push_back(invocationTransactionId);
+                }
+
+                // copy the session information to the invocation
+                logger_->debug("Copying the session information to the invocation");
+                invocation->setSessionInformation(session->sessionInformation());
+
+                // determine the lane of the invocation
+                std::size_t sessionIndex = sessionIndices.insert(
+                        std::make_pair(session, sessionIndices.size())).first->second;
+                std::size_t lane = (chunkIndices[session]++) % chunksInFlight;
+                if (parallelSessions)
+                    lane += sessionIndex * chunksInFlight;
+
+                Job*& job = lanes[lane];
+                if (job == NULL)
+                    job = new Job(request);
+
+                job->addInvocation(session, invocation);
+                invocationJobs.push_back(job);
+                invocationPositions.push_back(jobSizes[job]++);
+            }
+
+            std::vector<uaf::InvocationJob*> jobPointers;
+            for (typename std::map<std::size_t, Job*>::const_iterator it = lanes.begin();
+                 it != lanes.end();
+                 ++it)
+                jobPointers.push_back(it->second);
+
+            if (jobPointers.size() > 1)
+            {
+                uint32_t maxThreads = parallelSessions
+                                    ? database_->clientSettings.parallelInvocationMaxThreads
+                                    : chunksInFlight;
+
+                logger_->debug("Executing %d invocations in %d parallel lanes",
+                               invocations.size(), jobPointers.size());
+                invocationPool_->executeAll(jobPointers, maxThreads);
+            }
+            else
+            {
+                logger_->debug("Executing %d invocations sequentially", invocations.size());
+                invocationPool_->executeAll(jobPointers, 0);
+            }
+
+            statuses.resize(invocations.size());
+            for (std::size_t i = 0; i < invocations.size(); i++)
+            {
+                statuses[i] = invocationJobs[i]->status(invocationPositions[i]);
+
+                // a transaction that could not be sent will never complete, so we complete it
+                // ourselves to make sure that the reassembled result will still be delivered
+                if (asyncSplit && statuses[i].isNotGood())
+                    asyncTransactionFailed(request, transactionIds[i], statuses[i]);
+            }
+
+            for (std::size_t i = 0; i < jobPointers.size(); i++)
+                delete jobPointers[i];
+        }
+
+
+        /**
+         * Store the bookkeeping of an asynchronous request that is split up into one transaction
+         * per invocation.
+         *
+         * @param requestTransactionId  The transaction id that was stored for the whole request.
+         * @param noOfTargets           The number of targets of the request.
+         * @param noOfTransactions      The number of transactions (i.e. invocations).
+         */
+        void storeAsyncRequest(
+                uaf::TransactionId  requestTransactionId,
+                std::size_t         noOfTargets,
+                std::size_t         noOfTransactions);
+
+
+        /**
+         * Store a new transaction that handles a part of a split asynchronous request.
+         *
+         * @param requestTransactionId  The transaction id that was stored for the whole request.
+         * @param requestHandle         The handle of the request.
+         * @param ranks                 The ranks of the request targets that are handled by this
+         *                              transaction.
+         * @return                      The new transaction id.
+         */
+        uaf::TransactionId storeAsyncTransaction(
+                uaf::TransactionId              requestTransactionId,
+                uaf::RequestHandle              requestHandle,
+                const std::vector<std::size_t>& ranks);
+
+
+        /**
+         * Complete a transaction of a split asynchronous request that could not be sent.
+         *
+         * The overloaded versions for the asynchronous read, write and method call requests feed
+         * the failure into the reassembly of the result, this template catches all other requests
+         * (which have no completion callback).
+         */
+        template<typename _Request>
+        void asyncTransactionFailed(
+                const _Request&       request,
+                uaf::TransactionId    transactionId,
+                const uaf::Status&    status)
+        {}
+        void asyncTransactionFailed(
+                const uaf::AsyncReadRequest&        request,
+                uaf::TransactionId                  transactionId,
+                const uaf::Status&                  status);
+        void asyncTransactionFailed(
+                const uaf::AsyncWriteRequest&       request,
+                uaf::TransactionId                  transactionId,
+                const uaf::Status&                  status);
+        void asyncTransactionFailed(
+                const uaf::AsyncMethodCallRequest&  request,
+                uaf::TransactionId                  transactionId,
+                const uaf::Status&                  status);
+
+
+        /**
+         * Deliver the complete result of an asynchronous request: to its future if one was
+         * registered, or to the client interface if not.
+         *
+         * @param result    The result of the request.
+         */
+        void deliverAsyncResult(const uaf::ReadResult& result);
+        void deliverAsyncResult(const uaf::WriteResult& result);
+        void deliverAsyncResult(const uaf::MethodCallResult& result);
+
+
+        /**
+         * Store a future in one of the future maps.
+         */
+        template<typename _Result>
+        void storeFuture(
+                std::map<uaf::RequestHandle, uaf::Future<_Result> >&    futures,
+                const uaf::Future<_Result>&                             future)
+        {
+            UaMutexLocker locker(&transactionMapMutex_); // unlocks when locker goes out of scope
+            futures[future.requestHandle()] = future;
+        }
+
+
+        /**
+         * Remove the future of the given request from one of the future maps.
+         *
+         * @return True if a future was found (and copied to the 'future' argument).
+         */
+        template<typename _Result>
+        bool takeFuture(
+                std::map<uaf::RequestHandle, uaf::Future<_Result> >&    futures,
+                uaf::RequestHandle                                      requestHandle,
+                uaf::Future<_Result>&                                   future)
+        {
+            UaMutexLocker locker(&transactionMapMutex_); // unlocks when locker goes out of scope
+
+            typename std::map<uaf::RequestHandle, uaf::Future<_Result> >::iterator it;
+            it = futures.find(requestHandle);
+
+            if (it == futures.end())
+                return false;
+
+            future = it->second;
+            futures.erase(it);
+            return true;
+        }
+
+
+        /**
+         * Merge the (partial) result of an asynchronous transaction into the reassembled result
+         * of the request it belongs to.
+         *
+         * @param transactionId     The transaction id of the received result.
+         * @param received          True if the result was received from the server, false if the
+         *                          transaction could not be sent.
+         * @param result            In: the result of the transaction. Out: the complete result of
+         *                          the request, if the return value is true.
+         * @param assembledResult   The member of AsyncRequest that holds the reassembled result.
+         * @return                  True if 'result' is complete and must be delivered to the
+         *                          client interface, false if not (yet).
+         */
+        template<typename _Result>
+        bool assembleAsyncResult(
+                uaf::TransactionId      transactionId,
+                bool                    received,
+                _Result&                result,
+                _Result AsyncRequest::* assembledResult)
+        {
+            UaMutexLocker locker(&transactionMapMutex_); // unlocks when locker goes out of scope
+
+            AsyncTransactionMap::iterator transactionIter = asyncTransactionMap_.find(transactionId);
+
+            // if the transaction is not a part of a split request, the result is complete already
+            if (transactionIter == asyncTransactionMap_.end())
+                return received;
+
+            uaf::TransactionId requestTransactionId = transactionIter->second.requestTransactionId;
+            std::vector<std::size_t> ranks = transactionIter->second.ranks;
+            asyncTransactionMap_.erase(transactionIter);
+            transactionMap_.erase(transactionId);
+
+            AsyncRequestMap::iterator requestIter = asyncRequestMap_.find(requestTransactionId);
+            if (requestIter == asyncRequestMap_.end())
+            {
+                logger_->error("Transaction %d belongs to unknown request transaction %d",
+                               transactionId, requestTransactionId);
+                return false;
+            }
+
+            AsyncRequest& asyncRequest = requestIter->second;
+            _Result& assembled = asyncRequest.*assembledResult;
+
+            if (assembled.targets.size() != asyncRequest.noOfTargets)
+            {
+                assembled.targets.resize(asyncRequest.noOfTargets);
+                assembled.requestHandle = result.requestHandle;
+                assembled.overallStatus = uaf::statuscodes::Good;
+            }
+
+            if (result.targets.size() == ranks.size())
+            {
+                for (std::size_t i = 0; i < ranks.size(); i++)
+                    assembled.targets[ranks[i]] = result.targets[i];
+            }
+            else
+            {
+                uaf::Status targetStatus = result.overallStatus;
+                if (targetStatus.isGood())
+                    targetStatus = uaf::UnexpectedError(
+                            "The number of received targets does not match the transaction");
+
+                for (std::size_t i = 0; i < ranks.size(); i++)
+                    assembled.targets[ranks[i]].status = targetStatus;
+            }
+
+            if (result.overallStatus.isNotGood() && assembled.overallStatus.isGood())
+                assembled.overallStatus = result.overallStatus;
+
+            if (received)
+                asyncRequest.noOfReceivedTransactions++;
+            asyncRequest.noOfPendingTransactions--;
+
+            logger_->debug("Transaction %d of request transaction %d has been reassembled, "
+                           "%d transactions are still pending",
+                           transactionId, requestTransactionId,
+                           asyncRequest.noOfPendingTransactions);
+
+            if (asyncRequest.noOfPendingTransactions > 0)
+                return false;
+
+            // if none of the transactions could be sent, the request has failed already (and the
+            // caller was informed about it), so no callback must be called
+            bool deliver = asyncRequest.noOfReceivedTransactions > 0;
+            if (deliver)
+                result = assembled;
+
+            asyncRequestMap_.erase(requestIter);
+            transactionMap_.erase(requestTransactionId);
+
+            return deliver;
+        }
+
+
         // logger of the session factory
         uaf::Logger* logger_;
         // the client interface to call whenever an asynchronous message is received
@@ -744,6 +1486,8 @@ namespace uaf
         uaf::Discoverer* discoverer_;
         // pointer to the client database
         uaf::Database* database_;
+        // the pool to invoke services on multiple sessions concurrently
+        uaf::InvocationPool* invocationPool_;
 
         // the current transaction id, and a mutex to safely increment it
         uaf::TransactionId  transactionId_;
@@ -753,10 +1497,25 @@ namespace uaf
         TransactionMap transactionMap_;
         UaMutex        transactionMapMutex_;
 
+        // the maps to reassemble split asynchronous requests (also guarded by transactionMapMutex_)
+        AsyncRequestMap     asyncRequestMap_;
+        AsyncTransactionMap asyncTransactionMap_;
+
+        // the futures of asynchronous requests, by request handle (also guarded by
+        // transactionMapMutex_)
+        std::map<uaf::RequestHandle, uaf::Future<uaf::ReadResult> >        readFutures_;
+        std::map<uaf::RequestHandle, uaf::Future<uaf::WriteResult> >       writeFutures_;
+        std::map<uaf::RequestHandle, uaf::Future<uaf::MethodCallResult> >  callFutures_;
+
         // map storing all sessions
         SessionMap sessionMap_;
         // mutex to safely manipulate the sessionMap_
         UaMutex  sessionMapMutex_;
+        // index to find the sessions of the sessionMap_ (guarded by the sessionMapMutex_)
+        SessionIndex sessionIndex_;
+
+        // the connection attempts in progress (guarded by the sessionMapMutex_)
+        ConnectionAttemptMap connectionAttempts_;
 
         // map storing all activity counts
         ActivityMap activityMap_;
@@ -34,7 +34,11 @@ namespace uaf
     : sessionState(uaf::sessionstates::Disconnected),
       serverState(uaf::serverstates::Unknown),
       clientConnectionId(0),
-      lastConnectionAttemptStep(uaf::connectionsteps::ActivateSession)
+      lastConnectionAttemptStep(uaf::connectionsteps::ActivateSession),
+      registeredNodes(0),
+      registeredNodeHits(0),
+      structureDefinitions(0),
+      structureDefinitionHits(0)
     {}
 
 
@@ -54,7 +58,11 @@ namespace uaf
         serverUri(serverUri),
         sessionSettings(sessionSettings),
         lastConnectionAttemptStatus(lastConnectionAttemptStatus),
-        lastConnectionAttemptStep(lastConnectionAttemptStep)
+        lastConnectionAttemptStep(lastConnectionAttemptStep),
+        registeredNodes(0),
+        registeredNodeHits(0),
+        structureDefinitions(0),
+        structureDefinitionHits(0)
     {}
 
 
@@ -89,7 +97,23 @@ namespace uaf
 
         ss << indent << " - lastConnectionAttemptStatus";
         ss << fillToPos(ss, colon);
-        ss << ": " << lastConnectionAttemptStatus.toString();
+        ss << ": " << lastConnectionAttemptStatus.toString() << "\n";
+
+        ss << indent << " - registeredNodes";
+        ss << fillToPos(ss, colon);
+        ss << ": " << registeredNodes << "\n";
+
+        ss << indent << " - registeredNodeHits";
+        ss << fillToPos(ss, colon);
+        ss << ": " << registeredNodeHits << "\n";
+
+        ss << indent << " - structureDefinitions";
+        ss << fillToPos(ss, colon);
+        ss << ": " << structureDefinitions << "\n";
+
+        ss << indent << " - structureDefinitionHits";
+        ss << fillToPos(ss, colon);
+        ss << ": " << structureDefinitionHits;
 
         return ss.str();
     }
@@ -98,6 +98,22 @@ namespace uaf
         /** The step of the last connection attempt. */
         uaf::connectionsteps::ConnectionStep lastConnectionAttemptStep;
 
+        /** The number of nodes that are currently registered (see
+         *  ClientSettings::registerNodesEnable). */
+        uint32_t                            registeredNodes;
+
+        /** The number of times that the alias of a registered node was used instead of the
+         *  original NodeId (see ClientSettings::registerNodesEnable). */
+        uint32_t                            registeredNodeHits;
+
+        /** The number of structure definitions that are currently cached by the session (see
+         *  ClientSettings::structureDefinitionsPreloadNamespaceUris). */
+        uint32_t                            structureDefinitions;
+
+        /** The number of times that a structure definition was taken from the cache of the
+         *  session, instead of being fetched from the server. */
+        uint32_t                            structureDefinitionHits;
+
         /**
          * Get a string representation of the information.
          */
@@ -60,7 +60,31 @@ namespace uaf
       issuersRevocationListLocation("PKI/issuers/crl/"),
       createSecurityLocationsIfNeeded(true),
       clientPrivateKey("PKI/client/private/client.pem"),
-      clientCertificate("PKI/client/certs/client.der")
+      clientCertificate("PKI/client/certs/client.der"),
+      parallelInvocationEnable(false),
+      parallelInvocationMaxThreads(8),
+      operationLimitsChunksInFlight(1),
+      futureMaxThreads(4),
+      readCoalescingEnable(false),
+      readCoalescingWindowMs(1),
+      readCoalescingMaxTargets(100),
+      valueCacheEnable(false),
+      valueCacheMonitoredItemsEnable(false),
+      valueCacheMaxEntries(10000),
+      addressCacheFile(""),
+      addressCacheModelChangeEventsEnable(false),
+      sharedPrefixResolutionEnable(false),
+      resolutionFailureTtlSec(0.0),
+      resolutionFailureMaxTtlSec(300.0),
+      parallelResolutionEnable(false),
+      registerNodesEnable(false),
+      registerNodesMinAccessCount(3),
+      registerNodesMaxNodes(1000),
+      notificationDispatchEnable(false),
+      notificationDispatchThreads(1),
+      notificationDispatchQueueSize(10000),
+      notificationDispatchOverflowPolicy(uaf::overflowpolicies::Block),
+      latestValueStoreEnable(false)
     {}
 
     // Constructor
@@ -83,7 +107,31 @@ namespace uaf
       issuersRevocationListLocation("PKI/issuers/crl/"),
       createSecurityLocationsIfNeeded(true),
       clientPrivateKey("PKI/client/private/client.pem"),
-      clientCertificate("PKI/client/certs/client.der")
+      clientCertificate("PKI/client/certs/client.der"),
+      parallelInvocationEnable(false),
+      parallelInvocationMaxThreads(8),
+      operationLimitsChunksInFlight(1),
+      futureMaxThreads(4),
+      readCoalescingEnable(false),
+      readCoalescingWindowMs(1),
+      readCoalescingMaxTargets(100),
+      valueCacheEnable(false),
+      valueCacheMonitoredItemsEnable(false),
+      valueCacheMaxEntries(10000),
+      addressCacheFile(""),
+      addressCacheModelChangeEventsEnable(false),
+      sharedPrefixResolutionEnable(false),
+      resolutionFailureTtlSec(0.0),
+      resolutionFailureMaxTtlSec(300.0),
+      parallelResolutionEnable(false),
+      registerNodesEnable(false),
+      registerNodesMinAccessCount(3),
+      registerNodesMaxNodes(1000),
+      notificationDispatchEnable(false),
+      notificationDispatchThreads(1),
+      notificationDispatchQueueSize(10000),
+      notificationDispatchOverflowPolicy(uaf::overflowpolicies::Block),
+      latestValueStoreEnable(false)
     {}
 
     // Constructor
@@ -109,7 +157,31 @@ namespace uaf
       issuersRevocationListLocation("PKI/issuers/crl/"),
       createSecurityLocationsIfNeeded(true),
       clientPrivateKey("PKI/client/private/client.pem"),
-      clientCertificate("PKI/client/certs/client.der")
+      clientCertificate("PKI/client/certs/client.der"),
+      parallelInvocationEnable(false),
+      parallelInvocationMaxThreads(8),
+      operationLimitsChunksInFlight(1),
+      futureMaxThreads(4),
+      readCoalescingEnable(false),
+      readCoalescingWindowMs(1),
+      readCoalescingMaxTargets(100),
+      valueCacheEnable(false),
+      valueCacheMonitoredItemsEnable(false),
+      valueCacheMaxEntries(10000),
+      addressCacheFile(""),
+      addressCacheModelChangeEventsEnable(false),
+      sharedPrefixResolutionEnable(false),
+      resolutionFailureTtlSec(0.0),
+      resolutionFailureMaxTtlSec(300.0),
+      parallelResolutionEnable(false),
+      registerNodesEnable(false),
+      registerNodesMinAccessCount(3),
+      registerNodesMaxNodes(1000),
+      notificationDispatchEnable(false),
+      notificationDispatchThreads(1),
+      notificationDispatchQueueSize(10000),
+      notificationDispatchOverflowPolicy(uaf::overflowpolicies::Block),
+      latestValueStoreEnable(false)
     {}
 
 
@@ -332,6 +404,122 @@ namespace uaf
         ss << fillToPos(ss, colon);
         ss << ": " << clientCertificate << "\n";
 
+        ss << indent << " - parallelInvocationEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (parallelInvocationEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - parallelInvocationMaxThreads";
+        ss << fillToPos(ss, colon);
+        ss << ": " << parallelInvocationMaxThreads << "\n";
+
+        ss << indent << " - operationLimitsChunksInFlight";
+        ss << fillToPos(ss, colon);
+        ss << ": " << operationLimitsChunksInFlight << "\n";
+
+        ss << indent << " - futureMaxThreads";
+        ss << fillToPos(ss, colon);
+        ss << ": " << futureMaxThreads << "\n";
+
+        ss << indent << " - readCoalescingEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (readCoalescingEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - readCoalescingWindowMs";
+        ss << fillToPos(ss, colon);
+        ss << ": " << readCoalescingWindowMs << "\n";
+
+        ss << indent << " - readCoalescingMaxTargets";
+        ss << fillToPos(ss, colon);
+        ss << ": " << readCoalescingMaxTargets << "\n";
+
+        ss << indent << " - valueCacheEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (valueCacheEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - valueCacheMonitoredItemsEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (valueCacheMonitoredItemsEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - valueCacheMaxEntries";
+        ss << fillToPos(ss, colon);
+        ss << ": " << valueCacheMaxEntries << "\n";
+
+        ss << indent << " - addressCacheFile";
+        ss << fillToPos(ss, colon);
+        ss << ": " << addressCacheFile << "\n";
+
+        ss << indent << " - addressCacheModelChangeEventsEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (addressCacheModelChangeEventsEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - sharedPrefixResolutionEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (sharedPrefixResolutionEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - resolutionFailureTtlSec";
+        ss << fillToPos(ss, colon);
+        ss << ": " << resolutionFailureTtlSec << "\n";
+
+        ss << indent << " - resolutionFailureMaxTtlSec";
+        ss << fillToPos(ss, colon);
+        ss << ": " << resolutionFailureMaxTtlSec << "\n";
+
+        ss << indent << " - parallelResolutionEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (parallelResolutionEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - registerNodesEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << (registerNodesEnable ? "true" : "false") << "\n";
+
+        ss << indent << " - registerNodesMinAccessCount";
+        ss << fillToPos(ss, colon);
+        ss << ": " << registerNodesMinAccessCount << "\n";
+
+        ss << indent << " - registerNodesMaxNodes";
+        ss << fillToPos(ss, colon);
+        ss << ": " << registerNodesMaxNodes << "\n";
+
+        ss << indent << " - structureDefinitionsPreloadNamespaceUris[]";
+
+        if (structureDefinitionsPreloadNamespaceUris.size() == 0)
+        {
+            ss << fillToPos(ss, colon);
+            ss << ": []\n";
+        }
+        else
+        {
+            ss << "\n";
+
+            for (size_t i = 0; i<structureDefinitionsPreloadNamespaceUris.size(); i++)
+            {
+                ss << indent << "    - " << "structureDefinitionsPreloadNamespaceUris[" << i << "]";
+                fillToPos(ss, colon);
+                ss << ": " << structureDefinitionsPreloadNamespaceUris[i] << "\n";
+            }
+        }
+
+        ss << indent << " - notificationDispatchEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << notificationDispatchEnable << "\n";
+
+        ss << indent << " - notificationDispatchThreads";
+        ss << fillToPos(ss, colon);
+        ss << ": " << notificationDispatchThreads << "\n";
+
+        ss << indent << " - notificationDispatchQueueSize";
+        ss << fillToPos(ss, colon);
+        ss << ": " << notificationDispatchQueueSize << "\n";
+
+        ss << indent << " - notificationDispatchOverflowPolicy";
+        ss << fillToPos(ss, colon);
+        ss << ": " << notificationDispatchOverflowPolicy
+                    << "(" << uaf::overflowpolicies::toString(notificationDispatchOverflowPolicy) << ")" << "\n";
+
+        ss << indent << " - latestValueStoreEnable";
+        ss << fillToPos(ss, colon);
+        ss << ": " << latestValueStoreEnable << "\n";
+
         ss << indent << " - defaultSessionSettings\n";
         ss << defaultSessionSettings.toString(indent + "   ", colon) << "\n";
 
@@ -416,7 +604,32 @@ namespace uaf
                && object1.issuersRevocationListLocation == object2.issuersRevocationListLocation
                && object1.createSecurityLocationsIfNeeded == object2.createSecurityLocationsIfNeeded
                && object1.clientPrivateKey == object2.clientPrivateKey
-               && object1.clientCertificate == object2.clientCertificate;
+               && object1.clientCertificate == object2.clientCertificate
+               && object1.parallelInvocationEnable == object2.parallelInvocationEnable
+               && object1.parallelInvocationMaxThreads == object2.parallelInvocationMaxThreads
+               && object1.operationLimitsChunksInFlight == object2.operationLimitsChunksInFlight
+               && object1.futureMaxThreads == object2.futureMaxThreads
+               && object1.readCoalescingEnable == object2.readCoalescingEnable
+               && object1.readCoalescingWindowMs == object2.readCoalescingWindowMs
+               && object1.readCoalescingMaxTargets == object2.readCoalescingMaxTargets
+               && object1.valueCacheEnable == object2.valueCacheEnable
+               && object1.valueCacheMonitoredItemsEnable == object2.valueCacheMonitoredItemsEnable
+               && object1.addressCacheFile == object2.addressCacheFile
+               && object1.addressCacheModelChangeEventsEnable == object2.addressCacheModelChangeEventsEnable
+               && object1.sharedPrefixResolutionEnable == object2.sharedPrefixResolutionEnable
+               && object1.resolutionFailureTtlSec == object2.resolutionFailureTtlSec
+               && object1.resolutionFailureMaxTtlSec == object2.resolutionFailureMaxTtlSec
+               && object1.parallelResolutionEnable == object2.parallelResolutionEnable
+               && object1.registerNodesEnable == object2.registerNodesEnable
+               && object1.registerNodesMinAccessCount == object2.registerNodesMinAccessCount
+               && object1.registerNodesMaxNodes == object2.registerNodesMaxNodes
+               && object1.structureDefinitionsPreloadNamespaceUris == object2.structureDefinitionsPreloadNamespaceUris
+               && object1.notificationDispatchEnable == object2.notificationDispatchEnable
+               && object1.notificationDispatchThreads == object2.notificationDispatchThreads
+               && object1.notificationDispatchQueueSize == object2.notificationDispatchQueueSize
+               && object1.notificationDispatchOverflowPolicy == object2.notificationDispatchOverflowPolicy
+               && object1.latestValueStoreEnable == object2.latestValueStoreEnable
+               && object1.valueCacheMaxEntries == object2.valueCacheMaxEntries;
     }
 
 
@@ -472,8 +685,58 @@ namespace uaf
             return object1.createSecurityLocationsIfNeeded < object2.createSecurityLocationsIfNeeded;
         else if (object1.clientPrivateKey != object2.clientPrivateKey)
             return object1.clientPrivateKey < object2.clientPrivateKey;
-        else
+        else if (object1.clientCertificate != object2.clientCertificate)
             return object1.clientCertificate < object2.clientCertificate;
+        else if (object1.parallelInvocationEnable != object2.parallelInvocationEnable)
+            return object1.parallelInvocationEnable < object2.parallelInvocationEnable;
+        else if (object1.parallelInvocationMaxThreads != object2.parallelInvocationMaxThreads)
+            return object1.parallelInvocationMaxThreads < object2.parallelInvocationMaxThreads;
+        else if (object1.operationLimitsChunksInFlight != object2.operationLimitsChunksInFlight)
+            return object1.operationLimitsChunksInFlight < object2.operationLimitsChunksInFlight;
+        else if (object1.futureMaxThreads != object2.futureMaxThreads)
+            return object1.futureMaxThreads < object2.futureMaxThreads;
+        else if (object1.readCoalescingEnable != object2.readCoalescingEnable)
+            return object1.readCoalescingEnable < object2.readCoalescingEnable;
+        else if (object1.readCoalescingWindowMs != object2.readCoalescingWindowMs)
+            return object1.readCoalescingWindowMs < object2.readCoalescingWindowMs;
+        else if (object1.readCoalescingMaxTargets != object2.readCoalescingMaxTargets)
+            return object1.readCoalescingMaxTargets < object2.readCoalescingMaxTargets;
+        else if (object1.valueCacheEnable != object2.valueCacheEnable)
+            return object1.valueCacheEnable < object2.valueCacheEnable;
+        else if (object1.valueCacheMonitoredItemsEnable != object2.valueCacheMonitoredItemsEnable)
+            return object1.valueCacheMonitoredItemsEnable < object2.valueCacheMonitoredItemsEnable;
+        else if (object1.addressCacheFile != object2.addressCacheFile)
+            return object1.addressCacheFile < object2.addressCacheFile;
+        else if (object1.addressCacheModelChangeEventsEnable != object2.addressCacheModelChangeEventsEnable)
+            return object1.addressCacheModelChangeEventsEnable < object2.addressCacheModelChangeEventsEnable;
+        else if (object1.sharedPrefixResolutionEnable != object2.sharedPrefixResolutionEnable)
+            return object1.sharedPrefixResolutionEnable < object2.sharedPrefixResolutionEnable;
+        else if (object1.resolutionFailureTtlSec != object2.resolutionFailureTtlSec)
+            return object1.resolutionFailureTtlSec < object2.resolutionFailureTtlSec;
+        else if (object1.resolutionFailureMaxTtlSec != object2.resolutionFailureMaxTtlSec)
+            return object1.resolutionFailureMaxTtlSec < object2.resolutionFailureMaxTtlSec;
+        else if (object1.parallelResolutionEnable != object2.parallelResolutionEnable)
+            return object1.parallelResolutionEnable < object2.parallelResolutionEnable;
+        else if (object1.registerNodesEnable != object2.registerNodesEnable)
+            return object1.registerNodesEnable < object2.registerNodesEnable;
+        else if (object1.registerNodesMinAccessCount != object2.registerNodesMinAccessCount)
+            return object1.registerNodesMinAccessCount < object2.registerNodesMinAccessCount;
+        else if (object1.registerNodesMaxNodes != object2.registerNodesMaxNodes)
+            return object1.registerNodesMaxNodes < object2.registerNodesMaxNodes;
+        else if (object1.structureDefinitionsPreloadNamespaceUris != object2.structureDefinitionsPreloadNamespaceUris)
+            return object1.structureDefinitionsPreloadNamespaceUris < object2.structureDefinitionsPreloadNamespaceUris;
+        else if (object1.notificationDispatchEnable != object2.notificationDispatchEnable)
+            return object1.notificationDispatchEnable < object2.notificationDispatchEnable;
+        else if (object1.notificationDispatchThreads != object2.notificationDispatchThreads)
+            return object1.notificationDispatchThreads < object2.notificationDispatchThreads;
+        else if (object1.notificationDispatchQueueSize != object2.notificationDispatchQueueSize)
+            return object1.notificationDispatchQueueSize < object2.notificationDispatchQueueSize;
+        else if (object1.notificationDispatchOverflowPolicy != object2.notificationDispatchOverflowPolicy)
+            return object1.notificationDispatchOverflowPolicy < object2.notificationDispatchOverflowPolicy;
+        else if (object1.latestValueStoreEnable != object2.latestValueStoreEnable)
+            return object1.latestValueStoreEnable < object2.latestValueStoreEnable;
+        else
+            return object1.valueCacheMaxEntries < object2.valueCacheMaxEntries;
     }
 
 }
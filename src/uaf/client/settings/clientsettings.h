@@ -44,6 +44,7 @@
 #include "uaf/client/settings/historyreadrawmodifiedsettings.h"
 #include "uaf/client/settings/sessionsettings.h"
 #include "uaf/client/settings/subscriptionsettings.h"
+#include "uaf/client/subscriptions/overflowpolicies.h"
 
 
 namespace uaf
@@ -85,6 +86,31 @@ namespace uaf
          *  - createSecurityLocationsIfNeeded : true
          *  - clientPrivateKey : "PKI/client/private/client.pem"
          *  - clientCertificate : "PKI/client/certs/client.der"
+         *  - parallelInvocationEnable : false
+         *  - parallelInvocationMaxThreads : 8
+         *  - operationLimitsChunksInFlight : 1
+         *  - futureMaxThreads : 4
+         *  - readCoalescingEnable : false
+         *  - readCoalescingWindowMs : 1
+         *  - readCoalescingMaxTargets : 100
+         *  - valueCacheEnable : false
+         *  - valueCacheMonitoredItemsEnable : false
+         *  - valueCacheMaxEntries : 10000
+         *  - addressCacheFile : ""
+         *  - addressCacheModelChangeEventsEnable : false
+         *  - sharedPrefixResolutionEnable : false
+         *  - resolutionFailureTtlSec : 0.0
+         *  - resolutionFailureMaxTtlSec : 300.0
+         *  - parallelResolutionEnable : false
+         *  - registerNodesEnable : false
+         *  - registerNodesMinAccessCount : 3
+         *  - registerNodesMaxNodes : 1000
+         *  - structureDefinitionsPreloadNamespaceUris : []
+         *  - notificationDispatchEnable : false
+         *  - notificationDispatchThreads : 1
+         *  - notificationDispatchQueueSize : 10000
+         *  - notificationDispatchOverflowPolicy : uaf::overflowpolicies::Block
+         *  - latestValueStoreEnable : false
          */
         ClientSettings();
 
@@ -234,6 +260,231 @@ namespace uaf
          *  Default: "PKI/client/certs/client.der". */
         std::string clientCertificate;
 
+
+        /////// Invocation ///////
+
+
+        /** If true, the synchronous invocations of a single request to multiple sessions (i.e.
+         *  to multiple servers, or with different session settings) are executed concurrently
+         *  instead of one after the other.
+         *
+         *  Default: false. */
+        bool parallelInvocationEnable;
+
+        /** The maximum number of worker threads that may be used to execute the invocations
+         *  concurrently (only relevant if parallelInvocationEnable is true). These threads are
+         *  started on demand and shared by all requests of the client.
+         *
+         *  Default: 8. */
+        uint32_t parallelInvocationMaxThreads;
+
+        /** Requests with more targets than a server accepts in a single service call (according
+         *  to the OperationLimits that the server exposes) are automatically split up into
+         *  several "chunks". This setting specifies how many synchronous chunks for the same
+         *  session may be in flight at the same time. The default value 1 means that the chunks
+         *  are sent one after the other (so that e.g. writes are still executed in order).
+         *  Asynchronous chunks are always sent immediately.
+         *
+         *  Default: 1. */
+        uint32_t operationLimitsChunksInFlight;
+
+        /** The maximum number of worker threads that execute the futures of synchronous services
+         *  (see e.g. Client::browseAsync()). Futures of services that can be invoked
+         *  asynchronously at the SDK level (see e.g. Client::readAsync()) don't need these
+         *  threads. The threads are started on demand and shared by all futures of the client.
+         *
+         *  Default: 4. */
+        uint32_t futureMaxThreads;
+
+        /** If true, concurrent synchronous read requests with the same settings are coalesced:
+         *  the first request waits at most readCoalescingWindowMs for other requests to join it,
+         *  and then all of their targets are read at once (so typically with a single Read
+         *  service call per session). Each request still gets its own part of the result.
+         *  The first request doesn't wait if no other read request is being processed. If the
+         *  combined read fails as a whole (e.g. because the server of one of the requests
+         *  cannot be reached), each request reads its own targets again.
+         *
+         *  Default: false. */
+        bool readCoalescingEnable;
+
+        /** The maximum time (in milliseconds) that a coalesced read request waits for other
+         *  read requests to join it (only relevant if readCoalescingEnable is true).
+         *
+         *  Default: 1. */
+        uint32_t readCoalescingWindowMs;
+
+        /** The maximum number of targets of coalesced read requests: a coalesced read is sent
+         *  immediately when this number is reached, and requests with more targets are never
+         *  coalesced (only relevant if readCoalescingEnable is true).
+         *
+         *  Default: 100. */
+        uint32_t readCoalescingMaxTargets;
+
+
+        /////// Value cache ///////
+
+
+        /** If true, the values that are read are cached by the client, and synchronous reads
+         *  are answered from this cache when the cached value was received less than
+         *  ReadSettings::maxAgeSec ago (so a maxAgeSec of 0.0 always reads from the server).
+         *  Only the targets that cannot be answered from the cache are read from the server.
+         *  Written values are removed from the cache. Reads with an index range are never
+         *  cached.
+         *
+         *  Default: false. */
+        bool valueCacheEnable;
+
+        /** If true (and if valueCacheEnable is true), the data changes of the monitored items
+         *  are also stored in the value cache.
+         *
+         *  Default: false. */
+        bool valueCacheMonitoredItemsEnable;
+
+        /** The maximum number of values that are cached. When the cache is full, the value that
+         *  was received the longest time ago is removed to make room for a new one.
+         *
+         *  Default: 10000. */
+        uint32_t valueCacheMaxEntries;
+
+
+        /////// Address cache ///////
+
+        /** The file in which the cached addresses are saved when the client is destroyed, and
+         *  from which they are loaded when this setting is changed (e.g. when the client is
+         *  constructed). This way, a restarted client doesn't need to browse the servers again
+         *  to resolve the same relative paths. The cached addresses of a server are discarded
+         *  once the server turns out to have a different NamespaceArray.
+         *  An empty string disables the file.
+         *
+         *  Default: "". */
+        std::string addressCacheFile;
+
+        /** If true, the client monitors the GeneralModelChangeEvents of each connected server
+         *  (via a monitored item on the Server object of the server), and removes only the
+         *  cached addresses that resolve to, or are browsed from, the changed nodes. Without
+         *  this, the cached addresses of a server are only removed when the connection has
+         *  problems.
+         *
+         *  Default: false. */
+        bool addressCacheModelChangeEventsEnable;
+
+        /** If true, the relative paths that are resolved together are first grouped by their
+         *  common prefixes: each distinct prefix where the paths branch off is translated (and
+         *  cached) only once, and the remaining parts of the paths are translated starting from
+         *  the resolved prefixes. This reduces the work of the server considerably when many
+         *  deep relative paths share long prefixes, at the cost of some extra
+         *  TranslateBrowsePathsToNodeIds service calls (one per level of branching).
+         *
+         *  Default: false. */
+        bool sharedPrefixResolutionEnable;
+
+        /** The time (in seconds) that an address which could not be resolved by the server
+         *  (e.g. because the browse path doesn't match any node, or matches multiple nodes) is
+         *  remembered by the client. During this time, the address fails immediately with the
+         *  same status, without translating it again. Each time the address fails again after
+         *  this time, the time is doubled (up to resolutionFailureMaxTtlSec).
+         *  A value of 0.0 disables the caching of failures.
+         *
+         *  Default: 0.0. */
+        double resolutionFailureTtlSec;
+
+        /** The maximum time (in seconds) that an address which could not be resolved is
+         *  remembered (only relevant if resolutionFailureTtlSec is greater than 0.0).
+         *
+         *  Default: 300.0. */
+        double resolutionFailureMaxTtlSec;
+
+        /** If true, the browse paths that are resolved together are translated by each server
+         *  concurrently, and a browse path that continues in another server (because the server
+         *  reported an out-of-server reference) is sent to that other server as soon as the
+         *  partial result has arrived, without waiting for the translations by the other
+         *  servers. The translations are executed by at most parallelInvocationMaxThreads
+         *  worker threads. This reduces the resolution time when browse paths span
+         *  several (e.g. aggregating) servers.
+         *
+         *  Default: false. */
+        bool parallelResolutionEnable;
+
+        /** If true, each session counts how many times the nodes are read or written, and
+         *  registers the nodes that are accessed at least registerNodesMinAccessCount times
+         *  by the server (by means of the RegisterNodes service). The aliases that the server
+         *  returns are then used by the subsequent Read and Write requests, which allows the
+         *  server to access the nodes faster. The nodes are registered again each time the
+         *  session gets (re)connected, and are unregistered (by means of the UnregisterNodes
+         *  service) when the session is disconnected. The number of registered nodes and the number of times
+         *  their aliases were used are exposed by the SessionInformation.
+         *
+         *  Default: false. */
+        bool registerNodesEnable;
+
+        /** The number of times that a node must be read or written within the same session,
+         *  before it gets registered (only relevant if registerNodesEnable is true).
+         *
+         *  Default: 3. */
+        uint32_t registerNodesMinAccessCount;
+
+        /** The maximum number of nodes that are counted (and possibly registered) per session.
+         *  Once this number has been reached, the node that was accessed the longest time ago
+         *  (and that is not about to be registered) is forgotten to make room for a new node,
+         *  and unregistered if it was registered (only relevant if registerNodesEnable is
+         *  true).
+         *
+         *  Default: 1000. */
+        uint32_t registerNodesMaxNodes;
+
+        /** The namespace URIs of which the definitions of all structured datatypes are loaded
+         *  as soon as a session gets (re)connected, so that the first decoding of these
+         *  structures doesn't need to look up their definition. Definitions of other datatypes
+         *  are looked up when they are first needed. In both cases, they are cached until the
+         *  session gets reconnected.
+         *
+         *  Default: empty vector = don't preload any definitions. */
+        std::vector<std::string> structureDefinitionsPreloadNamespaceUris;
+
+        /** If true, the notifications (data changes and events) are not passed to the callbacks
+         *  by the thread that received them from the server, but are queued and passed to the
+         *  callbacks by notificationDispatchThreads dedicated threads. This way, slow callbacks
+         *  don't delay the reception of the next notifications. All notifications of the same
+         *  monitored item (i.e. with the same ClientHandle) are dispatched by the same thread,
+         *  so they are received in the same order as they were sent by the server. The queue
+         *  depth and the number of dropped notifications are exposed by
+         *  Client::notificationDispatchStatistics().
+         *
+         *  Changing this setting (or notificationDispatchThreads) stops the running dispatch
+         *  threads after they have dispatched the queued notifications. The new threads only
+         *  start dispatching once the old ones have finished, so the order is preserved. The
+         *  settings may also be changed from within a notification callback.
+         *
+         *  Default: false. */
+        bool notificationDispatchEnable;
+
+        /** The number of threads that dispatch the notifications (only relevant if
+         *  notificationDispatchEnable is true).
+         *
+         *  Default: 1. */
+        uint32_t notificationDispatchThreads;
+
+        /** The maximum number of notifications that may be queued per dispatch thread (only
+         *  relevant if notificationDispatchEnable is true).
+         *
+         *  Default: 10000. */
+        uint32_t notificationDispatchQueueSize;
+
+        /** What to do when a notification must be queued while the queue of its dispatch thread
+         *  is full (only relevant if notificationDispatchEnable is true). Note that the Block
+         *  policy holds up the thread that receives the notifications from the server.
+         *
+         *  Default: uaf::overflowpolicies::Block. */
+        uaf::overflowpolicies::OverflowPolicy notificationDispatchOverflowPolicy;
+
+        /** True to keep the latest value of every monitored data item in a table, so that it can
+         *  be queried (by ClientHandle or by Address) via Client::latestValue() at any time,
+         *  without having to process the notifications.
+         *
+         *  Default: false. */
+        bool latestValueStoreEnable;
+
+
         /**
          * The Default service settings
          */
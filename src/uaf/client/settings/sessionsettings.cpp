@@ -41,6 +41,15 @@ namespace uaf
 
     }
 
+    // Get a fingerprint
+    // =============================================================================================
+    uint64_t SessionSettings::fingerprint() const
+    {
+        // the string representation contains all settings
+        return hashString(toString());
+    }
+
+
     // Get a string representation
     // =============================================================================================
     string SessionSettings::toString(const string& indent, size_t colon) const
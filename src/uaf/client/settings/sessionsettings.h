@@ -30,6 +30,7 @@
 // UAF
 #include "uaf/util/stringifiable.h"
 #include "uaf/util/handles.h"
+#include "uaf/util/helperfunctions.h"
 #include "uaf/client/settings/sessionsecuritysettings.h"
 #include "uaf/client/settings/readsettings.h"
 
@@ -91,6 +92,17 @@ namespace uaf
         std::string toString(const std::string& indent="", std::size_t colon=26) const;
 
 
+        /**
+         * Get a fingerprint (a hash) of the settings.
+         *
+         * Equal settings always have the same fingerprint, so the fingerprint can be used to
+         * quickly find candidate sessions (which must still be compared with operator==).
+         *
+         * @return  The fingerprint.
+         */
+        uint64_t fingerprint() const;
+
+
         // comparison operators
         friend bool UAF_EXPORT operator< (
                 const SessionSettings& object1,
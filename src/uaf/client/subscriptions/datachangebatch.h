@@ -0,0 +1,131 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_DATACHANGEBATCH_H_
+#define UAF_DATACHANGEBATCH_H_
+
+
+// STD
+#include <vector>
+#include <stdint.h>
+// SDK
+#include "uaclient/uaclientsdk.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/handles.h"
+#include "uaf/util/variant.h"
+#include "uaf/client/clientexport.h"
+
+
+namespace uaf
+{
+
+    /*******************************************************************************************//**
+    * A uaf::DataChangeBatch is a read-only view on all data changes of a single publish response
+    * of a subscription (see uaf::ClientInterface::dataChangeBatchReceived()).
+    *
+    * The view refers directly to the notifications as they were decoded by the SDK, so the
+    * values are not copied unless they are requested by value(). As a consequence, the view
+    * (and any reference it returns) is only valid during the callback.
+    *
+    * Only the notifications of known monitored items are part of the view.
+    *
+    * @ingroup ClientSubscriptions
+    ***********************************************************************************************/
+    class UAF_EXPORT DataChangeBatch
+    {
+    public:
+
+
+        /**
+         * Construct a view on some of the given notifications.
+         *
+         * @param clientSubscriptionHandle  The handle of the subscription that received them.
+         * @param notifications             All notifications of the publish response.
+         * @param indexes                   The indexes of the notifications that are part of
+         *                                  the view.
+         */
+        DataChangeBatch(
+                uaf::ClientSubscriptionHandle   clientSubscriptionHandle,
+                const UaDataNotifications&      notifications,
+                const std::vector<uint32_t>&    indexes);
+
+
+        /**
+         * Get the handle of the subscription that received the data changes.
+         */
+        uaf::ClientSubscriptionHandle clientSubscriptionHandle() const
+        { return clientSubscriptionHandle_; }
+
+
+        /**
+         * Get the number of data changes in the batch.
+         */
+        std::size_t size() const { return indexes_.size(); }
+
+
+        /**
+         * Get the client handle of the monitored item of the i'th data change.
+         */
+        uaf::ClientHandle clientHandle(std::size_t i) const
+        { return notifications_[indexes_[i]].ClientHandle; }
+
+
+        /**
+         * Get the OPC UA status code of the i'th data change (e.g. to check it with
+         * OpcUa_IsGood()).
+         */
+        uint32_t opcUaStatusCode(std::size_t i) const
+        { return notifications_[indexes_[i]].Value.StatusCode; }
+
+
+        /**
+         * Get the i'th data change as it was received (without copying it).
+         */
+        const OpcUa_DataValue& opcUaDataValue(std::size_t i) const
+        { return notifications_[indexes_[i]].Value; }
+
+
+        /**
+         * Decode the value of the i'th data change (which copies the value).
+         *
+         * @param i     The index of the data change.
+         * @return      The value.
+         */
+        uaf::Variant value(std::size_t i) const;
+
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(DataChangeBatch);
+
+
+        // the handle of the subscription
+        uaf::ClientSubscriptionHandle   clientSubscriptionHandle_;
+        // the notifications of the publish response
+        const UaDataNotifications&      notifications_;
+        // the indexes of the notifications that are part of the view
+        const std::vector<uint32_t>&    indexes_;
+    };
+
+
+}
+
+
+#endif /* UAF_DATACHANGEBATCH_H_ */
@@ -39,10 +39,24 @@ namespace uaf
     // Constructor
     // =============================================================================================
     DataChangeNotification::DataChangeNotification()
-    : MonitoredItemNotification()
+    : MonitoredItemNotification(),
+      opcUaStatusCode(OpcUa_Good),
+      sourceTimestamp(0),
+      serverTimestamp(0)
     {}
 
 
+    // Get the status
+    // =============================================================================================
+    Status DataChangeNotification::status() const
+    {
+        if (OpcUa_IsGood(opcUaStatusCode))
+            return Status(statuscodes::Good);
+        else
+            return BadDataReceivedError(SdkStatus(opcUaStatusCode));
+    }
+
+
     // Get a string representation
     // =============================================================================================
     string DataChangeNotification::toString(const string& indent, size_t colon) const
@@ -51,9 +65,21 @@ namespace uaf
 
         ss << MonitoredItemNotification::toString(indent, colon);
         ss << "\n";
-        ss << indent << " - status";
+        ss << indent << " - opcUaStatusCode";
+        ss << fillToPos(ss, colon);
+        ss << ": " << status().toString() << "\n";
+        ss << indent << " - sourceTimestamp";
         ss << fillToPos(ss, colon);
-        ss << ": " << status.toString() << "\n";
+        ss << ": " << sourceTimestamp;
+        if (sourceTimestamp != 0)
+            ss << " (" << DateTime::fromFileTime(sourceTimestamp).toString() << ")";
+        ss << "\n";
+        ss << indent << " - serverTimestamp";
+        ss << fillToPos(ss, colon);
+        ss << ": " << serverTimestamp;
+        if (serverTimestamp != 0)
+            ss << " (" << DateTime::fromFileTime(serverTimestamp).toString() << ")";
+        ss << "\n";
         ss << indent << " - data";
         ss << fillToPos(ss, colon);
         ss << ": " << data.toString();
@@ -66,7 +92,9 @@ namespace uaf
     bool operator==(const DataChangeNotification& object1, const DataChangeNotification& object2)
     {
         return    object1.clientHandle == object2.clientHandle
-               && object1.status == object2.status
+               && object1.opcUaStatusCode == object2.opcUaStatusCode
+               && object1.sourceTimestamp == object2.sourceTimestamp
+               && object1.serverTimestamp == object2.serverTimestamp
                && object1.data == object2.data;
     }
 
@@ -85,8 +113,12 @@ namespace uaf
     {
         if (object1.clientHandle != object2.clientHandle)
             return object1.clientHandle < object2.clientHandle;
-        else if (object1.status != object2.status)
-            return object1.status < object2.status;
+        else if (object1.opcUaStatusCode != object2.opcUaStatusCode)
+            return object1.opcUaStatusCode < object2.opcUaStatusCode;
+        else if (object1.sourceTimestamp != object2.sourceTimestamp)
+            return object1.sourceTimestamp < object2.sourceTimestamp;
+        else if (object1.serverTimestamp != object2.serverTimestamp)
+            return object1.serverTimestamp < object2.serverTimestamp;
         else
             return object1.data < object2.data;
     }
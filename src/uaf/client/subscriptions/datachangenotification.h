@@ -26,10 +26,13 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <stdint.h>
 // SDK
 // UAF
 #include "uaf/util/status.h"
 #include "uaf/util/variant.h"
+#include "uaf/util/datetime.h"
+#include "uaf/util/sdkstatus.h"
 #include "uaf/util/logger.h"
 #include "uaf/util/address.h"
 #include "uaf/util/stringifiable.h"
@@ -58,14 +61,34 @@ namespace uaf
         DataChangeNotification();
 
 
-        /** The status of the data. */
-        uaf::Status status;
+        /** The OPC UA status code of the data, as it was received. */
+        uint32_t opcUaStatusCode;
+
+
+        /** The source timestamp of the data, as it was received (i.e. the number of 100
+         *  nanosecond intervals since 1601-01-01 UTC, see uaf::DateTime::fromFileTime()).
+         *  0 if the server didn't provide it. */
+        uint64_t sourceTimestamp;
+
+
+        /** The server timestamp of the data, as it was received (i.e. the number of 100
+         *  nanosecond intervals since 1601-01-01 UTC, see uaf::DateTime::fromFileTime()).
+         *  0 if the server didn't provide it. */
+        uint64_t serverTimestamp;
 
 
         /** The new data value. */
         uaf::Variant data;
 
 
+        /**
+         * Get the status of the data.
+         *
+         * @return Good if the opcUaStatusCode is good, a BadDataReceivedError if not.
+         */
+        uaf::Status status() const;
+
+
         /**
          * Get a string representation of the data notification.
          */
@@ -0,0 +1,50 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/client/subscriptions/eventbatch.h"
+
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::vector;
+
+
+    // Constructor
+    // =============================================================================================
+    EventBatch::EventBatch(
+            ClientSubscriptionHandle    clientSubscriptionHandle,
+            const UaEventFieldLists&    events,
+            const vector<uint32_t>&     indexes)
+    : clientSubscriptionHandle_(clientSubscriptionHandle),
+      events_(events),
+      indexes_(indexes)
+    {}
+
+
+    // Decode a field
+    // =============================================================================================
+    Variant EventBatch::field(size_t i, size_t j) const
+    {
+        return Variant(events_[indexes_[i]].EventFields[j]);
+    }
+
+}
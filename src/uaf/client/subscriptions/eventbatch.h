@@ -0,0 +1,130 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_EVENTBATCH_H_
+#define UAF_EVENTBATCH_H_
+
+
+// STD
+#include <vector>
+#include <stdint.h>
+// SDK
+#include "uaclient/uaclientsdk.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/handles.h"
+#include "uaf/util/variant.h"
+#include "uaf/client/clientexport.h"
+
+
+namespace uaf
+{
+
+    /*******************************************************************************************//**
+    * A uaf::EventBatch is a read-only view on all events of a single publish response of a
+    * subscription (see uaf::ClientInterface::eventBatchReceived()).
+    *
+    * The view refers directly to the event fields as they were decoded by the SDK, so the
+    * fields are not copied unless they are requested by field(). As a consequence, the view
+    * (and any reference it returns) is only valid during the callback.
+    *
+    * Only the events of known monitored items are part of the view.
+    *
+    * @ingroup ClientSubscriptions
+    ***********************************************************************************************/
+    class UAF_EXPORT EventBatch
+    {
+    public:
+
+
+        /**
+         * Construct a view on some of the given events.
+         *
+         * @param clientSubscriptionHandle  The handle of the subscription that received them.
+         * @param events                    All events of the publish response.
+         * @param indexes                   The indexes of the events that are part of the view.
+         */
+        EventBatch(
+                uaf::ClientSubscriptionHandle   clientSubscriptionHandle,
+                const UaEventFieldLists&        events,
+                const std::vector<uint32_t>&    indexes);
+
+
+        /**
+         * Get the handle of the subscription that received the events.
+         */
+        uaf::ClientSubscriptionHandle clientSubscriptionHandle() const
+        { return clientSubscriptionHandle_; }
+
+
+        /**
+         * Get the number of events in the batch.
+         */
+        std::size_t size() const { return indexes_.size(); }
+
+
+        /**
+         * Get the client handle of the monitored item of the i'th event.
+         */
+        uaf::ClientHandle clientHandle(std::size_t i) const
+        { return events_[indexes_[i]].ClientHandle; }
+
+
+        /**
+         * Get the number of fields of the i'th event.
+         */
+        std::size_t noOfFields(std::size_t i) const
+        { return events_[indexes_[i]].NoOfEventFields; }
+
+
+        /**
+         * Get the j'th field of the i'th event as it was received (without copying it).
+         */
+        const OpcUa_Variant& opcUaField(std::size_t i, std::size_t j) const
+        { return events_[indexes_[i]].EventFields[j]; }
+
+
+        /**
+         * Decode the j'th field of the i'th event (which copies the field).
+         *
+         * @param i     The index of the event.
+         * @param j     The index of the field (as selected by the event filter).
+         * @return      The field.
+         */
+        uaf::Variant field(std::size_t i, std::size_t j) const;
+
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(EventBatch);
+
+
+        // the handle of the subscription
+        uaf::ClientSubscriptionHandle   clientSubscriptionHandle_;
+        // the events of the publish response
+        const UaEventFieldLists&        events_;
+        // the indexes of the events that are part of the view
+        const std::vector<uint32_t>&    indexes_;
+    };
+
+
+}
+
+
+#endif /* UAF_EVENTBATCH_H_ */
@@ -0,0 +1,60 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/client/subscriptions/latestvalue.h"
+
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::string;
+    using std::stringstream;
+
+
+    // Constructor
+    // =============================================================================================
+    LatestValue::LatestValue()
+    : clientHandle(0),
+      sequenceNumber(0)
+    {}
+
+
+    // Get a string representation
+    // =============================================================================================
+    string LatestValue::toString(const string& indent, size_t colon) const
+    {
+        stringstream ss;
+
+        ss << indent << " - clientHandle";
+        ss << fillToPos(ss, colon);
+        ss << ": " << clientHandle << "\n";
+
+        ss << indent << " - sequenceNumber";
+        ss << fillToPos(ss, colon);
+        ss << ": " << sequenceNumber << "\n";
+
+        ss << indent << " - value\n";
+        ss << value.toString(indent + "   ", colon);
+
+        return ss.str();
+    }
+
+}
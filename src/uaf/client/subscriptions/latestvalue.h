@@ -0,0 +1,79 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_LATESTVALUE_H_
+#define UAF_LATESTVALUE_H_
+
+// STD
+#include <string>
+#include <sstream>
+#include <stdint.h>
+// SDK
+// UAF
+#include "uaf/util/stringifiable.h"
+#include "uaf/util/handles.h"
+#include "uaf/util/datavalue.h"
+#include "uaf/client/clientexport.h"
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * A uaf::LatestValue is the most recent value that was received by a monitored data item
+    * (see ClientSettings::latestValueStoreEnable).
+    *
+    * @ingroup ClientSubscriptions
+    ***********************************************************************************************/
+    class UAF_EXPORT LatestValue
+    {
+    public:
+
+
+        /**
+         * Create a LatestValue without a value.
+         */
+        LatestValue();
+
+
+        /** The handle of the monitored item. */
+        uaf::ClientHandle   clientHandle;
+
+        /** The number of values that were received by the monitored item (so 0 if no value
+         *  was received yet). A consumer can compare it with the sequence number of a previous
+         *  LatestValue to find out whether (and how many) values were received in between. */
+        uint32_t            sequenceNumber;
+
+        /** The most recent value, with its status and timestamps. */
+        uaf::DataValue      value;
+
+
+        /**
+         * Get a string representation of the latest value.
+         */
+        std::string toString(const std::string& indent="", std::size_t colon=20) const;
+    };
+
+
+}
+
+
+
+#endif /* UAF_LATESTVALUE_H_ */
@@ -0,0 +1,562 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/client/subscriptions/notificationdispatcher.h"
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::vector;
+    using std::deque;
+    using std::size_t;
+
+
+    // Constructor
+    // =============================================================================================
+    NotificationDispatcher::NotificationDispatcher(LoggerFactory* loggerFactory)
+    : clientInterface_(0),
+      enabled_(false),
+      noOfThreads_(0),
+      queueSize_(0),
+      overflowPolicy_(overflowpolicies::Block),
+      generation_(0),
+      noOfWaitingWorkers_(0),
+      retiredWorkersFinished_(0)
+    {
+        logger_ = new Logger(loggerFactory, "NotificationDispatcher");
+        logger_->debug("The notification dispatcher has been constructed");
+    }
+
+
+    // Destructor
+    // =============================================================================================
+    NotificationDispatcher::~NotificationDispatcher()
+    {
+        stop();
+
+        delete logger_;
+        logger_ = 0;
+    }
+
+
+    // Apply the settings
+    // =============================================================================================
+    void NotificationDispatcher::configure(
+            ClientInterface*        clientInterface,
+            const ClientSettings&   settings)
+    {
+        uint32_t noOfThreads = settings.notificationDispatchThreads > 0 ?
+                               settings.notificationDispatchThreads : 1;
+
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        // the queue sizes and the overflow policy can be changed while the workers are running
+        queueSize_      = settings.notificationDispatchQueueSize > 0 ?
+                          settings.notificationDispatchQueueSize : 1;
+        overflowPolicy_ = settings.notificationDispatchOverflowPolicy;
+
+        deleteFinishedWorkers();
+
+        if (   enabled_         == settings.notificationDispatchEnable
+            && noOfThreads_     == noOfThreads
+            && clientInterface_ == clientInterface)
+            return;
+
+        // changing the number of workers would change the worker of a monitored item, so the
+        // new workers wait until the retired ones have dispatched their queued notifications
+        // (we don't wait for them here, since this function may be called by a callback of a
+        // worker)
+        retireWorkers();
+
+        clientInterface_ = clientInterface;
+        enabled_         = settings.notificationDispatchEnable;
+        noOfThreads_     = noOfThreads;
+
+        if (enabled_)
+            startWorkers();
+    }
+
+
+    // Disable the dispatcher
+    // =============================================================================================
+    void NotificationDispatcher::stop()
+    {
+        vector<Worker*> workers;
+
+        {
+            UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+            enabled_ = false;
+            retireWorkers();
+            workers.swap(retiredWorkers_);
+        }
+
+        if (workers.size() > 0)
+            logger_->debug("Waiting for %d notification dispatch threads", workers.size());
+
+        // the workers need the mutex_ to finish, so it must be unlocked while waiting for them
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            workers[i]->wait();
+
+            UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+            addStatistics(workers[i], stoppedStatistics_);
+            delete workers[i];
+        }
+    }
+
+
+    // Start the workers
+    // =============================================================================================
+    void NotificationDispatcher::startWorkers()
+    {
+        while (workers_.size() < noOfThreads_)
+        {
+            Worker* worker = new Worker(this, clientInterface_, generation_);
+            worker->start();
+            workers_.push_back(worker);
+        }
+
+        generation_++;
+
+        logger_->debug("%d notification dispatch threads have been started", workers_.size());
+    }
+
+
+    // Retire the workers
+    // =============================================================================================
+    void NotificationDispatcher::retireWorkers()
+    {
+        if (workers_.size() == 0)
+            return;
+
+        logger_->debug("Stopping %d notification dispatch threads", workers_.size());
+
+        for (size_t i = 0; i < workers_.size(); i++)
+        {
+            Worker* worker = workers_[i];
+
+            worker->mutex.lock();
+            worker->stopRequested = true;
+            worker->mutex.unlock();
+            worker->itemsAvailable.post(1);
+
+            noOfRunningRetiredWorkers_[worker->generation]++;
+            retiredWorkers_.push_back(worker);
+        }
+
+        workers_.clear();
+    }
+
+
+    // Delete the retired workers that have finished
+    // =============================================================================================
+    void NotificationDispatcher::deleteFinishedWorkers()
+    {
+        vector<Worker*>::iterator it = retiredWorkers_.begin();
+        while (it != retiredWorkers_.end())
+        {
+            if ((*it)->finished)
+            {
+                // the thread has already left its run() method, so this doesn't block
+                (*it)->wait();
+                addStatistics(*it, stoppedStatistics_);
+                delete *it;
+                it = retiredWorkers_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+
+    // Add the counters of a worker
+    // =============================================================================================
+    void NotificationDispatcher::addStatistics(
+            const Worker*                   worker,
+            NotificationDispatchStatistics& statistics)
+    {
+        statistics.dispatchedNotifications += worker->statistics.dispatchedNotifications;
+        statistics.droppedNotifications    += worker->statistics.droppedNotifications;
+        statistics.coalescedNotifications  += worker->statistics.coalescedNotifications;
+        if (worker->statistics.maxQueuedNotifications > statistics.maxQueuedNotifications)
+            statistics.maxQueuedNotifications = worker->statistics.maxQueuedNotifications;
+    }
+
+
+    // A worker has finished
+    // =============================================================================================
+    void NotificationDispatcher::workerFinished(Worker* worker)
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        worker->finished = true;
+
+        std::map<uint32_t, uint32_t>::iterator it
+            = noOfRunningRetiredWorkers_.find(worker->generation);
+
+        if (it != noOfRunningRetiredWorkers_.end() && --(it->second) == 0)
+        {
+            noOfRunningRetiredWorkers_.erase(it);
+
+            // let the waiting workers check if they may start dispatching now
+            if (noOfWaitingWorkers_ > 0)
+            {
+                retiredWorkersFinished_.post(noOfWaitingWorkers_);
+                noOfWaitingWorkers_ = 0;
+            }
+        }
+    }
+
+
+    // Wait for the retired workers of the previous generations
+    // =============================================================================================
+    void NotificationDispatcher::waitForRetiredWorkers(uint32_t generation)
+    {
+        while (true)
+        {
+            {
+                UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+                // the map is sorted, so the first generation is the oldest one
+                if (   noOfRunningRetiredWorkers_.empty()
+                    || noOfRunningRetiredWorkers_.begin()->first >= generation)
+                    return;
+
+                noOfWaitingWorkers_++;
+            }
+
+            retiredWorkersFinished_.wait();
+        }
+    }
+
+
+    // Queue data change notifications
+    // =============================================================================================
+    bool NotificationDispatcher::dispatch(const vector<DataChangeNotification>& notifications)
+    {
+        return dispatchNotifications(notifications, false);
+    }
+
+
+    // Queue event notifications
+    // =============================================================================================
+    bool NotificationDispatcher::dispatch(const vector<EventNotification>& notifications)
+    {
+        return dispatchNotifications(notifications, true);
+    }
+
+
+    // Fill an item
+    // =============================================================================================
+    static void setNotification(
+            const DataChangeNotification&   notification,
+            bool&                           isEvent,
+            DataChangeNotification&         dataChange,
+            EventNotification&)
+    {
+        isEvent    = false;
+        dataChange = notification;
+    }
+
+
+    // Fill an item
+    // =============================================================================================
+    static void setNotification(
+            const EventNotification&    notification,
+            bool&                       isEvent,
+            DataChangeNotification&,
+            EventNotification&          event)
+    {
+        isEvent = true;
+        event   = notification;
+    }
+
+
+    // Queue notifications
+    // =============================================================================================
+    template<typename _Notification>
+    bool NotificationDispatcher::dispatchNotifications(
+            const vector<_Notification>&    notifications,
+            bool                            isEvent)
+    {
+        vector<Worker*>                     workers;
+        uint32_t                            queueSize;
+        overflowpolicies::OverflowPolicy    overflowPolicy;
+        bool                                isEnabled;
+        uint32_t                            generation;
+
+        // acquire the workers, so that they don't stop before we have queued our items (a
+        // blocking enqueue must not keep the mutex_ locked)
+        {
+            UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+            isEnabled  = enabled_ && workers_.size() > 0;
+            generation = generation_;
+
+            if (isEnabled)
+            {
+                workers         = workers_;
+                queueSize       = queueSize_;
+                overflowPolicy  = overflowPolicy_;
+
+                for (size_t i = 0; i < workers.size(); i++)
+                {
+                    UaMutexLocker workerLocker(&workers[i]->mutex);
+                    workers[i]->noOfPosters++;
+                }
+            }
+        }
+
+        if (!isEnabled)
+        {
+            // the caller will pass the notifications to the callback interface itself, which it
+            // may only do after the retired workers have dispatched the older notifications
+            waitForRetiredWorkers(generation);
+            return false;
+        }
+
+        // sort the notifications per worker, keeping their order
+        vector< vector<Item> > items(workers.size());
+        for (size_t i = 0; i < notifications.size(); i++)
+        {
+            Item item;
+            setNotification(notifications[i], item.isEvent, item.dataChange, item.event);
+            items[notifications[i].clientHandle % workers.size()].push_back(item);
+        }
+
+        // queue the items (the workers are released even if they don't get any items)
+        for (size_t i = 0; i < workers.size(); i++)
+            enqueue(workers[i], items[i], queueSize, overflowPolicy);
+
+        return true;
+    }
+
+
+    // Queue the items of a single worker
+    // =============================================================================================
+    void NotificationDispatcher::enqueue(
+            Worker*                             worker,
+            vector<Item>&                       items,
+            uint32_t                            queueSize,
+            overflowpolicies::OverflowPolicy    overflowPolicy)
+    {
+        worker->mutex.lock();
+
+        for (size_t i = 0; i < items.size(); i++)
+        {
+            Item& item = items[i];
+            bool isQueued = false;
+
+            while (!isQueued && worker->queue.size() >= queueSize)
+            {
+                if (overflowPolicy == overflowpolicies::Block)
+                {
+                    // wait until the worker has taken the queued items (the items of this call
+                    // may not have been announced to the worker yet)
+                    worker->noOfBlockedPosters++;
+                    worker->mutex.unlock();
+                    worker->itemsAvailable.post(1);
+                    worker->spaceAvailable.wait();
+                    worker->mutex.lock();
+                    continue;
+                }
+
+                if (overflowPolicy == overflowpolicies::CoalesceLatest && !item.isEvent)
+                {
+                    // replace the queued data change of the same monitored item, if any
+                    std::map<ClientHandle, uint32_t>::const_iterator it
+                        = worker->queuedDataChanges.find(item.dataChange.clientHandle);
+
+                    if (it != worker->queuedDataChanges.end())
+                    {
+                        Item& queuedItem = worker->queue[it->second - worker->firstSequenceNumber];
+                        queuedItem.dataChange = item.dataChange;
+                        worker->statistics.coalescedNotifications++;
+                        isQueued = true;
+                        continue;
+                    }
+                }
+
+                // drop the oldest item
+                const Item& oldestItem = worker->queue.front();
+                if (!oldestItem.isEvent)
+                {
+                    std::map<ClientHandle, uint32_t>::iterator it
+                        = worker->queuedDataChanges.find(oldestItem.dataChange.clientHandle);
+                    if (it != worker->queuedDataChanges.end()
+                            && it->second == oldestItem.sequenceNumber)
+                        worker->queuedDataChanges.erase(it);
+                }
+                worker->queue.pop_front();
+                worker->firstSequenceNumber++;
+                worker->statistics.droppedNotifications++;
+            }
+
+            if (isQueued)
+                continue;
+
+            item.sequenceNumber = worker->firstSequenceNumber + worker->queue.size();
+            worker->queue.push_back(item);
+
+            if (!item.isEvent && overflowPolicy == overflowpolicies::CoalesceLatest)
+                worker->queuedDataChanges[item.dataChange.clientHandle] = item.sequenceNumber;
+
+            if (worker->queue.size() > worker->statistics.maxQueuedNotifications)
+                worker->statistics.maxQueuedNotifications = worker->queue.size();
+        }
+
+        // release the worker (a retired worker may stop once all posters have released it)
+        worker->noOfPosters--;
+
+        worker->mutex.unlock();
+        worker->itemsAvailable.post(1);
+    }
+
+
+    // Get the statistics
+    // =============================================================================================
+    NotificationDispatchStatistics NotificationDispatcher::statistics()
+    {
+        UaMutexLocker locker(&mutex_); // unlocks when locker goes out of scope
+
+        NotificationDispatchStatistics ret = stoppedStatistics_;
+        ret.noOfThreads = workers_.size();
+
+        // the retired workers may still be dispatching notifications
+        vector<Worker*> workers(workers_);
+        workers.insert(workers.end(), retiredWorkers_.begin(), retiredWorkers_.end());
+
+        for (size_t i = 0; i < workers.size(); i++)
+        {
+            UaMutexLocker workerLocker(&workers[i]->mutex);
+            ret.queuedNotifications += workers[i]->queue.size();
+            addStatistics(workers[i], ret);
+        }
+
+        return ret;
+    }
+
+
+    // Worker constructor
+    // =============================================================================================
+    NotificationDispatcher::Worker::Worker(
+            NotificationDispatcher* dispatcher,
+            ClientInterface*        clientInterface,
+            uint32_t                generation)
+    : firstSequenceNumber(0),
+      itemsAvailable(0),
+      spaceAvailable(0),
+      noOfBlockedPosters(0),
+      noOfPosters(0),
+      stopRequested(false),
+      generation(generation),
+      finished(false),
+      dispatcher_(dispatcher),
+      clientInterface_(clientInterface)
+    {}
+
+
+    // Run a worker thread
+    // =============================================================================================
+    void NotificationDispatcher::Worker::run()
+    {
+        // the notifications that are still queued for the retired workers must be dispatched
+        // first
+        dispatcher_->waitForRetiredWorkers(generation);
+
+        bool stop = false;
+
+        while (!stop)
+        {
+            itemsAvailable.wait();
+
+            // take all queued items at once, so the posters are blocked as briefly as possible
+            deque<Item> items;
+
+            mutex.lock();
+            items.swap(queue);
+            firstSequenceNumber += items.size();
+            queuedDataChanges.clear();
+            if (noOfBlockedPosters > 0)
+            {
+                spaceAvailable.post(noOfBlockedPosters);
+                noOfBlockedPosters = 0;
+            }
+            // once stopped, no new posters can acquire this worker, so we may stop as soon as
+            // the current ones have released it
+            stop = stopRequested && noOfPosters == 0;
+            mutex.unlock();
+
+            if (items.size() > 0)
+            {
+                deliver(items);
+
+                mutex.lock();
+                statistics.dispatchedNotifications += items.size();
+                mutex.unlock();
+            }
+        }
+
+        dispatcher_->workerFinished(this);
+    }
+
+
+    // Pass the items to the callback interface
+    // =============================================================================================
+    void NotificationDispatcher::Worker::deliver(const deque<Item>& items)
+    {
+        vector<DataChangeNotification> dataChanges;
+        vector<EventNotification> events;
+
+        for (deque<Item>::const_iterator it = items.begin(); it != items.end(); ++it)
+        {
+            // consecutive items of the same kind are passed in a single call
+            if (it->isEvent)
+            {
+                if (dataChanges.size() > 0)
+                {
+                    clientInterface_->dataChangesReceived(dataChanges);
+                    dataChanges.clear();
+                }
+                events.push_back(it->event);
+            }
+            else
+            {
+                if (events.size() > 0)
+                {
+                    clientInterface_->eventsReceived(events);
+                    events.clear();
+                }
+                dataChanges.push_back(it->dataChange);
+            }
+        }
+
+        if (dataChanges.size() > 0)
+            clientInterface_->dataChangesReceived(dataChanges);
+        if (events.size() > 0)
+            clientInterface_->eventsReceived(events);
+    }
+
+
+}
@@ -0,0 +1,262 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_NOTIFICATIONDISPATCHER_H_
+#define UAF_NOTIFICATIONDISPATCHER_H_
+
+
+// STD
+#include <deque>
+#include <map>
+#include <vector>
+// SDK
+#include "uabase/uamutex.h"
+#include "uabase/uasemaphore.h"
+#include "uabase/uathread.h"
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/logger.h"
+#include "uaf/util/handles.h"
+#include "uaf/client/clientexport.h"
+#include "uaf/client/clientinterface.h"
+#include "uaf/client/settings/clientsettings.h"
+#include "uaf/client/subscriptions/datachangenotification.h"
+#include "uaf/client/subscriptions/eventnotification.h"
+#include "uaf/client/subscriptions/overflowpolicies.h"
+#include "uaf/client/subscriptions/notificationdispatchstatistics.h"
+
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+    * An uaf::NotificationDispatcher queues the notifications that were received by the
+    * subscriptions, and passes them to the callback interface by means of a number of dedicated
+    * threads (see ClientSettings::notificationDispatchEnable).
+    *
+    * Each thread has its own bounded queue. The notifications of a monitored item are always
+    * queued for the same thread (the one with index ClientHandle % number of threads), so they
+    * are dispatched in the same order as they were received.
+    *
+    * When the threads are replaced (because the settings were changed), the old threads are
+    * "retired": they dispatch the notifications that are still queued (or still being queued)
+    * for them, and the new threads wait for them before dispatching anything. The retired threads
+    * are never waited for by configure(), so the settings can even be changed by a callback
+    * that is being called by one of the dispatch threads.
+    *
+    * @ingroup ClientSubscriptions
+    ***********************************************************************************************/
+    class UAF_EXPORT NotificationDispatcher
+    {
+    public:
+
+
+        /**
+         * Construct a (disabled) notification dispatcher.
+         *
+         * @param loggerFactory Logger factory to log all messages to.
+         */
+        NotificationDispatcher(uaf::LoggerFactory* loggerFactory);
+
+
+        /**
+         * Destruct the notification dispatcher, and stop all dispatch threads.
+         */
+        virtual ~NotificationDispatcher();
+
+
+        /**
+         * Apply the notificationDispatch* client settings.
+         *
+         * If the dispatcher gets disabled or if the number of threads changes, the running
+         * threads are retired, i.e. they stop after they have dispatched their queued
+         * notifications (without waiting for them).
+         *
+         * @param clientInterface   The interface to pass the notifications to.
+         * @param settings          The client settings.
+         */
+        void configure(uaf::ClientInterface* clientInterface, const uaf::ClientSettings& settings);
+
+
+        /**
+         * Queue the given data change notifications.
+         *
+         * @param notifications The notifications to dispatch.
+         * @return              False if the dispatcher is disabled, in which case the caller
+         *                      must pass the notifications to the callback interface itself
+         *                      (if the dispatcher was disabled recently, this function first
+         *                      waits until the queued notifications have been dispatched).
+         */
+        bool dispatch(const std::vector<uaf::DataChangeNotification>& notifications);
+
+
+        /**
+         * Queue the given event notifications.
+         *
+         * @param notifications The notifications to dispatch.
+         * @return              False if the dispatcher is disabled, in which case the caller
+         *                      must pass the notifications to the callback interface itself
+         *                      (if the dispatcher was disabled recently, this function first
+         *                      waits until the queued notifications have been dispatched).
+         */
+        bool dispatch(const std::vector<uaf::EventNotification>& notifications);
+
+
+        /**
+         * Disable the dispatcher, and wait until the dispatch threads have dispatched their
+         * queued notifications and have stopped.
+         *
+         * This function must not be called by the callbacks of the dispatch threads.
+         */
+        void stop();
+
+
+        /**
+         * Get the current statistics of the dispatcher.
+         *
+         * @return The queue depth and the counters of the dispatched and dropped notifications.
+         */
+        uaf::NotificationDispatchStatistics statistics();
+
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(NotificationDispatcher);
+
+
+        // a queued notification (either a data change or an event)
+        struct Item
+        {
+            Item() : isEvent(false), sequenceNumber(0) {}
+            bool                        isEvent;
+            uaf::DataChangeNotification dataChange;
+            uaf::EventNotification      event;
+            uint32_t                    sequenceNumber;
+        };
+
+        // a dispatch thread, with its own queue
+        class Worker : public UaThread
+        {
+        public:
+            Worker(
+                    NotificationDispatcher* dispatcher,
+                    uaf::ClientInterface*   clientInterface,
+                    uint32_t                generation);
+            void run();
+
+            // the queued items, and the sequence number of the item at the front of the queue
+            std::deque<Item>    queue;
+            uint32_t            firstSequenceNumber;
+            // the sequence numbers of the queued data changes (to coalesce them)
+            std::map<uaf::ClientHandle, uint32_t> queuedDataChanges;
+            // the lock of the queue, and the semaphores to wait for items or for free space
+            UaMutex             mutex;
+            UaSemaphore         itemsAvailable;
+            UaSemaphore         spaceAvailable;
+            uint32_t            noOfBlockedPosters;
+            // the number of dispatch() calls that may still queue items for this worker
+            uint32_t            noOfPosters;
+            bool                stopRequested;
+            // the counters of this thread
+            uaf::NotificationDispatchStatistics statistics;
+            // the workers that were started by the same configure() call have the same generation
+            const uint32_t      generation;
+            // true once the thread has finished (protected by the mutex_ of the dispatcher)
+            bool                finished;
+
+        private:
+            // pass the items to the callback interface, in the same order
+            void deliver(const std::deque<Item>& items);
+
+            NotificationDispatcher* dispatcher_;
+            uaf::ClientInterface*   clientInterface_;
+        };
+
+
+        // queue the items for the given notifications (which are either data changes or events)
+        template<typename _Notification>
+        bool dispatchNotifications(const std::vector<_Notification>& notifications, bool isEvent);
+
+        // queue the items for a single worker, and release the worker (which must have been
+        // acquired by dispatchNotifications)
+        void enqueue(
+                Worker*                                 worker,
+                std::vector<Item>&                      items,
+                uint32_t                                queueSize,
+                uaf::overflowpolicies::OverflowPolicy   overflowPolicy);
+
+        // ask the workers to stop, and move them to the retired workers (mutex_ must be locked)
+        void retireWorkers();
+
+        // start the configured number of workers (mutex_ must be locked)
+        void startWorkers();
+
+        // delete the retired workers that have finished (mutex_ must be locked)
+        void deleteFinishedWorkers();
+
+        // add the counters of a worker to the given statistics
+        static void addStatistics(
+                const Worker*                           worker,
+                uaf::NotificationDispatchStatistics&    statistics);
+
+        // called by a worker when it has finished
+        void workerFinished(Worker* worker);
+
+        // called by a worker before it dispatches anything, to wait for the retired workers of
+        // the previous generations
+        void waitForRetiredWorkers(uint32_t generation);
+
+
+        // logger of the dispatcher
+        uaf::Logger*            logger_;
+
+        // the configuration
+        uaf::ClientInterface*   clientInterface_;
+        bool                    enabled_;
+        uint32_t                noOfThreads_;
+        uint32_t                queueSize_;
+        uaf::overflowpolicies::OverflowPolicy overflowPolicy_;
+
+        // the dispatch threads, and the generation of the next threads to start
+        std::vector<Worker*>    workers_;
+        uint32_t                generation_;
+
+        // the threads that were asked to stop, and the number of them that are still running
+        // per generation
+        std::vector<Worker*>    retiredWorkers_;
+        std::map<uint32_t, uint32_t> noOfRunningRetiredWorkers_;
+
+        // the new workers that wait for the retired workers of the previous generations
+        uint32_t                noOfWaitingWorkers_;
+        UaSemaphore             retiredWorkersFinished_;
+
+        // the counters of the workers that were already stopped
+        uaf::NotificationDispatchStatistics stoppedStatistics_;
+
+        // mutex to protect the members (never locked while waiting for a queue)
+        UaMutex                 mutex_;
+    };
+
+
+}
+
+
+#endif /* UAF_NOTIFICATIONDISPATCHER_H_ */
@@ -0,0 +1,77 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/client/subscriptions/notificationdispatchstatistics.h"
+
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::string;
+    using std::stringstream;
+
+
+    // Constructor
+    // =============================================================================================
+    NotificationDispatchStatistics::NotificationDispatchStatistics()
+    : noOfThreads(0),
+      queuedNotifications(0),
+      maxQueuedNotifications(0),
+      dispatchedNotifications(0),
+      droppedNotifications(0),
+      coalescedNotifications(0)
+    {}
+
+
+    // Get a string representation
+    // =============================================================================================
+    string NotificationDispatchStatistics::toString(const string& indent, size_t colon) const
+    {
+        stringstream ss;
+
+        ss << indent << " - noOfThreads";
+        ss << fillToPos(ss, colon);
+        ss << ": " << noOfThreads << "\n";
+
+        ss << indent << " - queuedNotifications";
+        ss << fillToPos(ss, colon);
+        ss << ": " << queuedNotifications << "\n";
+
+        ss << indent << " - maxQueuedNotifications";
+        ss << fillToPos(ss, colon);
+        ss << ": " << maxQueuedNotifications << "\n";
+
+        ss << indent << " - dispatchedNotifications";
+        ss << fillToPos(ss, colon);
+        ss << ": " << dispatchedNotifications << "\n";
+
+        ss << indent << " - droppedNotifications";
+        ss << fillToPos(ss, colon);
+        ss << ": " << droppedNotifications << "\n";
+
+        ss << indent << " - coalescedNotifications";
+        ss << fillToPos(ss, colon);
+        ss << ": " << coalescedNotifications;
+
+        return ss.str();
+    }
+
+}
@@ -0,0 +1,88 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_NOTIFICATIONDISPATCHSTATISTICS_H_
+#define UAF_NOTIFICATIONDISPATCHSTATISTICS_H_
+
+
+// STD
+#include <string>
+#include <sstream>
+#include <stdint.h>
+// SDK
+// UAF
+#include "uaf/util/util.h"
+#include "uaf/util/stringifiable.h"
+#include "uaf/client/clientexport.h"
+
+
+namespace uaf
+{
+
+    /*******************************************************************************************//**
+    * A uaf::NotificationDispatchStatistics object holds the counters of the threads that dispatch
+    * the notifications to the callbacks (see ClientSettings::notificationDispatchEnable).
+    *
+    * All counters (except queuedNotifications) are accumulated since the client was created.
+    *
+    * @ingroup ClientSubscriptions
+    ***********************************************************************************************/
+    class UAF_EXPORT NotificationDispatchStatistics
+    {
+    public:
+
+
+        /**
+         * Construct statistics with all counters set to zero.
+         */
+        NotificationDispatchStatistics();
+
+
+        /** The number of notification dispatch threads that are currently running. */
+        uint32_t noOfThreads;
+
+        /** The number of notifications that are currently queued. */
+        uint32_t queuedNotifications;
+
+        /** The highest number of notifications that was ever queued by a single thread. */
+        uint32_t maxQueuedNotifications;
+
+        /** The number of notifications that were passed to the callbacks. */
+        uint32_t dispatchedNotifications;
+
+        /** The number of notifications that were dropped because a queue was full. */
+        uint32_t droppedNotifications;
+
+        /** The number of data change notifications that were replaced by a newer one of the same
+         *  monitored item because a queue was full. */
+        uint32_t coalescedNotifications;
+
+
+        /**
+         * Get a string representation of the statistics.
+         */
+        std::string toString(const std::string& indent="", std::size_t colon=26) const;
+    };
+
+
+}
+
+
+#endif /* UAF_NOTIFICATIONDISPATCHSTATISTICS_H_ */
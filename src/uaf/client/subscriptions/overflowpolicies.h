@@ -0,0 +1,66 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_OVERFLOWPOLICIES_H_
+#define UAF_OVERFLOWPOLICIES_H_
+
+// STD
+#include <string>
+#include <stdint.h>
+// SDK
+// UAF
+#include "uaf/util/util.h"
+
+namespace uaf
+{
+
+
+    namespace overflowpolicies
+    {
+
+        /**
+         * The policy to follow when the queue of a notification dispatch thread is full.
+         *
+         * @ingroup ClientSubscriptions
+         */
+        enum OverflowPolicy
+        {
+            Block          = 0, /**< Block the thread that received the notifications until there is space in the queue. */
+            DropOldest     = 1, /**< Drop the oldest queued notification. */
+            CoalesceLatest = 2  /**< Replace the queued data change notification of the same monitored item (if any), otherwise drop the oldest queued notification. */
+        };
+
+
+        /**
+         * Get a string representation of the overflow policy.
+         *
+         * @param policy The overflow policy (as an enum).
+         * @return       The corresponding name of the overflow policy.
+         *
+         * @ingroup ClientSubscriptions
+         */
+        std::string UAF_EXPORT toString(uaf::overflowpolicies::OverflowPolicy policy);
+
+    }
+
+}
+
+
+#endif /* UAF_OVERFLOWPOLICIES_H_ */
@@ -61,7 +61,7 @@ namespace uaf
 
         logger_->debug("Subscription %d has been constructed", clientSubscriptionHandle);
         logger_->debug("Subscription settings:");
-        logger_->debug(subscriptionSettings.toString());
+        UAF_LOG_DEBUG(logger_, (subscriptionSettings.toString()));
     }
 
 
@@ -162,9 +162,14 @@ namespace uaf
             // remove the notification buffer according to the kind
             if (it->second.settings.kind() == MonitoredItemSettings::Data)
             {
+                database_->valueCache.removeMonitoredItem(it->first);
+
                 if (deletePersistentRequest)
+                {
+                    database_->latestValueStore.removeItem(it->first);
                     database_->createMonitoredDataRequestStore.remove(
                             it->second.requestHandle);
+                }
                 else
                     database_->createMonitoredDataRequestStore.updateTargetStatus(
                             it->second.requestHandle,
@@ -174,8 +179,11 @@ namespace uaf
             else
             {
                 if (deletePersistentRequest)
+                {
+                    database_->addressCache.removeModelChangeMonitoredItem(it->first);
                     database_->createMonitoredEventsRequestStore.remove(
                             it->second.requestHandle);
+                }
                 else
                     database_->createMonitoredEventsRequestStore.updateTargetStatus(
                             it->second.requestHandle,
@@ -295,7 +303,7 @@ namespace uaf
                 ret = SetMonitoringModeInvocationError(sdkStatus);
 
 
-            logger_->debug("Result of OPC UA service call: %s", ret.toString().c_str());
+            UAF_LOG_DEBUG(logger_, ("Result of OPC UA service call: %s", ret.toString().c_str()));
 
             if (ret.isGood())
             {
@@ -409,42 +417,80 @@ namespace uaf
         // get the number of notifications
         uint32_t noOfNotifications = dataNotifications.length();
 
-        // create the notifications
-        vector<DataChangeNotification> notifications;
-
         logger_->debug("A total of %d data notifications were received", noOfNotifications);
 
-        // fill the notifications
+        bool updateValueCache = database_->clientSettings.valueCacheEnable
+                             && database_->clientSettings.valueCacheMonitoredItemsEnable;
+        bool updateLatestValues = database_->clientSettings.latestValueStoreEnable;
+
+        // select the notifications of the known monitored items
+        notificationIndexes_.clear();
         for (uint32_t i=0; i < noOfNotifications; i++)
         {
             ClientHandle clientHandle = dataNotifications[i].ClientHandle;
 
-            MonitoredItemsMap::const_iterator it = monitoredItemsMap_.find(clientHandle);
+            if (monitoredItemsMap_.find(clientHandle) == monitoredItemsMap_.end())
+                continue;
 
-            // update the contents of the notification
-            if (it != monitoredItemsMap_.end())
+            notificationIndexes_.push_back(i);
+
+            // update the value cache and the latest value store, if needed
+            if (updateValueCache || updateLatestValues)
             {
-                DataChangeNotification notification;
+                DataValue value(Variant(dataNotifications[i].Value.Value),
+                                dataNotifications[i].Value.StatusCode);
+                value.sourceTimestamp.fromSdk(UaDateTime(dataNotifications[i].Value.SourceTimestamp));
+                value.serverTimestamp.fromSdk(UaDateTime(dataNotifications[i].Value.ServerTimestamp));
+
+                if (updateValueCache)
+                    database_->valueCache.update(
+                            clientHandle,
+                            value,
+                            database_->clientSettings.valueCacheMaxEntries);
+
+                if (updateLatestValues)
+                    database_->latestValueStore.update(clientHandle, value);
+            }
+        }
 
-                notification.clientHandle       = clientHandle;
-                notification.data               = dataNotifications[i].Value.Value;
+        // offer all notifications at once to the batch callback, without copying them
+        DataChangeBatch batch(clientSubscriptionHandle_, dataNotifications, notificationIndexes_);
+        if (clientInterface_->dataChangeBatchReceived(batch))
+            return;
 
-                if (OpcUa_IsGood(dataNotifications[i].Value.StatusCode))
-                    notification.status = statuscodes::Good;
-                else
-                    notification.status = BadDataReceivedError(SdkStatus(dataNotifications[i].Value.StatusCode));
+        // create the notifications
+        vector<DataChangeNotification> notifications;
+        notifications.reserve(notificationIndexes_.size());
+
+        // fill the notifications
+        for (vector<uint32_t>::const_iterator it = notificationIndexes_.begin();
+             it != notificationIndexes_.end();
+             ++it)
+        {
+            uint32_t i = *it;
+
+            DataChangeNotification notification;
+
+            notification.clientHandle       = dataNotifications[i].ClientHandle;
+            notification.opcUaStatusCode    = dataNotifications[i].Value.StatusCode;
+            notification.sourceTimestamp    = uint64_t(UaDateTime(dataNotifications[i].Value.SourceTimestamp));
+            notification.serverTimestamp    = uint64_t(UaDateTime(dataNotifications[i].Value.ServerTimestamp));
+            notification.data               = dataNotifications[i].Value.Value;
 
-                // add it to the vector of notifications for the callback
-                notifications.push_back(notification);
+            // add it to the vector of notifications for the callback
+            notifications.push_back(notification);
 
-                // log the notification
+            // log the notification
+            if (logger_->isDebugEnabled())
+            {
                 logger_->debug(" - Notification %d:", int(i));
                 logger_->debug(notification.toString("   ", 25));
             }
         }
 
-        // call the callback interface
-        clientInterface_->dataChangesReceived(notifications);
+        // call the callback interface, unless the dispatcher will do it
+        if (!database_->notificationDispatcher.dispatch(notifications))
+            clientInterface_->dataChangesReceived(notifications);
     }
 
 
@@ -457,38 +503,73 @@ namespace uaf
 
         logger_->debug("A total of %d notifications were received", noOfNotifications);
 
-        // create the notifications
-        vector<EventNotification> notifications;
+        // only look for the model change events of the address cache if they are monitored
+        bool modelChangesMonitored = database_->clientSettings.addressCacheModelChangeEventsEnable;
+        string serverUri;
 
-        // fill the notifications
+        // select the notifications of the known monitored items
+        notificationIndexes_.clear();
         for (uint32_t i=0; i < noOfNotifications; i++)
         {
             ClientHandle clientHandle = uaEventFieldList[i].ClientHandle;
 
-            MonitoredItemsMap::const_iterator it = monitoredItemsMap_.find(clientHandle);
+            if (monitoredItemsMap_.find(clientHandle) == monitoredItemsMap_.end())
+                continue;
 
-            // update the contents of the notification
-            if (it != monitoredItemsMap_.end())
+            // the model change events of the address cache are not passed to the client
+            if (modelChangesMonitored
+                    && database_->addressCache.findModelChangeMonitoredItem(clientHandle, serverUri))
             {
-                EventNotification notification;
+                vector<Variant> fields;
+                for (int32_t j=0; j < uaEventFieldList[i].NoOfEventFields; j++)
+                    fields.push_back(Variant(uaEventFieldList[i].EventFields[j]));
 
-                notification.clientHandle       = clientHandle;
+                database_->addressCache.processModelChangeEvent(serverUri, fields);
+                continue;
+            }
 
-                // update the event fields
-                for (int32_t j=0; j < uaEventFieldList[i].NoOfEventFields; j++)
-                    notification.fields.push_back(Variant(uaEventFieldList[i].EventFields[j]));
+            notificationIndexes_.push_back(i);
+        }
+
+        // offer all notifications at once to the batch callback, without copying them
+        EventBatch batch(clientSubscriptionHandle_, uaEventFieldList, notificationIndexes_);
+        if (clientInterface_->eventBatchReceived(batch))
+            return;
 
-                // add it to the vector of notifications for the callback
-                notifications.push_back(notification);
+        // create the notifications
+        vector<EventNotification> notifications;
+        notifications.reserve(notificationIndexes_.size());
+
+        // fill the notifications
+        for (vector<uint32_t>::const_iterator it = notificationIndexes_.begin();
+             it != notificationIndexes_.end();
+             ++it)
+        {
+            uint32_t i = *it;
+
+            EventNotification notification;
 
-                // log the notification
+            notification.clientHandle       = uaEventFieldList[i].ClientHandle;
+
+            // update the event fields
+            notification.fields.reserve(uaEventFieldList[i].NoOfEventFields);
+            for (int32_t j=0; j < uaEventFieldList[i].NoOfEventFields; j++)
+                notification.fields.push_back(Variant(uaEventFieldList[i].EventFields[j]));
+
+            // add it to the vector of notifications for the callback
+            notifications.push_back(notification);
+
+            // log the notification
+            if (logger_->isDebugEnabled())
+            {
                 logger_->debug(" - Notification %d:", int(i));
                 logger_->debug(notification.toString("   ", 25));
             }
         }
 
-        // call the callback interface
-        clientInterface_->eventsReceived(notifications);
+        // call the callback interface, unless the dispatcher will do it
+        if (!database_->notificationDispatcher.dispatch(notifications))
+            clientInterface_->eventsReceived(notifications);
     }
 
 }
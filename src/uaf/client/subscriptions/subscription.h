@@ -246,6 +246,24 @@ namespace uaf
                     = invocation.resultTargets()[i].revisedSamplingIntervalSec;
                 monitoredItemsMap_[clientHandle].monitoredItemId \
                     = invocation.resultTargets()[i].monitoredItemId;
+
+                // let the data changes update the value cache, if needed (only the complete
+                // values are cached)
+                if (database_->clientSettings.valueCacheEnable
+                        && database_->clientSettings.valueCacheMonitoredItemsEnable
+                        && invocation.requestTargets()[i].address.isExpandedNodeId()
+                        && invocation.requestTargets()[i].indexRange.empty())
+                    database_->valueCache.addMonitoredItem(
+                            clientHandle,
+                            invocation.requestTargets()[i].address.getExpandedNodeId(),
+                            invocation.requestTargets()[i].attributeId);
+
+                // give the monitored item a slot in the latest value store, if needed
+                if (database_->clientSettings.latestValueStoreEnable
+                        && invocation.requestTargets()[i].address.isExpandedNodeId())
+                    database_->latestValueStore.addItem(
+                            clientHandle,
+                            invocation.requestTargets()[i].address.getExpandedNodeId());
             }
 
 
@@ -391,6 +409,10 @@ namespace uaf
         MonitoredItemsMap                           monitoredItemsMap_;
         UaMutex                                     monitoredItemsMapMutex_;
 
+        // the indexes of the received notifications of known monitored items (reused for each
+        // publish response, since they are received by one thread at a time)
+        std::vector<uint32_t>                       notificationIndexes_;
+
 
 
     };
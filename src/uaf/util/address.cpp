@@ -19,6 +19,7 @@
  */
 
 #include "uaf/util/address.h"
+#include "uaf/util/helperfunctions.h"
 
 
 namespace uaf
@@ -38,7 +39,9 @@ namespace uaf
       relativePath_(0),
       startingAddress_(0),
       expandedNodeId_(new ExpandedNodeId)
-    {}
+    {
+        hash_ = computeHash();
+    }
 
 
     // Constructor
@@ -49,7 +52,9 @@ namespace uaf
       relativePath_(new vector<RelativePathElement>(relativePath)),
       startingAddress_(new Address(*startingAddress)),
       expandedNodeId_(0)
-    {}
+    {
+        hash_ = computeHash();
+    }
 
 
     // Constructor
@@ -62,6 +67,8 @@ namespace uaf
     {
         relativePath_ = new vector<RelativePathElement>();
         relativePath_->push_back(relativePath);
+
+        hash_ = computeHash();
     }
 
 
@@ -74,7 +81,9 @@ namespace uaf
       relativePath_(new vector<RelativePathElement>(browsePath.relativePath)),
       startingAddress_(new Address(browsePath.startingExpandedNodeId)),
       expandedNodeId_(0)
-    {}
+    {
+        hash_ = computeHash();
+    }
 
 
     // Constructor
@@ -85,7 +94,9 @@ namespace uaf
       relativePath_(0),
       startingAddress_(0),
       expandedNodeId_(new ExpandedNodeId(expandedNodeId))
-    {}
+    {
+        hash_ = computeHash();
+    }
 
 
     // Constructor
@@ -96,7 +107,9 @@ namespace uaf
       relativePath_(0),
       startingAddress_(0),
       expandedNodeId_(new ExpandedNodeId(nodeId, serverUri))
-    {}
+    {
+        hash_ = computeHash();
+    }
 
 
     // Constructor
@@ -105,6 +118,7 @@ namespace uaf
     {
         isRelativePath_ = other.isRelativePath_;
         isStartingAddressOwned_ = other.isStartingAddressOwned_;
+        hash_ = other.hash_;
         
         if (isRelativePath_)
         {
@@ -133,6 +147,7 @@ namespace uaf
 
             isRelativePath_ = other.isRelativePath_;
             isStartingAddressOwned_ = other.isStartingAddressOwned_;
+            hash_ = other.hash_;
             if (isRelativePath_)
             {
                 relativePath_    = new vector<RelativePathElement>(*other.relativePath_);
@@ -312,11 +327,42 @@ namespace uaf
 
 
 
+    // Compute the hash
+    // =============================================================================================
+    uint32_t Address::computeHash() const
+    {
+        uint32_t ret = HASH_SEED;
+
+        hashCombine(ret, uint32_t(isRelativePath_));
+
+        if (isRelativePath_)
+        {
+            for (vector<RelativePathElement>::const_iterator it = relativePath_->begin();
+                 it != relativePath_->end();
+                 ++it)
+                hashCombine(ret, it->hash());
+
+            // the starting address contributes its own hash
+            if (startingAddress_ != 0)
+                hashCombine(ret, startingAddress_->hash());
+        }
+        else if (expandedNodeId_ != 0)
+        {
+            hashCombine(ret, expandedNodeId_->hash());
+        }
+
+        return ret;
+    }
+
+
     // operator==
     // =============================================================================================
     bool operator==(const Address& object1, const Address& object2)
     {
-        if (object1.isRelativePath_ != object2.isRelativePath_)
+        // different hashes means different addresses
+        if (object1.hash_ != object2.hash_)
+            return false;
+        else if (object1.isRelativePath_ != object2.isRelativePath_)
             return false;
         else
         {
@@ -214,6 +214,17 @@ namespace uaf
                 std::string&    serverUri);
 
 
+        /**
+         * Get a hash of the address.
+         *
+         * The hash is computed once, when the address is constructed, so it's cheap to get.
+         * Equal addresses have equal hashes.
+         *
+         * @return  The hash.
+         */
+        uint32_t hash() const { return hash_; }
+
+
         // comparison operators
         friend UAF_EXPORT bool operator==(const Address& object1, const Address& object2);
         friend UAF_EXPORT bool operator!=(const Address& object1, const Address& object2);
@@ -233,6 +244,12 @@ namespace uaf
         // The ExpandedNodeId in case the address is absolute.
         uaf::ExpandedNodeId* expandedNodeId_;
 
+        // The hash of the address (computed by the constructors)
+        uint32_t hash_;
+
+        // Compute the hash of the address
+        uint32_t computeHash() const;
+
     };
 
 
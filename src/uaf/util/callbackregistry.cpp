@@ -14,54 +14,98 @@ namespace uaf
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::RegisterCallback(uaf::Callback<NotificationType>* pCallback)
     {
-        RegisterCallback(uaf::constants::CLIENTHANDLE_NOT_ASSIGNED, pCallback);
+        UaMutexLocker locker(&catchAllMutex_);
+        catchAllCallbacks_.push_back(pCallback);
     }
 
     // Register an associated Callback
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::RegisterCallback(uaf::ClientHandle clientHandle, uaf::Callback<NotificationType>* pCallback)
     {
-        UaMutexLocker locker(&mapMutex_);
-        callbackMap_[clientHandle] = pCallback;
+        if (clientHandle == uaf::constants::CLIENTHANDLE_NOT_ASSIGNED)
+        {
+            RegisterCallback(pCallback);
+            return;
+        }
+
+        Bucket& b = bucket(clientHandle);
+        UaMutexLocker locker(&b.mutex);
+        b.callbackMap.insert(std::make_pair(clientHandle, pCallback));
     }
 
     // Unregister all Callbacks
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::UnregisterAllCallbacks()
     {
-        UaMutexLocker locker(&mapMutex_);
-        callbackMap_.clear();
+        for (uint32_t i = 0; i < NO_OF_BUCKETS; i++)
+        {
+            UaMutexLocker locker(&buckets_[i].mutex);
+            buckets_[i].callbackMap.clear();
+        }
+
+        UnregisterCallbacks();
     }
 
     // Unregister all catchall Callbacks
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::UnregisterCallbacks()
     {
-        UnregisterCallbacks(uaf::constants::CLIENTHANDLE_NOT_ASSIGNED);
+        UaMutexLocker locker(&catchAllMutex_);
+        catchAllCallbacks_.clear();
     }
 
     // Unregister all Callbacks for a clientHandle
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::UnregisterCallbacks(uaf::ClientHandle clientHandle)
     {
-        UaMutexLocker locker(&mapMutex_);
-        callbackMap_.erase(clientHandle);
+        if (clientHandle == uaf::constants::CLIENTHANDLE_NOT_ASSIGNED)
+        {
+            UnregisterCallbacks();
+            return;
+        }
+
+        Bucket& b = bucket(clientHandle);
+        UaMutexLocker locker(&b.mutex);
+        b.callbackMap.erase(clientHandle);
     }
 
-    // Call all Callbacks associated with the clientHandle of notification or
-    // with no association.
+    // Call all Callbacks associated with the clientHandle of notification, and then all
+    // Callbacks with no association.
+    // The callbacks are called while their bucket (or list) is locked, so that a callback is no
+    // longer in use once it has been unregistered. They are called from a copy of the bucket,
+    // so that a callback may (un)register callbacks itself (the mutexes are recursive).
     // =============================================================================================
     template<class NotificationType> void CallbackRegistry<NotificationType>::CallCallback(const NotificationType& notification)
     {
-        UaMutexLocker locker(&mapMutex_);
+        typename CallbackList::const_iterator iter;
+
+        {
+            Bucket& b = bucket(notification.clientHandle);
+            UaMutexLocker locker(&b.mutex);
+
+            std::pair<typename CallbackMap::const_iterator, typename CallbackMap::const_iterator> range;
+            range = b.callbackMap.equal_range(notification.clientHandle);
+
+            CallbackList callbacks;
+            for (typename CallbackMap::const_iterator it = range.first; it != range.second; ++it)
+            {
+                callbacks.push_back(it->second);
+            }
 
-        typename std::map<uaf::ClientHandle, uaf::Callback<NotificationType>* >::const_iterator iter;
+            for (iter = callbacks.begin(); iter != callbacks.end(); ++iter)
+            {
+                (*iter)->operator()(notification);
+            }
+        }
 
-        for (iter = callbackMap_.begin(); iter != callbackMap_.end(); ++iter)
         {
-            if (iter->first == uaf::constants::CLIENTHANDLE_NOT_ASSIGNED || iter->first == notification.clientHandle)
+            UaMutexLocker locker(&catchAllMutex_);
+
+            CallbackList callbacks(catchAllCallbacks_);
+
+            for (iter = callbacks.begin(); iter != callbacks.end(); ++iter)
             {
-                iter->second->operator()(notification);
+                (*iter)->operator()(notification);
             }
         }
     }
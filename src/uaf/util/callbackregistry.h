@@ -4,11 +4,13 @@
 
 // STD
 #include <map>
+#include <vector>
 #include <string>
 #include <sstream>
 // SDK
 #include "uabase/uamutex.h"
 // UAF
+#include "uaf/util/util.h"
 #include "uaf/util/logger.h"
 #include "uaf/util/stringifiable.h"
 #include "uaf/util/handles.h"
@@ -25,6 +27,15 @@ namespace uaf
     /*******************************************************************************************//**
     * A uaf::CallbackRegistry is a registry for notification callbacks.
     *
+    * Several callbacks may be registered for the same ClientHandle. The callbacks registered for
+    * a ClientHandle are stored in one of a fixed number of buckets (chosen by the ClientHandle),
+    * each with its own mutex, so that a notification only needs to look up the callbacks of its
+    * own ClientHandle, and only blocks the notifications of the same bucket while the callbacks
+    * are called. The callbacks for all notifications are stored in a separate list.
+    *
+    * Since the callbacks are called while their bucket is locked, a callback is no longer in use
+    * once it has been unregistered, so it may be deleted right away.
+    *
     * @ingroup Util
     ***********************************************************************************************/
     template<class NotificationType> class UAF_EXPORT CallbackRegistry
@@ -42,7 +53,8 @@ namespace uaf
         void RegisterCallback(uaf::Callback<NotificationType>* pCallback);
 
         /**
-         * Register a callback for a notification identified by clientHandle.
+         * Register a callback for a notification identified by clientHandle (in addition to the
+         * callbacks that are already registered for this clientHandle).
          */
         void RegisterCallback(uaf::ClientHandle clientHandle, uaf::Callback<NotificationType>* pCallback);
 
@@ -67,9 +79,31 @@ namespace uaf
         void CallCallback(const NotificationType& notification);
 
     private:
-        std::map<uaf::ClientHandle, uaf::Callback<NotificationType>* > callbackMap_;
+        DISALLOW_COPY_AND_ASSIGN(CallbackRegistry);
+
+        // the number of buckets to spread the ClientHandles over
+        static const uint32_t NO_OF_BUCKETS = 64;
+
+        typedef std::vector<uaf::Callback<NotificationType>*>                       CallbackList;
+        typedef std::multimap<uaf::ClientHandle, uaf::Callback<NotificationType>*>  CallbackMap;
+
+        // a bucket holds the callbacks of the ClientHandles with the same remainder
+        struct Bucket
+        {
+            CallbackMap callbackMap;
+            UaMutex     mutex;
+        };
+
+        // get the bucket of a ClientHandle
+        Bucket& bucket(uaf::ClientHandle clientHandle)
+        { return buckets_[clientHandle % NO_OF_BUCKETS]; }
+
+        // the callbacks for a specific ClientHandle
+        Bucket buckets_[NO_OF_BUCKETS];
 
-        UaMutex mapMutex_;
+        // the callbacks for all notifications
+        CallbackList catchAllCallbacks_;
+        UaMutex      catchAllMutex_;
     };
 
 
@@ -233,6 +233,15 @@ namespace uaf
         : uaf::InvalidRequestError("No valid definition was found")
         {}
     };
+
+
+    class UAF_EXPORT ReadNotPreparedError : public uaf::InvalidRequestError
+    {
+    public:
+        ReadNotPreparedError()
+        : uaf::InvalidRequestError("The read could not be prepared by this client")
+        {}
+    };
 }
 
 
@@ -19,6 +19,7 @@
  */
 
 #include "uaf/util/expandednodeid.h"
+#include "uaf/util/helperfunctions.h"
 
 
 namespace uaf
@@ -340,6 +341,17 @@ namespace uaf
     }
 
 
+    // Get a hash
+    // =============================================================================================
+    uint32_t ExpandedNodeId::hash() const
+    {
+        uint32_t ret = nodeId_.hash();
+        hashCombine(ret, uint32_t(serverIndex_));
+        hashCombine(ret, serverUri_);
+        return ret;
+    }
+
+
     // operator==
     // =============================================================================================
     bool operator==(const ExpandedNodeId& object1, const ExpandedNodeId& object2)
@@ -397,6 +397,16 @@ namespace uaf
         uaf::Status fromSdk(const UaExpandedNodeId& uaExpandedNodeId);
 
 
+        /**
+         * Get a hash of the ExpandedNodeId.
+         *
+         * Equal ExpandedNodeIds have equal hashes.
+         *
+         * @return  The hash.
+         */
+        uint32_t hash() const;
+
+
         // comparison operators
         friend UAF_EXPORT bool operator==(
                 const ExpandedNodeId& object1,
@@ -122,5 +122,19 @@ namespace uaf
     }
 
 
+    // Compute a 64-bit FNV-1a hash
+    // =============================================================================================
+    uint64_t hashString(const string& s, uint64_t seed)
+    {
+        uint64_t hash = seed;
+        for (string::const_iterator it = s.begin(); it != s.end(); ++it)
+        {
+            hash ^= uint64_t(static_cast<unsigned char>(*it));
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+
 
 }
@@ -88,6 +88,80 @@ namespace uaf
      */
     std::string UAF_EXPORT replacePathSeparators(const std::string& s);
 
+
+    /**
+     * Compute a 64-bit FNV-1a hash of a string.
+     *
+     * The hash can be chained by passing the result of a previous call as the seed, e.g. to
+     * hash several strings into a single value.
+     *
+     * @param s     The string to hash.
+     * @param seed  The value to start from (by default the FNV-1a offset basis).
+     * @return      The hash of the string.
+     *
+     * @ingroup Util
+     */
+    uint64_t UAF_EXPORT hashString(
+            const std::string&  s,
+            uint64_t            seed = 14695981039346656037ULL);
+
+
+    /**
+     * The value to start a 32-bit FNV-1a hash from (see hashCombine()).
+     */
+    static const uint32_t HASH_SEED = 2166136261u;
+
+
+    /**
+     * Mix an integer into a 32-bit FNV-1a hash (byte by byte).
+     *
+     * @param hash  The hash to update (start from HASH_SEED).
+     * @param value The integer to mix into the hash.
+     *
+     * @ingroup Util
+     */
+    inline void hashCombine(uint32_t& hash, uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            hash ^= (value >> (8 * i)) & 0xFF;
+            hash *= 16777619u;
+        }
+    }
+
+
+    /**
+     * Mix a number of bytes into a 32-bit FNV-1a hash.
+     *
+     * @param hash      The hash to update (start from HASH_SEED).
+     * @param data      The bytes to mix into the hash.
+     * @param length    The number of bytes.
+     *
+     * @ingroup Util
+     */
+    inline void hashCombine(uint32_t& hash, const uint8_t* data, std::size_t length)
+    {
+        for (std::size_t i = 0; i < length; i++)
+        {
+            hash ^= data[i];
+            hash *= 16777619u;
+        }
+    }
+
+
+    /**
+     * Mix a string into a 32-bit FNV-1a hash.
+     *
+     * @param hash  The hash to update (start from HASH_SEED).
+     * @param value The string to mix into the hash.
+     *
+     * @ingroup Util
+     */
+    inline void hashCombine(uint32_t& hash, const std::string& value)
+    {
+        hashCombine(hash, reinterpret_cast<const uint8_t*>(value.data()), value.size());
+    }
+
 }
 
 #endif /* UAF_HELPERFUNCTIONS_H_ */
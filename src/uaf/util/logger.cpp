@@ -199,7 +199,7 @@ namespace uaf
     void Logger::log(const SdkStatus& sdkStatus)
     {
         if (sdkStatus.isGood())
-            debug(sdkStatus.toString());
+            UAF_LOG_DEBUG(this, (sdkStatus.toString()));
         else if (sdkStatus.isUncertain())
             warning(sdkStatus.toString());
         else
@@ -211,7 +211,7 @@ namespace uaf
     void Logger::log(const std::string& prefix, const SdkStatus& sdkStatus)
     {
         if (sdkStatus.isGood())
-            debug(prefix + sdkStatus.toString());
+            UAF_LOG_DEBUG(this, (prefix + sdkStatus.toString()));
         else if (sdkStatus.isUncertain())
             warning(prefix + sdkStatus.toString());
         else
@@ -222,7 +222,8 @@ namespace uaf
     //==============================================================================================
     void Logger::error(const Status& status)
     {
-        error(status.toString().c_str());
+        if (loggerFactory_->checkLevel(loglevels::Error))
+            error(status.toString());
     }
 
 
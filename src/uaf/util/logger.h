@@ -25,6 +25,24 @@
 #define UAF_LOGGER_MAX_BUFFER_SIZE 4096
 
 
+/**
+ * Log a debug message, but only evaluate the arguments if debug messages will actually be logged.
+ *
+ * The arguments of Logger::debug() must be given between parentheses, so that expensive messages
+ * (such as toString() results) are not built in vain when the debug level is disabled:
+ *
+ * @code
+ * UAF_LOG_DEBUG(logger_, (request.toString()));
+ * UAF_LOG_DEBUG(logger_, ("Mask is %s", mask.toString().c_str()));
+ * @endcode
+ *
+ * @param logger    Pointer to a uaf::Logger.
+ * @param args      The parenthesized arguments of uaf::Logger::debug().
+ */
+#define UAF_LOG_DEBUG(logger, args)                                                               \
+    do { if ((logger)->isDebugEnabled()) (logger)->debug args; } while (0)
+
+
 // STD
 #include <sstream>
 #include <string>
@@ -104,7 +122,7 @@ namespace uaf
          * Check if a message with the given level will either be logged to the stdout or the
          * callback interface;
          */
-        bool checkLevel(uaf::loglevels::LogLevel level)
+        bool checkLevel(uaf::loglevels::LogLevel level) const
         {
             return     (level <= stdOutLevel_)
                     || (level <= callbackLevel_ && callbackInterfaceRegistered_);
@@ -260,6 +278,26 @@ namespace uaf
         ~Logger();
 
 
+        /**
+         * Check if messages with the given level will be logged (to the stdout or the callback
+         * interface).
+         *
+         * @param level     The loglevel.
+         * @return          True if messages of this level will be logged.
+         */
+        bool checkLevel(uaf::loglevels::LogLevel level) const
+        { return loggerFactory_->checkLevel(level); }
+
+
+        /**
+         * Check if debug messages will be logged, so that expensive debug messages don't have to
+         * be built in vain (see also UAF_LOG_DEBUG).
+         *
+         * @return          True if debug messages will be logged.
+         */
+        bool isDebugEnabled() const { return checkLevel(uaf::loglevels::Debug); }
+
+
         /**
          * Log the SDK status (Debug if Good, Warning if Uncertain, Error if Bad).
          */
@@ -56,10 +56,25 @@ namespace uaf
             // if the conversion succeeded, fill the map with simplified URIs
             if (OpcUa_IsGood(uaConversionStatusCode))
             {
+                // forget the URIs of a previous namespace array
+                nameSpaceMap_.clear();
+                interned_.clear();
+                indexesBySimplifiedId_.clear();
+
                 for (uint16_t i=0; i<namespaceArray_.length(); i++)
                 {
                     nameSpaceMap_[i] = NamespaceArray::getSimplifiedUri(
                             string(UaString(&namespaceArray_[i]).toUtf8()));
+
+                    const NamespaceUriTable::Entry* entry = NamespaceUriTable::intern(
+                            nameSpaceMap_[i]);
+                    interned_.push_back(entry);
+
+                    // fill the reverse map (if an URI is repeated, the first index is kept)
+                    if (indexesBySimplifiedId_.size() <= entry->id)
+                        indexesBySimplifiedId_.resize(entry->id + 1, 0);
+                    if (indexesBySimplifiedId_[entry->id] == 0)
+                        indexesBySimplifiedId_[entry->id] = uint32_t(i) + 1;
                 }
             }
             else
@@ -101,29 +116,29 @@ namespace uaf
             const string&   namespaceUri,
             NameSpaceIndex& namespaceIndex) const
     {
-        // We need to do a "reverse" lookup, by iterating over the key:value pairs until we have
-        // found the correct value.
+        return findNamespaceIndex(NamespaceUriTable::intern(namespaceUri), namespaceIndex);
+    }
 
-        // get a simplified URI
-        string simplifiedUri = NamespaceArray::getSimplifiedUri(namespaceUri);
 
-        // iterate over the key:value pairs
-        NameSpaceMap::const_iterator iter;
-        for (iter = nameSpaceMap_.begin(); iter != nameSpaceMap_.end(); ++iter)
-        {
-            // if the NamespaceURI was found, assign the NamespaceIndex, update the status,
-            // and return
-            if (iter->second == simplifiedUri)
-            {
-                namespaceIndex = iter->first;
+    // Look up the NamespaceIndex for a given interned NamespaceURI
+    // =============================================================================================
+    bool NamespaceArray::findNamespaceIndex(
+            const NamespaceUriTable::Entry* namespaceUri,
+            NameSpaceIndex&                 namespaceIndex) const
+    {
+        // the interned URI knows the id of its simplified form, which is the key of the
+        // reverse map
+        uint32_t simplifiedId = namespaceUri->simplifiedId;
 
-                // we found the URI, so we can return!
-                return true;
-            }
+        if (simplifiedId < indexesBySimplifiedId_.size() && indexesBySimplifiedId_[simplifiedId] != 0)
+        {
+            namespaceIndex = NameSpaceIndex(indexesBySimplifiedId_[simplifiedId] - 1);
+            return true;
+        }
+        else
+        {
+            return false;
         }
-
-        // we haven't returned yet, so the URI was not found...
-        return false;
     }
 
 
@@ -144,24 +159,21 @@ namespace uaf
     }
 
 
+    // Get a fingerprint of the namespace array
+    // =============================================================================================
+    uint64_t NamespaceArray::fingerprint() const
+    {
+        // the string representation contains all indexes and URIs
+        return hashString(toString());
+    }
+
+
     // static function!
     // Create a simplified (plain) URI
     // =============================================================================================
     string NamespaceArray::getSimplifiedUri(const string& uri)
     {
-        string ret(uri);
-
-        if (ret.size() > 0)
-        {
-            // transform to lower case
-            transform(ret.begin(), ret.end(), ret.begin(), toLower );
-            // remove a trailing '/' character
-            if (ret.substr(ret.length()-1, 1) == string("/"))
-            {
-                ret = ret.substr(0, ret.length()-1);
-            }
-        }
-        return ret;
+        return NamespaceUriTable::simplify(uri);
     }
 
 
@@ -193,7 +205,7 @@ namespace uaf
         if (nodeId.hasNameSpaceUri())
         {
 
-            if (findNamespaceIndex(nodeId.nameSpaceUri(), nameSpaceIndex))
+            if (findNamespaceIndex(nodeId.nameSpaceUriEntry(), nameSpaceIndex))
                 ret = statuscodes::Good;
             else
                 ret = UnknownNamespaceUriError(
@@ -294,7 +306,7 @@ namespace uaf
             // we need to get a valid namespace index
             NameSpaceIndex nameSpaceIndex;
 
-            if (findNamespaceIndex(qualifiedName.nameSpaceUri(), nameSpaceIndex))
+            if (findNamespaceIndex(qualifiedName.nameSpaceUriEntry(), nameSpaceIndex))
             {
                 // copy the contents from the qualified name to the SDK object
                 // (except the namespaceUri because that's not relevant for the SDK object anyway)
@@ -361,10 +373,11 @@ namespace uaf
     {
         Status ret;
 
-        string namespaceUri;
-
-        if (findNamespaceUri(opcUaNodeId.NamespaceIndex, namespaceUri))
-            ret = nodeId.fromSdk(opcUaNodeId, namespaceUri);
+        if (opcUaNodeId.NamespaceIndex < interned_.size())
+        {
+            ret = nodeId.fromSdk(opcUaNodeId);
+            nodeId.setNameSpaceUri(interned_[opcUaNodeId.NamespaceIndex]);
+        }
         else
             ret = UnknownNamespaceIndexError(opcUaNodeId.NamespaceIndex);
 
@@ -419,11 +432,15 @@ namespace uaf
     {
         Status ret;
 
-        string namespaceUri;
-
-        if (findNamespaceUri(opcUaQualfiedName.NamespaceIndex, namespaceUri))
+        if (opcUaQualfiedName.NamespaceIndex < interned_.size())
         {
-            qualifiedName.fromSdk(opcUaQualfiedName, namespaceUri);
+            UaQualifiedName uaQualifiedName(opcUaQualfiedName);
+            qualifiedName.fromSdk(uaQualifiedName);
+
+            // a null qualified name must stay null, so it doesn't get a namespace URI
+            if (!uaQualifiedName.isNull())
+                qualifiedName.setNameSpaceUri(interned_[opcUaQualfiedName.NamespaceIndex]);
+
             ret = statuscodes::Good;
         }
         else
@@ -26,6 +26,7 @@
 #include <string>
 #include <sstream>
 #include <map>
+#include <vector>
 #include <algorithm>
 #include <stdint.h>
 // SDK
@@ -37,6 +38,8 @@
 #include "uaf/util/status.h"
 #include "uaf/util/variant.h"
 #include "uaf/util/address.h"
+#include "uaf/util/helperfunctions.h"
+#include "uaf/util/namespaceuritable.h"
 
 
 namespace uaf
@@ -89,6 +92,18 @@ namespace uaf
         std::string toString() const;
 
 
+        /**
+         * Get a fingerprint (a hash) of the namespace array.
+         *
+         * Namespace arrays with the same (simplified) URIs at the same indexes have the same
+         * fingerprint, so the fingerprint can be used to detect that the namespace array of a
+         * server has changed.
+         *
+         * @return  The fingerprint.
+         */
+        uint64_t fingerprint() const;
+
+
         /**
          * Find the NamespaceURI for a given NamespaceIndex.
          *
@@ -113,6 +128,18 @@ namespace uaf
                 NameSpaceIndex&     namespaceIndex) const;
 
 
+        /**
+         * Find the NamespaceIndex for a given interned NamespaceURI, in constant time.
+         *
+         * @param namespaceUri      The interned NamespaceURI that needs to be looked up.
+         * @param namespaceIndex    The NamespaceIndex that will be overwritten.
+         * @return                  True if the URI could be found.
+         */
+        bool findNamespaceIndex(
+                const uaf::NamespaceUriTable::Entry*    namespaceUri,
+                NameSpaceIndex&                         namespaceIndex) const;
+
+
 
         /**
          * Fill an OpcUa_NodeId (which is fully resolved!) from a uaf::NodeId (which may not
@@ -263,6 +290,11 @@ namespace uaf
 
         // the internal NameSpaceIndex:NameSpaceURI map
         NameSpaceMap nameSpaceMap_;
+        // the interned (simplified) URIs, by their NameSpaceIndex
+        std::vector<const uaf::NamespaceUriTable::Entry*> interned_;
+        // the reverse map: the NameSpaceIndex + 1 (or 0 if unknown), by the id of the interned
+        // (simplified) URI
+        std::vector<uint32_t> indexesBySimplifiedId_;
 
         // the original array
         UaStringArray namespaceArray_;
@@ -275,9 +307,6 @@ namespace uaf
          * @return      A simplified "plain" string.
          */
         static std::string getSimplifiedUri(const std::string& uri);
-
-        // wrap the overloaded islower, to avoid 'invalid overload' problems
-        static int toLower( int ch ) { return tolower(ch); }
     };
 }
 
@@ -0,0 +1,131 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "uaf/util/namespaceuritable.h"
+
+
+namespace uaf
+{
+    using namespace uaf;
+    using std::string;
+    using std::size_t;
+
+
+    // Create the table of the process
+    // =============================================================================================
+    NamespaceUriTable::Table* NamespaceUriTable::createTable()
+    {
+        Table* t = new Table();
+
+        // the empty URI always has id 0
+        internLocked(*t, string());
+
+        return t;
+    }
+
+
+    // Get the table of the process
+    // =============================================================================================
+    NamespaceUriTable::Table& NamespaceUriTable::table()
+    {
+        // created on first use (so it can be used while other static objects are constructed),
+        // and never destroyed (so it can be used while other static objects are destroyed)
+        static Table* t = createTable();
+        return *t;
+    }
+
+
+    // Intern an URI, while the mutex is locked
+    // =============================================================================================
+    const NamespaceUriTable::Entry* NamespaceUriTable::internLocked(Table& t, const string& uri)
+    {
+        std::map<string, const Entry*>::const_iterator iter = t.entriesByUri.find(uri);
+
+        if (iter != t.entriesByUri.end())
+            return iter->second;
+
+        // intern the simplified URI first (the simplified form of a simplified URI is itself)
+        string simplifiedUri = simplify(uri);
+        uint32_t simplifiedId = uint32_t(t.entries.size());
+        if (simplifiedUri != uri)
+            simplifiedId = internLocked(t, simplifiedUri)->id;
+
+        Entry entry;
+        entry.uri          = uri;
+        entry.id           = uint32_t(t.entries.size());
+        entry.simplifiedId = simplifiedId;
+        t.entries.push_back(entry);
+
+        const Entry* ret = &t.entries.back();
+        t.entriesByUri[uri] = ret;
+        return ret;
+    }
+
+
+    // Intern an URI
+    // =============================================================================================
+    const NamespaceUriTable::Entry* NamespaceUriTable::intern(const string& uri)
+    {
+        Table& t = table();
+
+        UaMutexLocker locker(&t.mutex); // unlocks when locker goes out of scope
+        return internLocked(t, uri);
+    }
+
+
+    // Get the interned empty URI
+    // =============================================================================================
+    const NamespaceUriTable::Entry* NamespaceUriTable::empty()
+    {
+        static const Entry* ret = intern(string());
+        return ret;
+    }
+
+
+    // Get the number of interned URIs
+    // =============================================================================================
+    size_t NamespaceUriTable::size()
+    {
+        Table& t = table();
+
+        UaMutexLocker locker(&t.mutex); // unlocks when locker goes out of scope
+        return t.entries.size();
+    }
+
+
+    // Create a simplified (plain) URI
+    // =============================================================================================
+    string NamespaceUriTable::simplify(const string& uri)
+    {
+        string ret(uri);
+
+        if (ret.size() > 0)
+        {
+            // transform to lower case
+            std::transform(ret.begin(), ret.end(), ret.begin(), toLower );
+            // remove a trailing '/' character
+            if (ret[ret.length()-1] == '/')
+                ret.erase(ret.length()-1);
+        }
+        return ret;
+    }
+
+
+}
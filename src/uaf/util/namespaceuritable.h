@@ -0,0 +1,144 @@
+/* This file is part of the UAF (Unified Architecture Framework) project.
+ *
+ * Copyright (C) 2012 Wim Pessemier (Institute of Astronomy, KULeuven)
+ *
+ * Project website: http://www.ster.kuleuven.be/uaf
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UAF_NAMESPACEURITABLE_H_
+#define UAF_NAMESPACEURITABLE_H_
+
+
+// STD
+#include <string>
+#include <deque>
+#include <map>
+#include <algorithm>
+#include <cctype>
+#include <stdint.h>
+// SDK
+#include "uabase/uamutex.h"
+// UAF
+#include "uaf/util/util.h"
+
+
+namespace uaf
+{
+
+
+    /*******************************************************************************************//**
+     * A NamespaceUriTable interns the namespace URIs of the whole process.
+     *
+     * Each distinct namespace URI is stored only once, and gets a small id. uaf::NodeId and
+     * uaf::QualifiedName only refer to an interned URI (so copying them doesn't copy the URI,
+     * and comparing their URIs is an integer comparison), and uaf::NamespaceArray uses the ids
+     * of the simplified URIs to look up a namespace index in constant time.
+     *
+     * Interned URIs are never removed, so references to them stay valid until the process exits.
+     *
+     * @ingroup Util
+     **********************************************************************************************/
+    class UAF_EXPORT NamespaceUriTable
+    {
+    public:
+
+
+        /**
+         * An interned namespace URI.
+         */
+        struct Entry
+        {
+            /** The URI, exactly as it was interned. */
+            std::string uri;
+            /** The id of the URI (0 for the empty URI). */
+            uint32_t id;
+            /** The id of the simplified URI (which is the own id, if the URI is simplified). */
+            uint32_t simplifiedId;
+        };
+
+
+        /**
+         * Intern a namespace URI.
+         *
+         * @param uri   The URI to intern.
+         * @return      The interned URI (never 0).
+         */
+        static const Entry* intern(const std::string& uri);
+
+
+        /**
+         * Get the interned empty URI.
+         *
+         * @return      The interned empty URI (with id 0).
+         */
+        static const Entry* empty();
+
+
+        /**
+         * Get the number of interned URIs.
+         *
+         * @return      The number of interned URIs (including the empty URI). All ids are smaller
+         *              than this number.
+         */
+        static std::size_t size();
+
+
+        /**
+         * Convert the URI to a "plain" one (no trailing forward slash, no capitals) in order to
+         * simplify comparison.
+         *
+         * @param uri   URI that may contain capitals, a trailing forward slash, ...
+         * @return      A simplified "plain" string.
+         */
+        static std::string simplify(const std::string& uri);
+
+
+    private:
+
+
+        // the table of the process
+        struct Table
+        {
+            // the interned URIs (a deque, so that their addresses never change)
+            std::deque<Entry>                       entries;
+            // the interned URIs by their string
+            std::map<std::string, const Entry*>     entriesByUri;
+            // the mutex that protects the table
+            UaMutex                                 mutex;
+        };
+
+
+        // create the table of the process
+        static Table* createTable();
+
+
+        // get the table of the process (it is created on first use, and never destroyed)
+        static Table& table();
+
+
+        // intern an URI, while the mutex is locked
+        static const Entry* internLocked(Table& t, const std::string& uri);
+
+
+        // wrap the overloaded islower, to avoid 'invalid overload' problems
+        static int toLower( int ch ) { return tolower(ch); }
+    };
+
+
+}
+
+
+#endif /* UAF_NAMESPACEURITABLE_H_ */
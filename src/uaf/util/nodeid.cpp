@@ -19,6 +19,7 @@
  */
 
 #include "uaf/util/nodeid.h"
+#include "uaf/util/helperfunctions.h"
 
 
 namespace uaf
@@ -32,6 +33,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId()
     : nameSpaceIndex_(0),
+      nameSpaceUri_(NamespaceUriTable::empty()),
       nameSpaceIndexGiven_(false),
       nameSpaceUriGiven_(false)
     {}
@@ -41,7 +43,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(const string& idString, const string& nameSpaceUri)
     : nameSpaceIndex_(0),
-      nameSpaceUri_(nameSpaceUri),
+      nameSpaceUri_(NamespaceUriTable::intern(nameSpaceUri)),
       identifier_(idString),
       nameSpaceIndexGiven_(false),
       nameSpaceUriGiven_(true)
@@ -55,7 +57,7 @@ namespace uaf
             const string& nameSpaceUri,
             NameSpaceIndex nameSpaceIndex)
     : nameSpaceIndex_(nameSpaceIndex),
-      nameSpaceUri_(nameSpaceUri),
+      nameSpaceUri_(NamespaceUriTable::intern(nameSpaceUri)),
       identifier_(idString),
       nameSpaceIndexGiven_(true),
       nameSpaceUriGiven_(true)
@@ -66,6 +68,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(const string& idString, NameSpaceIndex nameSpaceIndex)
     : nameSpaceIndex_(nameSpaceIndex),
+      nameSpaceUri_(NamespaceUriTable::empty()),
       identifier_(idString),
       nameSpaceIndexGiven_(true),
       nameSpaceUriGiven_(false)
@@ -76,7 +79,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(uint32_t idNumeric, const string& nameSpaceUri)
     : nameSpaceIndex_(0),
-      nameSpaceUri_(nameSpaceUri),
+      nameSpaceUri_(NamespaceUriTable::intern(nameSpaceUri)),
       identifier_(idNumeric),
       nameSpaceIndexGiven_(false),
       nameSpaceUriGiven_(true)
@@ -87,7 +90,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(uint32_t idNumeric, const string& nameSpaceUri, NameSpaceIndex nameSpaceIndex)
     : nameSpaceIndex_(nameSpaceIndex),
-      nameSpaceUri_(nameSpaceUri),
+      nameSpaceUri_(NamespaceUriTable::intern(nameSpaceUri)),
       identifier_(idNumeric),
       nameSpaceIndexGiven_(true),
       nameSpaceUriGiven_(true)
@@ -98,6 +101,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(uint32_t idNumeric, NameSpaceIndex nameSpaceIndex)
     : nameSpaceIndex_(nameSpaceIndex),
+      nameSpaceUri_(NamespaceUriTable::empty()),
       identifier_(idNumeric),
       nameSpaceIndexGiven_(true),
       nameSpaceUriGiven_(false)
@@ -108,7 +112,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(const Guid& idGuid, const string& nameSpaceUri)
     : nameSpaceIndex_(0),
-      nameSpaceUri_(nameSpaceUri),
+      nameSpaceUri_(NamespaceUriTable::intern(nameSpaceUri)),
       identifier_(idGuid),
       nameSpaceIndexGiven_(false),
       nameSpaceUriGiven_(true)
@@ -119,7 +123,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(const Guid& idGuid, const string& nameSpaceUri, NameSpaceIndex nameSpaceIndex)
     : nameSpaceIndex_(nameSpaceIndex),
-      nameSpaceUri_(nameSpaceUri),
+      nameSpaceUri_(NamespaceUriTable::intern(nameSpaceUri)),
       identifier_(idGuid),
       nameSpaceIndexGiven_(true),
       nameSpaceUriGiven_(true)
@@ -130,6 +134,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(const Guid& idGuid, NameSpaceIndex nameSpaceIndex)
     : nameSpaceIndex_(nameSpaceIndex),
+      nameSpaceUri_(NamespaceUriTable::empty()),
       identifier_(idGuid),
       nameSpaceIndexGiven_(true),
       nameSpaceUriGiven_(false)
@@ -140,7 +145,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(const NodeIdIdentifier& identifier, const string& nameSpaceUri)
     : nameSpaceIndex_(0),
-      nameSpaceUri_(nameSpaceUri),
+      nameSpaceUri_(NamespaceUriTable::intern(nameSpaceUri)),
       identifier_(identifier),
       nameSpaceIndexGiven_(false),
       nameSpaceUriGiven_(true)
@@ -151,7 +156,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(const NodeIdIdentifier& identifier, const string& nameSpaceUri, NameSpaceIndex nameSpaceIndex)
     : nameSpaceIndex_(nameSpaceIndex),
-      nameSpaceUri_(nameSpaceUri),
+      nameSpaceUri_(NamespaceUriTable::intern(nameSpaceUri)),
       identifier_(identifier),
       nameSpaceIndexGiven_(true),
       nameSpaceUriGiven_(true)
@@ -162,6 +167,7 @@ namespace uaf
     // =============================================================================================
     NodeId::NodeId(const NodeIdIdentifier& identifier, NameSpaceIndex nameSpaceIndex)
     : nameSpaceIndex_(nameSpaceIndex),
+      nameSpaceUri_(NamespaceUriTable::empty()),
       identifier_(identifier),
       nameSpaceIndexGiven_(true),
       nameSpaceUriGiven_(false)
@@ -191,7 +197,7 @@ namespace uaf
             ss << "=" << nameSpaceIndex_;
 
         if (nameSpaceUriGiven_)
-            ss << "='" << nameSpaceUri_ << "'";
+            ss << "='" << nameSpaceUri_->uri << "'";
 
         if ( (!nameSpaceIndexGiven_) && (!nameSpaceUriGiven_) )
             ss << "=???";
@@ -272,7 +278,7 @@ namespace uaf
         nameSpaceIndexGiven_ = true;
         nameSpaceUriGiven_ = true;
         nameSpaceIndex_ = opcUaNodeId.NamespaceIndex;
-        nameSpaceUri_ = nameSpaceUri;
+        nameSpaceUri_ = NamespaceUriTable::intern(nameSpaceUri);
         return identifier_.fromSdk(opcUaNodeId);
     }
 
@@ -308,13 +314,24 @@ namespace uaf
     }
 
 
+    // Get a hash
+    // =============================================================================================
+    uint32_t NodeId::hash() const
+    {
+        uint32_t ret = identifier_.hash();
+        hashCombine(ret, uint32_t(nameSpaceIndex_));
+        hashCombine(ret, nameSpaceUri_->id);
+        return ret;
+    }
+
+
     // operator==
     // =============================================================================================
     bool operator==(const NodeId& object1, const NodeId& object2)
     {
         return    object1.identifier_ == object2.identifier_
                && object1.nameSpaceIndex_ == object2.nameSpaceIndex_
-               && object1.nameSpaceUri_ == object2.nameSpaceUri_;
+               && object1.nameSpaceUri_ == object2.nameSpaceUri_; // interned, so same pointer
     }
 
 
@@ -338,9 +355,13 @@ namespace uaf
         {
             return object1.nameSpaceIndex_ < object2.nameSpaceIndex_;
         }
+        else if (object1.nameSpaceUri_ != object2.nameSpaceUri_)
+        {
+            return object1.nameSpaceUri_->uri < object2.nameSpaceUri_->uri;
+        }
         else
         {
-            return object1.nameSpaceUri_ < object2.nameSpaceUri_;
+            return false;
         }
     }
 
@@ -28,6 +28,7 @@
 #include "uaf/util/util.h"
 #include "uaf/util/constants.h"
 #include "uaf/util/nodeididentifier.h"
+#include "uaf/util/namespaceuritable.h"
 #include "uaf/util/status.h"
 // SDK
 
@@ -197,7 +198,7 @@ namespace uaf
          *
          * @return  True if the NodeId has a namespace URI.
          */
-        bool hasNameSpaceUri() const { return nameSpaceUriGiven_ && (!nameSpaceUri_.empty()); }
+        bool hasNameSpaceUri() const { return nameSpaceUriGiven_ && (nameSpaceUri_->id != 0); }
 
 
         /**
@@ -213,7 +214,15 @@ namespace uaf
          *
          * @return  The namespace URI of the NodeId.
          */
-        std::string nameSpaceUri()   const { return nameSpaceUri_; }
+        std::string nameSpaceUri()   const { return nameSpaceUri_->uri; }
+
+
+        /**
+         * Get the interned namespace URI (see uaf::NamespaceUriTable).
+         *
+         * @return  The interned namespace URI of the NodeId (never 0).
+         */
+        const uaf::NamespaceUriTable::Entry* nameSpaceUriEntry() const { return nameSpaceUri_; }
 
 
         /**
@@ -231,6 +240,15 @@ namespace uaf
          * @param uri   The namespace URI of the NodeId.
          */
         void setNameSpaceUri(const std::string& uri)
+        { nameSpaceUri_ = uaf::NamespaceUriTable::intern(uri); nameSpaceUriGiven_ = true; }
+
+
+        /**
+         * Set the namespace URI to an URI that has already been interned.
+         *
+         * @param uri   The interned namespace URI of the NodeId (not 0).
+         */
+        void setNameSpaceUri(const uaf::NamespaceUriTable::Entry* uri)
         { nameSpaceUri_ = uri; nameSpaceUriGiven_ = true; }
 
 
@@ -313,6 +331,17 @@ namespace uaf
 
 
 
+        /**
+         * Get a hash of the NodeId.
+         *
+         * Equal NodeIds have equal hashes, so the hash can be used to store NodeIds in hashed
+         * containers. Since the namespace URI is interned, only its id is hashed.
+         *
+         * @return  The hash.
+         */
+        uint32_t hash() const;
+
+
         // comparison operators
         friend UAF_EXPORT bool operator==(const NodeId& object1, const NodeId& object2);
         friend UAF_EXPORT bool operator!=(const NodeId& object1, const NodeId& object2);
@@ -321,8 +350,8 @@ namespace uaf
     private:
         // namespace index
         uaf::NameSpaceIndex     nameSpaceIndex_;
-        // namespace URI
-        std::string             nameSpaceUri_;
+        // namespace URI (interned, so it is never 0)
+        const uaf::NamespaceUriTable::Entry* nameSpaceUri_;
         // identifier part of the NodeId
         uaf::NodeIdIdentifier   identifier_;
         // true if a namespace index was provided
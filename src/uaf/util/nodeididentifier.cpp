@@ -19,6 +19,7 @@
  */
 
 #include "uaf/util/nodeididentifier.h"
+#include "uaf/util/helperfunctions.h"
 
 
 namespace uaf
@@ -151,6 +152,20 @@ namespace uaf
     }
 
 
+    // Get a hash
+    // =============================================================================================
+    uint32_t NodeIdIdentifier::hash() const
+    {
+        uint32_t ret = HASH_SEED;
+        hashCombine(ret, uint32_t(type));
+        hashCombine(ret, idNumeric);
+        hashCombine(ret, idString);
+        hashCombine(ret, idOpaque.data(), std::size_t(idOpaque.length()));
+        // (the Guid identifiers are rare, so they are only compared, not hashed)
+        return ret;
+    }
+
+
     // operator==
     // =============================================================================================
     bool operator==(const NodeIdIdentifier& object1, const NodeIdIdentifier& object2)
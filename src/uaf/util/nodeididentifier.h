@@ -138,6 +138,16 @@ namespace uaf
         uaf::Status fromSdk(const OpcUa_NodeId& opcUaNodeId);
 
 
+        /**
+         * Get a hash of the identifier.
+         *
+         * Equal identifiers have equal hashes (Guid identifiers only contribute their type).
+         *
+         * @return The hash.
+         */
+        uint32_t hash() const;
+
+
         // comparison operators
         friend UAF_EXPORT bool operator==(
                 const NodeIdIdentifier& object1,
@@ -19,6 +19,7 @@
  */
 
 #include "uaf/util/qualifiedname.h"
+#include "uaf/util/helperfunctions.h"
 
 namespace uaf
 {
@@ -30,7 +31,8 @@ namespace uaf
     // Constructor
     // =============================================================================================
     QualifiedName::QualifiedName()
-    : nameSpaceIndex_(0),
+    : nameSpaceUri_(NamespaceUriTable::empty()),
+      nameSpaceIndex_(0),
       nameSpaceUriGiven_(false),
       nameSpaceIndexGiven_(false)
     {}
@@ -40,6 +42,7 @@ namespace uaf
     // =============================================================================================
     QualifiedName::QualifiedName(const string& name)
     : name_(name),
+      nameSpaceUri_(NamespaceUriTable::empty()),
       nameSpaceIndex_(0),
       nameSpaceUriGiven_(false),
       nameSpaceIndexGiven_(false)
@@ -50,6 +53,7 @@ namespace uaf
     // =============================================================================================
     QualifiedName::QualifiedName(const string& name, uint16_t nameSpaceIndex)
     : name_(name),
+      nameSpaceUri_(NamespaceUriTable::empty()),
       nameSpaceIndex_(nameSpaceIndex),
       nameSpaceUriGiven_(false),
       nameSpaceIndexGiven_(true)
@@ -60,7 +64,7 @@ namespace uaf
     // =============================================================================================
     QualifiedName::QualifiedName(const string& name, const string& nameSpaceUri)
     : name_(name),
-      nameSpaceUri_(nameSpaceUri),
+      nameSpaceUri_(NamespaceUriTable::intern(nameSpaceUri)),
       nameSpaceIndex_(0),
       nameSpaceUriGiven_(true),
       nameSpaceIndexGiven_(false)
@@ -74,7 +78,7 @@ namespace uaf
             const string&   nameSpaceUri,
             uint16_t        nameSpaceIndex)
     : name_(name),
-      nameSpaceUri_(nameSpaceUri),
+      nameSpaceUri_(NamespaceUriTable::intern(nameSpaceUri)),
       nameSpaceIndex_(nameSpaceIndex),
       nameSpaceUriGiven_(true),
       nameSpaceIndexGiven_(true)
@@ -85,7 +89,7 @@ namespace uaf
     // =============================================================================================
     bool QualifiedName::isNull() const
     {
-        return (!nameSpaceIndexGiven_) && (!nameSpaceUriGiven_) && nameSpaceUri_.empty();
+        return (!nameSpaceIndexGiven_) && (!nameSpaceUriGiven_) && (nameSpaceUri_->id == 0);
     }
 
 
@@ -117,6 +121,7 @@ namespace uaf
             name_ = "";
             nameSpaceIndex_ = 0;
             nameSpaceIndexGiven_ = false;
+            nameSpaceUri_ = NamespaceUriTable::empty();
             nameSpaceUriGiven_ = false;
 
         }
@@ -144,6 +149,7 @@ namespace uaf
             name_ = "";
             nameSpaceIndex_ = 0;
             nameSpaceIndexGiven_ = false;
+            nameSpaceUri_ = NamespaceUriTable::empty();
             nameSpaceUriGiven_ = false;
 
         }
@@ -156,7 +162,7 @@ namespace uaf
 
             nameSpaceIndex_ = destination.namespaceIndex();
             nameSpaceIndexGiven_ = true;
-            nameSpaceUri_ = nameSpaceUri;
+            nameSpaceUri_ = NamespaceUriTable::intern(nameSpaceUri);
             nameSpaceUriGiven_ = true;
         }
     }
@@ -174,6 +180,15 @@ namespace uaf
     // Set the namespace URI
     // =============================================================================================
     void QualifiedName::setNameSpaceUri(const std::string& nameSpaceUri)
+    {
+        nameSpaceUri_      = NamespaceUriTable::intern(nameSpaceUri);
+        nameSpaceUriGiven_ = true;
+    }
+
+
+    // Set the namespace URI to an interned URI
+    // =============================================================================================
+    void QualifiedName::setNameSpaceUri(const NamespaceUriTable::Entry* nameSpaceUri)
     {
         nameSpaceUri_      = nameSpaceUri;
         nameSpaceUriGiven_ = true;
@@ -198,7 +213,7 @@ namespace uaf
                 ss << "=" << nameSpaceIndex_;
 
             if (nameSpaceUriGiven_)
-                ss << "='" << nameSpaceUri_ << "'";
+                ss << "='" << nameSpaceUri_->uri << "'";
 
             if ( (!nameSpaceIndexGiven_) && (!nameSpaceUriGiven_) )
                 ss << "=???";
@@ -210,6 +225,18 @@ namespace uaf
     }
 
 
+    // Get a hash
+    // =============================================================================================
+    uint32_t QualifiedName::hash() const
+    {
+        uint32_t ret = HASH_SEED;
+        hashCombine(ret, name_);
+        hashCombine(ret, uint32_t(nameSpaceIndex_));
+        hashCombine(ret, nameSpaceUri_->id);
+        return ret;
+    }
+
+
     // Comparison operator ==
     // =============================================================================================
     bool operator==(const QualifiedName& object1, const QualifiedName& object2)
@@ -236,8 +263,10 @@ namespace uaf
             return object1.name_ < object2.name_;
         else if (object1.nameSpaceIndex_ != object2.nameSpaceIndex_)
             return object1.nameSpaceIndex_ < object2.nameSpaceIndex_;
+        else if (object1.nameSpaceUri_ != object2.nameSpaceUri_)
+            return object1.nameSpaceUri_->uri < object2.nameSpaceUri_->uri;
         else
-            return object1.nameSpaceUri_ < object2.nameSpaceUri_;
+            return false;
     }
 
 }
@@ -30,6 +30,7 @@
 #include "uabase/uaqualifiedname.h"
 // UAF
 #include "uaf/util/util.h"
+#include "uaf/util/namespaceuritable.h"
 
 
 namespace uaf
@@ -117,6 +118,14 @@ namespace uaf
         void setNameSpaceUri(const std::string& nameSpaceUri);
 
 
+        /**
+         * Change the namespace URI to an URI that has already been interned.
+         *
+         * @param nameSpaceUri      New interned namespace URI (not 0).
+         */
+        void setNameSpaceUri(const uaf::NamespaceUriTable::Entry* nameSpaceUri);
+
+
         /**
          * Change the namespace index.
          *
@@ -138,7 +147,7 @@ namespace uaf
          *
          * @return True if a non-empty namespace URI has been provided.
          */
-        bool hasNameSpaceUri()   const { return nameSpaceUriGiven_ && (!nameSpaceUri_.empty()); }
+        bool hasNameSpaceUri()   const { return nameSpaceUriGiven_ && (nameSpaceUri_->id != 0); }
 
 
         /**
@@ -162,7 +171,15 @@ namespace uaf
          *
          * @return  the namespace URI.
          */
-        const std::string& nameSpaceUri() const { return nameSpaceUri_; };
+        const std::string& nameSpaceUri() const { return nameSpaceUri_->uri; };
+
+
+        /**
+         * Get the interned namespace URI (see uaf::NamespaceUriTable).
+         *
+         * @return  the interned namespace URI (never 0).
+         */
+        const uaf::NamespaceUriTable::Entry* nameSpaceUriEntry() const { return nameSpaceUri_; };
 
 
         /**
@@ -210,6 +227,16 @@ namespace uaf
         void fromSdk(const UaQualifiedName& source, const std::string& nameSpaceUri);
 
 
+        /**
+         * Get a hash of the qualified name.
+         *
+         * Equal qualified names have equal hashes.
+         *
+         * @return  The hash.
+         */
+        uint32_t hash() const;
+
+
         // comparison operators
         friend UAF_EXPORT bool operator==(const QualifiedName& object1, const QualifiedName& object2);
         friend UAF_EXPORT bool operator!=(const QualifiedName& object1, const QualifiedName& object2);
@@ -218,8 +245,8 @@ namespace uaf
     private:
         // name part of the qualified name
         std::string  name_;
-        // namespace URI
-        std::string  nameSpaceUri_;
+        // namespace URI (interned, so it is never 0)
+        const uaf::NamespaceUriTable::Entry* nameSpaceUri_;
         // namespace index
         uint16_t     nameSpaceIndex_;
         // true if a namespace URI is given
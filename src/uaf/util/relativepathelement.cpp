@@ -19,6 +19,7 @@
  */
 
 #include "uaf/util/relativepathelement.h"
+#include "uaf/util/helperfunctions.h"
 
 namespace uaf
 {
@@ -88,6 +89,17 @@ namespace uaf
     }
 
 
+    // Get a hash
+    // =============================================================================================
+    uint32_t RelativePathElement::hash() const
+    {
+        uint32_t ret = targetName.hash();
+        hashCombine(ret, referenceType.hash());
+        hashCombine(ret, uint32_t(isInverse) | (uint32_t(includeSubtypes) << 1));
+        return ret;
+    }
+
+
     // operator==
     // =============================================================================================
     bool operator==(const RelativePathElement& object1, const RelativePathElement& object2)
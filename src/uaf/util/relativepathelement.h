@@ -105,6 +105,16 @@ namespace uaf
         std::string toString(const std::string& indent="", std::size_t colon=16) const;
 
 
+        /**
+         * Get a hash of the relative path element.
+         *
+         * Equal elements have equal hashes.
+         *
+         * @return The hash.
+         */
+        uint32_t hash() const;
+
+
         // comparison operators
         friend UAF_EXPORT bool operator==(
                 const RelativePathElement& object1,
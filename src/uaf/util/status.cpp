@@ -275,6 +275,7 @@ namespace uaf
         UAF_STATUS_COPY_ERROR(InvalidPrivateKeyError)
         UAF_STATUS_COPY_ERROR(SetPublishingModeInvocationError)
         UAF_STATUS_COPY_ERROR(DefinitionNotFoundError)
+        UAF_STATUS_COPY_ERROR(ReadNotPreparedError)
 
         // configuration errors
         UAF_STATUS_COPY_ERROR(ConfigurationError)
@@ -397,6 +398,7 @@ namespace uaf
         UAF_STATUS_TOSTRING_ELSE_IF(InvalidPrivateKeyError)
         UAF_STATUS_TOSTRING_ELSE_IF(SetPublishingModeInvocationError)
         UAF_STATUS_TOSTRING_ELSE_IF(DefinitionNotFoundError)
+        UAF_STATUS_TOSTRING_ELSE_IF(ReadNotPreparedError)
 
         // configuration errors
         UAF_STATUS_TOSTRING_ELSE_IF(ConfigurationError)
@@ -185,6 +185,7 @@ namespace uaf
         UAF_STATUS_CONSTRUCTOR(DeleteSubscriptionError)
         UAF_STATUS_CONSTRUCTOR(SetMonitoringModeInvocationError)
         UAF_STATUS_CONSTRUCTOR(DefinitionNotFoundError)
+        UAF_STATUS_CONSTRUCTOR(ReadNotPreparedError)
 
         // configuration errors
         UAF_STATUS_CONSTRUCTOR(ConfigurationError)
@@ -149,6 +149,7 @@ namespace uaf
                 UAF_STATUSCODES_TOSTRING(CouldNotCreateClientPrivateKeyLocationError)
                 UAF_STATUSCODES_TOSTRING(CouldNotCreateClientCertificateLocationError)
                 UAF_STATUSCODES_TOSTRING(DefinitionNotFoundError)
+                UAF_STATUSCODES_TOSTRING(ReadNotPreparedError)
                 // status codes kept for backwards compatibility:
                 UAF_STATUSCODES_TOSTRING(DataFormatError)
                 UAF_STATUSCODES_TOSTRING(DataSizeError)
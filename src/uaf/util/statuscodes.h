@@ -160,6 +160,7 @@ namespace uaf
             CouldNotCreateClientPrivateKeyLocationError,
             CouldNotCreateClientCertificateLocationError,
             DefinitionNotFoundError,
+            ReadNotPreparedError,
             // status codes kept for backwards compatibility:
             DataFormatError,
             DataSizeError,
@@ -29,6 +29,7 @@ ALL_MODULES = [ "client_client",
                 "client_setmonitoringmode",
                 "client_kwargs",
                 "client_structures",
+                "client_futures",
                 "subscriptioninformation",
                 "sessioninformation",
                 "monitorediteminformation",
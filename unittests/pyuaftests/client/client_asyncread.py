@@ -47,6 +47,18 @@ class TestClass:
         self.lock.release()
 
 
+# define a TestClass with a callback that stores the results
+class StoringTestClass:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.results = []
+    
+    def myCallback(self, result):
+        self.lock.acquire()
+        self.results.append(result)
+        self.lock.release()
+
+
 # define a TestClass with a callback that lasts several seconds
 class LongLastingTestClass:
     def __init__(self):
@@ -157,6 +169,62 @@ class ClientAsyncReadTest(unittest.TestCase):
         # assert if all callback functions were successfully finished
         self.assertEqual( t.noOfSuccessFullyFinishedCallbacks , 30 )
     
+    def test_client_Client_processRequest_for_an_async_read_request_spanning_two_sessions(self):
+        t = StoringTestClass()
+        
+        # the target of the unknown server gets a session of its own, which cannot be connected,
+        # so its transaction fails while the transaction of the demo server succeeds
+        unknownAddress = Address(ExpandedNodeId(NodeId(opcuaidentifiers.OpcUaId_Server_Auditing, 0), 
+                                                "urn:UnknownServer"))
+        request = AsyncReadRequest([self.target0, ReadRequestTarget(unknownAddress), self.target2])
+        
+        asyncResult = self.client.processRequest(request, t.myCallback)
+        
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and len(t.results) == 0:
+            time.sleep(0.01)
+        
+        # give a (wrong) second callback the time to arrive
+        time.sleep(0.5)
+        
+        # the callback is called once, with the reassembled result
+        self.assertEqual( len(t.results) , 1 )
+        result = t.results[0]
+        self.assertEqual( result.requestHandle , asyncResult.requestHandle )
+        self.assertEqual( len(result.targets) , 3 )
+        self.assertTrue( result.targets[0].status.isGood() )
+        self.assertEqual( result.targets[0].data.type() , pyuaf.util.opcuatypes.Byte )
+        self.assertFalse( result.targets[1].status.isGood() )
+        self.assertTrue( result.targets[2].status.isGood() )
+        self.assertEqual( result.targets[2].data.type() , pyuaf.util.opcuatypes.Float )
+    
+    
+    def test_client_Client_processRequest_for_an_async_read_request_spanning_many_transactions(self):
+        t = StoringTestClass()
+        
+        # more targets than the server accepts in a single Read service call, so the request is
+        # split up into several transactions of the same session
+        targets = [self.target0, self.target1, self.target2] * 2000
+        
+        asyncResult = self.client.processRequest(AsyncReadRequest(targets), t.myCallback)
+        
+        t_timeout = time.time() + 10.0
+        while time.time() < t_timeout and len(t.results) == 0:
+            time.sleep(0.01)
+        
+        self.assertEqual( len(t.results) , 1 )
+        result = t.results[0]
+        self.assertTrue( result.overallStatus.isGood() )
+        self.assertEqual( len(result.targets) , len(targets) )
+        
+        # the targets are in the order of the request
+        for i in [0, 2999, len(targets) - 1]:
+            self.assertTrue( result.targets[i].status.isGood() )
+        self.assertEqual( result.targets[0].data.type()  , pyuaf.util.opcuatypes.Byte )
+        self.assertEqual( result.targets[2999].data.type() , pyuaf.util.opcuatypes.Float )
+        self.assertEqual( result.targets[-2].data.type() , pyuaf.util.opcuatypes.Int32 )
+    
+    
     def tearDown(self):
         # delete the client instances manually (now!) instead of letting them be garbage collected 
         # automatically (which may happen during a another test, and which may cause logging output
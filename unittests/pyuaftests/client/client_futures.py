@@ -0,0 +1,159 @@
+import pyuaf
+import unittest
+from pyuaf.util.unittesting import parseArgs
+
+from pyuaf.util import NodeId, Address, ExpandedNodeId, opcuaidentifiers
+from pyuaf.client import ReadFuture
+from pyuaf.client.requests import ReadRequest, BrowseRequest
+
+
+ARGS = parseArgs()
+
+
+def suite(args=None):
+    if args is not None:
+        global ARGS
+        ARGS = args
+
+    return unittest.TestLoader().loadTestsFromTestCase(ClientFuturesTest)
+
+
+
+class ClientFuturesTest(unittest.TestCase):
+
+
+    def setUp(self):
+
+        # create a new ClientSettings instance and add the localhost to the URLs to discover
+        settings = pyuaf.client.settings.ClientSettings()
+        settings.discoveryUrls.append(ARGS.demo_url)
+        settings.applicationName = "client"
+        settings.logToStdOutLevel = ARGS.loglevel
+
+        self.client = pyuaf.client.Client(settings)
+
+        serverUri = ARGS.demo_server_uri
+        demoNsUri = ARGS.demo_ns_uri
+
+        self.id0 = NodeId(opcuaidentifiers.OpcUaId_Server_Auditing, 0)
+
+        self.address0       = Address(ExpandedNodeId(self.id0, serverUri))
+        self.address_Demo   = Address(ExpandedNodeId("Demo", demoNsUri, serverUri))
+        self.address_Double = Address(ExpandedNodeId("Demo.Static.Scalar.Double", demoNsUri, serverUri))
+
+        # an address of a server that cannot be found, so that the request must fail
+        self.address_Unknown = Address(ExpandedNodeId(self.id0, "urn:UnknownServer"))
+
+
+    def test_client_Client_readAsync_completes(self):
+        req = ReadRequest(2)
+        req.targets[0].address = self.address0
+        req.targets[1].address = self.address_Double
+
+        future = self.client.readAsync(req)
+
+        self.assertTrue( future.isValid() )
+        self.assertNotEqual( future.requestHandle() , pyuaf.util.constants.REQUESTHANDLE_NOT_ASSIGNED )
+
+        result = future.get()
+
+        self.assertTrue( future.isReady() )
+        self.assertTrue( result.overallStatus.isGood() )
+        self.assertEqual( len(result.targets) , 2 )
+        self.assertEqual( result.targets[0].data.value , False )
+        self.assertEqual( type(result.targets[1].data) , pyuaf.util.primitives.Double )
+
+        # the result stays available
+        self.assertEqual( future.get().requestHandle , result.requestHandle )
+        self.assertEqual( future.get().targets[0].data.value , False )
+
+
+    def test_client_Client_readAsync_propagates_failures(self):
+        req = ReadRequest(1)
+        req.targets[0].address = self.address_Unknown
+
+        future = self.client.readAsync(req)
+
+        # the future must also become ready if the request fails
+        future.wait()
+        self.assertTrue( future.isReady() )
+
+        result = future.get()
+        self.assertFalse( result.overallStatus.isGood() )
+
+
+    def test_client_Client_readAsync_many_futures_can_be_waited_for(self):
+        futures = []
+        for i in xrange(20):
+            req = ReadRequest(1)
+            req.targets[0].address = self.address_Double
+            futures.append(self.client.readAsync(req))
+
+        # all futures belong to a different request
+        self.assertEqual( len(set([f.requestHandle() for f in futures])) , len(futures) )
+
+        for f in futures:
+            f.wait()
+
+        for f in futures:
+            self.assertTrue( f.isReady() )
+            self.assertTrue( f.get().overallStatus.isGood() )
+
+
+    def test_client_Client_readAsync_copies_share_the_result(self):
+        req = ReadRequest(1)
+        req.targets[0].address = self.address0
+
+        future = self.client.readAsync(req)
+        copy   = ReadFuture(future)
+
+        future.wait()
+
+        self.assertTrue( copy.isReady() )
+        self.assertEqual( copy.requestHandle() , future.requestHandle() )
+        self.assertEqual( copy.get().requestHandle , future.get().requestHandle )
+        self.assertEqual( copy.get().targets[0].data.value , False )
+
+
+    def test_client_Client_invalid_future(self):
+        future = ReadFuture()
+
+        self.assertFalse( future.isValid() )
+        self.assertFalse( future.isReady() )
+
+        # waiting for an invalid future returns immediately
+        future.wait()
+        self.assertEqual( len(future.get().targets) , 0 )
+
+
+    def test_client_Client_browseAsync_completes(self):
+        req = BrowseRequest(1)
+        req.targets[0].address = self.address_Demo
+
+        future = self.client.browseAsync(req)
+        result = future.get()
+
+        self.assertTrue( future.isReady() )
+        self.assertTrue( result.overallStatus.isGood() )
+        self.assertGreaterEqual( len(result.targets[0].references) , 5 )
+
+
+    def test_client_Client_browseAsync_propagates_failures(self):
+        req = BrowseRequest(1)
+        req.targets[0].address = self.address_Unknown
+
+        result = self.client.browseAsync(req).get()
+
+        self.assertFalse( result.overallStatus.isGood() )
+
+
+    def tearDown(self):
+        # delete the client instances manually (now!) instead of letting them be garbage collected
+        # automatically (which may happen during another test, and which may cause logging output
+        # of the destruction to be mixed with the logging output of the other test).
+        del self.client
+
+
+
+if __name__ == '__main__':
+    unittest.TextTestRunner(verbosity = ARGS.verbosity).run(suite())
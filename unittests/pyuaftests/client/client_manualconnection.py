@@ -36,6 +36,20 @@ def connect(c, uri, i, unique, results):
     finally:
         results.finish()
 
+def connectAndInspect(c, uri, results):
+    try:
+        # connect the session (all threads use the same settings)
+        id = c.manuallyConnect(uri, pyuaf.client.settings.SessionSettings())
+        
+        # store the id and the session information as this thread sees it
+        results.appendToList("id", id)
+        results.appendToList("info", c.sessionInformation(id))
+        
+    except Exception, e:
+        results.fail()
+    finally:
+        results.finish()
+
 def disconnect(c, id, results):
     try:
         c.manuallyDisconnect(id)
@@ -75,6 +89,17 @@ class ClientManualConnectionTest(unittest.TestCase):
         self.assertEqual( self.clientConnectionId0 , 0 )
         self.assertEqual( self.clientConnectionId1 , 1 )
     
+    def test_client_Client_manuallyConnect_reuses_sessions_with_equal_settings(self):
+        self.help_manuallyConnect()
+        
+        settings = pyuaf.client.settings.SessionSettings()
+        settings.sessionTimeoutSec = 0.12345
+        
+        self.assertEqual( settings.fingerprint() , self.sessionSettings1.fingerprint() )
+        self.assertNotEqual( settings.fingerprint() , self.sessionSettings0.fingerprint() )
+        self.assertEqual( self.client.manuallyConnect(ARGS.demo_server_uri, settings) , self.clientConnectionId1 )
+        self.assertEqual( len(self.client.allSessionInformations()) , 2 )
+    
     def test_client_Client_sessionInformation(self):
         self.help_manuallyConnect()
         info0 = self.client.sessionInformation(self.clientConnectionId0)
@@ -180,6 +205,54 @@ class ClientManualConnectionTest(unittest.TestCase):
         # check if we now have 1 session
         self.assertEqual( len(self.client.allSessionInformations()) , 1 )
     
+    def help_connectManyTimesInParallel(self, uri, res):
+        threads = [threading.Thread(target=connectAndInspect, args=(self.client, uri, res)) 
+                   for i in xrange(res.total())]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join(10.0)
+    
+    def test_client_Client_manuallyConnect_in_parallel_shares_the_connection_attempt(self):
+        testResults = TestResults(10)
+        testResults.initializeList("id")
+        testResults.initializeList("info")
+        
+        self.help_connectManyTimesInParallel(ARGS.demo_server_uri, testResults)
+        
+        self.assertEqual( testResults.failed() , 0 )
+        
+        # all threads got the same session ...
+        ids = testResults.getListCopy("id")
+        self.assertEqual( len(ids) , testResults.total() )
+        self.assertEqual( len(set(ids)) , 1 )
+        self.assertEqual( len(self.client.allSessionInformations()) , 1 )
+        
+        # ... and none of them returned before the session was connected
+        for info in testResults.getListCopy("info"):
+            self.assertEqual( info.sessionState , pyuaf.client.sessionstates.Connected )
+            self.assertTrue( info.lastConnectionAttemptStatus.isGood() )
+    
+    def test_client_Client_manuallyConnect_in_parallel_to_an_unknown_server_shares_the_failure(self):
+        testResults = TestResults(10)
+        testResults.initializeList("id")
+        testResults.initializeList("info")
+        
+        self.help_connectManyTimesInParallel("urn:UnknownServer", testResults)
+        
+        self.assertEqual( testResults.failed() , 0 )
+        
+        # all threads got the same (unconnected) session ...
+        ids = testResults.getListCopy("id")
+        self.assertEqual( len(ids) , testResults.total() )
+        self.assertEqual( len(set(ids)) , 1 )
+        self.assertEqual( len(self.client.allSessionInformations()) , 1 )
+        
+        # ... and all of them saw the failure of the single connection attempt
+        for info in testResults.getListCopy("info"):
+            self.assertNotEqual( info.sessionState , pyuaf.client.sessionstates.Connected )
+            self.assertTrue( info.lastConnectionAttemptStatus.isBad() )
+    
     def tearDown(self):
         # delete the client instances manually (now!) instead of letting them be garbage collected 
         # automatically (which may happen during a another test, and which may cause logging output
@@ -28,11 +28,23 @@ class MyClient(pyuaf.client.Client):
         pyuaf.client.Client.__init__(self, settings)
         self.noOfSuccessFullyReceivedNotifications = 0
         self.lock = threading.Lock()
+        self.delay = 0.0
+        self.receivedValues = {}
+        self.newSettings = None
             
     def dataChangesReceived(self, notifications):
+        time.sleep(self.delay)
         self.lock.acquire()
         self.noOfSuccessFullyReceivedNotifications += len(notifications)
+        for notification in notifications:
+            self.receivedValues.setdefault(notification.clientHandle, []).append(notification.data)
+        newSettings = self.newSettings
+        self.newSettings = None
         self.lock.release()
+        
+        # the settings may be changed by a callback
+        if newSettings is not None:
+            self.setClientSettings(newSettings)
 
 
 # define a TestClass with a callback
@@ -47,6 +59,31 @@ class TestClass:
         self.lock.release()
 
 
+# define a callback object that can be registered for a ClientHandle
+class MyDataChangeCallback(pyuaf.client.DataChangeCallback):
+    def __init__(self, delay=0.0):
+        pyuaf.client.DataChangeCallback.__init__(self)
+        self.delay = delay
+        self.clientHandles = []
+        self.lock = threading.Lock()
+    
+    def __call__(self, notification):
+        time.sleep(self.delay)
+        self.lock.acquire()
+        self.clientHandles.append(notification.clientHandle)
+        self.lock.release()
+
+
+def dispatchDataChanges(client, clientHandles):
+    # let the C++ client dispatch the notifications to the registered callback objects
+    notifications = pyuaf.client.DataChangeNotificationVector()
+    for clientHandle in clientHandles:
+        notification = pyuaf.client.DataChangeNotification()
+        notification.clientHandle = clientHandle
+        notifications.append(notification)
+    pyuaf.client.ClientBase.__dispatch_dataChangesReceived__(client, notifications)
+
+
 
 
 class ClientMonitorDataTest(unittest.TestCase):
@@ -77,6 +114,11 @@ class ClientMonitorDataTest(unittest.TestCase):
         self.address_Int32           = Address(self.address_Scalar, [RelativePathElement(QualifiedName("Int32", demoNsUri))] )
         self.address_Float           = Address(self.address_Scalar, [RelativePathElement(QualifiedName("Float", demoNsUri))] )
         
+        # static variables that only change when we write them
+        self.staticAddresses = [Address(ExpandedNodeId("Demo.Static.Scalar.Int32", demoNsUri, serverUri)),
+                                Address(ExpandedNodeId("Demo.Static.Scalar.UInt32", demoNsUri, serverUri))]
+        self.staticTypes     = [pyuaf.util.primitives.Int32, pyuaf.util.primitives.UInt32]
+        
         # start the simulation (otherwise the dynamic variables won't change)
         self.client.call(self.address_Demo, self.address_StartSimulation)
     
@@ -108,6 +150,353 @@ class ClientMonitorDataTest(unittest.TestCase):
         self.assertGreaterEqual( t.noOfSuccessFullyReceivedNotifications , 2 )
     
 
+    def test_client_Client_createMonitoredData_with_notification_dispatch_threads(self):
+        settings = self.client.clientSettings()
+        settings.notificationDispatchEnable = True
+        settings.notificationDispatchThreads = 2
+        settings.notificationDispatchOverflowPolicy = pyuaf.client.overflowpolicies.DropOldest
+        self.client.setClientSettings(settings)
+        
+        t = TestClass()
+        
+        result = self.client.createMonitoredData([self.address_Byte, self.address_Int32, self.address_Float], 
+                                                 notificationCallbacks=[t.myCallback, t.myCallback, t.myCallback])
+        
+        # after a few seconds we should AT LEAST have received 2 notifications
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and t.noOfSuccessFullyReceivedNotifications < 2:
+            time.sleep(0.01)
+        
+        self.assertGreaterEqual( t.noOfSuccessFullyReceivedNotifications , 2 )
+        
+        statistics = self.client.notificationDispatchStatistics()
+        self.assertEqual( statistics.noOfThreads , 2 )
+        self.assertGreaterEqual( statistics.dispatchedNotifications , 2 )
+    
+    
+    def configureNotificationDispatch(self, overflowPolicy, threads=1, queueSize=1):
+        settings = self.client.clientSettings()
+        settings.notificationDispatchEnable = True
+        settings.notificationDispatchThreads = threads
+        settings.notificationDispatchQueueSize = queueSize
+        settings.notificationDispatchOverflowPolicy = overflowPolicy
+        self.client.setClientSettings(settings)
+    
+    
+    def monitorStaticNodes(self, noOfNodes):
+        addresses = self.staticAddresses[:noOfNodes]
+        
+        # start from a known value, so that all received values must be increasing
+        self.writeStaticNodes(noOfNodes, 0)
+        
+        # publish fast, so that many notifications arrive while the callback is busy
+        subSettings = pyuaf.client.settings.SubscriptionSettings()
+        subSettings.publishingIntervalSec = 0.1
+        result = self.client.createMonitoredData(addresses, subscriptionSettings = subSettings)
+        for target in result.targets:
+            self.assertTrue( target.status.isGood() )
+        return [target.clientHandle for target in result.targets]
+    
+    
+    def writeStaticNodes(self, noOfNodes, value):
+        types = self.staticTypes[:noOfNodes]
+        self.client.write(self.staticAddresses[:noOfNodes], [dataType(value) for dataType in types])
+    
+    
+    def writeIncreasingValues(self, noOfNodes, noOfValues):
+        for i in xrange(noOfValues):
+            self.writeStaticNodes(noOfNodes, i + 1)
+            time.sleep(0.2)
+    
+    
+    def waitForNotifications(self, noOfNotifications, timeout=10.0):
+        t_timeout = time.time() + timeout
+        while time.time() < t_timeout \
+                and self.client.noOfSuccessFullyReceivedNotifications < noOfNotifications:
+            time.sleep(0.01)
+    
+    
+    def test_client_Client_createMonitoredData_passes_the_values(self):
+        clientHandles = self.monitorStaticNodes(2)
+        self.writeStaticNodes(2, 7)
+        
+        # the data changes that were not handled as a batch are passed with their decoded values
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout \
+                and [self.client.receivedValues.get(h, [None])[-1] for h in clientHandles] \
+                    != [pyuaf.util.primitives.Int32(7), pyuaf.util.primitives.UInt32(7)]:
+            time.sleep(0.01)
+        
+        self.assertEqual( set(self.client.receivedValues.keys()) , set(clientHandles) )
+        self.assertEqual( self.client.receivedValues[clientHandles[0]][-1] , pyuaf.util.primitives.Int32(7) )
+        self.assertEqual( self.client.receivedValues[clientHandles[1]][-1] , pyuaf.util.primitives.UInt32(7) )
+    
+    
+    def test_client_Client_notification_dispatch_DropOldest_drops(self):
+        self.configureNotificationDispatch(pyuaf.client.overflowpolicies.DropOldest)
+        self.client.delay = 1.0
+        
+        self.monitorStaticNodes(2)
+        self.writeIncreasingValues(2, 10)
+        self.waitForNotifications(3)
+        
+        statistics = self.client.notificationDispatchStatistics()
+        self.assertGreater( statistics.droppedNotifications , 0 )
+        self.assertEqual( statistics.coalescedNotifications , 0 )
+        self.assertLessEqual( statistics.maxQueuedNotifications , 1 )
+    
+    
+    def test_client_Client_notification_dispatch_CoalesceLatest_coalesces(self):
+        self.configureNotificationDispatch(pyuaf.client.overflowpolicies.CoalesceLatest)
+        self.client.delay = 1.0
+        
+        [clientHandle] = self.monitorStaticNodes(1)
+        self.writeIncreasingValues(1, 10)
+        self.waitForNotifications(3)
+        
+        statistics = self.client.notificationDispatchStatistics()
+        self.assertGreater( statistics.coalescedNotifications , 0 )
+        self.assertEqual( statistics.droppedNotifications , 0 )
+        
+        # the latest value replaced the queued one, so the last written value is still received
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout \
+                and self.client.receivedValues[clientHandle][-1].value != 10:
+            time.sleep(0.01)
+        self.assertEqual( self.client.receivedValues[clientHandle][-1].value , 10 )
+    
+    
+    def test_client_Client_notification_dispatch_Block_never_drops(self):
+        self.configureNotificationDispatch(pyuaf.client.overflowpolicies.Block)
+        self.client.delay = 0.5
+        
+        self.monitorStaticNodes(2)
+        self.writeIncreasingValues(2, 10)
+        self.waitForNotifications(4)
+        
+        statistics = self.client.notificationDispatchStatistics()
+        self.assertGreaterEqual( statistics.dispatchedNotifications , 4 )
+        self.assertEqual( statistics.droppedNotifications , 0 )
+        self.assertEqual( statistics.coalescedNotifications , 0 )
+        self.assertLessEqual( statistics.maxQueuedNotifications , 1 )
+    
+    
+    def test_client_Client_notification_dispatch_keeps_the_order_per_clientHandle(self):
+        self.configureNotificationDispatch(pyuaf.client.overflowpolicies.Block, threads=2, queueSize=2)
+        self.client.delay = 0.1
+        
+        clientHandles = self.monitorStaticNodes(2)
+        self.writeIncreasingValues(2, 10)
+        self.waitForNotifications(6)
+        
+        # the written values increase, so they must be received in increasing order
+        for clientHandle in clientHandles:
+            values = [data.value for data in self.client.receivedValues[clientHandle]]
+            self.assertGreaterEqual( len(values) , 2 )
+            self.assertEqual( values , sorted(set(values)) )
+    
+    
+    def test_client_Client_notification_dispatch_keeps_the_order_when_disabled(self):
+        self.configureNotificationDispatch(pyuaf.client.overflowpolicies.Block, threads=1, queueSize=100)
+        self.client.delay = 0.3
+        
+        [clientHandle] = self.monitorStaticNodes(1)
+        self.writeIncreasingValues(1, 5)
+        
+        # disable the dispatcher while notifications are still queued: the newer notifications
+        # are passed directly, but only after the queued ones
+        settings = self.client.clientSettings()
+        settings.notificationDispatchEnable = False
+        self.client.setClientSettings(settings)
+        
+        for i in xrange(5):
+            self.writeStaticNodes(1, 6 + i)
+            time.sleep(0.2)
+        
+        t_timeout = time.time() + 10.0
+        while time.time() < t_timeout \
+                and self.client.receivedValues[clientHandle][-1].value != 10:
+            time.sleep(0.01)
+        
+        values = [data.value for data in self.client.receivedValues[clientHandle]]
+        self.assertEqual( values[-1] , 10 )
+        self.assertEqual( values , sorted(set(values)) )
+    
+    
+    def test_client_Client_notification_dispatch_can_be_reconfigured_by_a_callback(self):
+        self.configureNotificationDispatch(pyuaf.client.overflowpolicies.Block, threads=1, queueSize=10)
+        
+        # the callback changes the number of threads, so the dispatcher must not wait for the
+        # thread that is calling the callback
+        newSettings = self.client.clientSettings()
+        newSettings.notificationDispatchThreads = 2
+        self.client.newSettings = newSettings
+        
+        [clientHandle] = self.monitorStaticNodes(1)
+        self.writeIncreasingValues(1, 5)
+        self.waitForNotifications(3)
+        
+        self.assertIsNone( self.client.newSettings )
+        self.assertGreaterEqual( self.client.noOfSuccessFullyReceivedNotifications , 3 )
+        
+        statistics = self.client.notificationDispatchStatistics()
+        self.assertEqual( statistics.noOfThreads , 2 )
+        
+        # the notifications of the new threads still arrive in order
+        values = [data.value for data in self.client.receivedValues[clientHandle]]
+        self.assertEqual( values , sorted(set(values)) )
+    
+    
+    def test_client_Client_latestValue(self):
+        settings = self.client.clientSettings()
+        settings.latestValueStoreEnable = True
+        self.client.setClientSettings(settings)
+        
+        result = self.client.createMonitoredData([self.address_Byte, self.address_Int32, self.address_Float])
+        clientHandle = result.targets[1].clientHandle
+        
+        # after a few seconds the Int32 item should AT LEAST have received 2 values
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and self.client.latestValue(clientHandle).sequenceNumber < 2:
+            time.sleep(0.01)
+        
+        latestValue = self.client.latestValue(clientHandle)
+        self.assertEqual( latestValue.clientHandle , clientHandle )
+        self.assertGreaterEqual( latestValue.sequenceNumber , 2 )
+        self.assertEqual( latestValue.value.opcUaStatusCode , pyuaf.util.opcuastatuscodes.OpcUa_Good )
+        
+        # the same item can be found by its address
+        self.assertEqual( self.client.latestValue(self.address_Int32).clientHandle , clientHandle )
+        
+        self.assertEqual( len(self.client.latestValues()) , 3 )
+        
+        self.assertRaises(pyuaf.util.errors.UnknownClientHandleError, 
+                          self.client.latestValue, clientHandle + 1000)
+    
+
+    def test_client_Client_latestValue_of_a_node_monitored_twice(self):
+        settings = self.client.clientSettings()
+        settings.latestValueStoreEnable = True
+        self.client.setClientSettings(settings)
+        
+        # monitor the same node by two items of different subscriptions
+        resultA = self.client.createMonitoredData([self.address_Int32])
+        subSettings = pyuaf.client.settings.SubscriptionSettings()
+        subSettings.publishingIntervalSec = 0.5
+        resultB = self.client.createMonitoredData([self.address_Int32], subscriptionSettings = subSettings)
+        
+        clientHandleA = resultA.targets[0].clientHandle
+        clientHandleB = resultB.targets[0].clientHandle
+        self.assertNotEqual( resultA.targets[0].clientSubscriptionHandle , 
+                             resultB.targets[0].clientSubscriptionHandle )
+        
+        # the item that was added last provides the values of the node
+        self.assertEqual( self.client.latestValue(self.address_Int32).clientHandle , clientHandleB )
+        
+        # once it is removed, the other item still provides them
+        self.client.manuallyUnsubscribe(resultB.targets[0].clientConnectionId, 
+                                        resultB.targets[0].clientSubscriptionHandle)
+        
+        self.assertEqual( self.client.latestValue(self.address_Int32).clientHandle , clientHandleA )
+        self.assertRaises(pyuaf.util.errors.UnknownClientHandleError, 
+                          self.client.latestValue, clientHandleB)
+    
+
+    def test_client_Client_registerDataChangeCallback_several_per_clientHandle(self):
+        callbackA1 = MyDataChangeCallback()
+        callbackA2 = MyDataChangeCallback()
+        callbackB  = MyDataChangeCallback()
+        callbackAll = MyDataChangeCallback()
+        
+        self.client.registerDataChangeCallback(callbackA1, 1)
+        self.client.registerDataChangeCallback(callbackA2, 1)
+        self.client.registerDataChangeCallback(callbackB, 2)
+        self.client.registerDataChangeCallback(callbackAll)
+        
+        dispatchDataChanges(self.client, [1, 2, 3])
+        
+        self.assertEqual( callbackA1.clientHandles , [1] )
+        self.assertEqual( callbackA2.clientHandles , [1] )
+        self.assertEqual( callbackB.clientHandles , [2] )
+        self.assertEqual( callbackAll.clientHandles , [1, 2, 3] )
+        
+        # unregister both callbacks of the first ClientHandle
+        self.client.unregisterDataChangeCallbacks(1)
+        
+        dispatchDataChanges(self.client, [1, 2])
+        
+        self.assertEqual( callbackA1.clientHandles , [1] )
+        self.assertEqual( callbackA2.clientHandles , [1] )
+        self.assertEqual( callbackB.clientHandles , [2, 2] )
+        self.assertEqual( callbackAll.clientHandles , [1, 2, 3, 1, 2] )
+    
+    
+    def test_client_Client_registerDataChangeCallback_slow_callback_does_not_block_other_buckets(self):
+        # ClientHandles 1 and 2 are stored in different buckets of callbacks
+        slowCallback = MyDataChangeCallback(delay=2.0)
+        fastCallback = MyDataChangeCallback()
+        
+        self.client.registerDataChangeCallback(slowCallback, 1)
+        self.client.registerDataChangeCallback(fastCallback, 2)
+        
+        thread = threading.Thread(target=dispatchDataChanges, args=(self.client, [1]))
+        thread.start()
+        time.sleep(0.5)
+        
+        # the notification of the other ClientHandle is dispatched while the slow callback runs
+        t_start = time.time()
+        dispatchDataChanges(self.client, [2])
+        
+        self.assertTrue( time.time() - t_start < 1.0 )
+        self.assertEqual( fastCallback.clientHandles , [2] )
+        self.assertEqual( slowCallback.clientHandles , [] )
+        
+        thread.join(5.0)
+        self.assertEqual( slowCallback.clientHandles , [1] )
+    
+    
+    def test_client_Client_unregisterDataChangeCallbacks_waits_for_the_running_callbacks(self):
+        slowCallback = MyDataChangeCallback(delay=2.0)
+        self.client.registerDataChangeCallback(slowCallback, 1)
+        
+        thread = threading.Thread(target=dispatchDataChanges, args=(self.client, [1]))
+        thread.start()
+        time.sleep(0.5)
+        
+        # once unregistered, the callback is not in use anymore (so it could be deleted)
+        self.client.unregisterDataChangeCallbacks(1)
+        self.assertEqual( slowCallback.clientHandles , [1] )
+        
+        thread.join(5.0)
+        
+        # and it's not called anymore
+        dispatchDataChanges(self.client, [1])
+        self.assertEqual( slowCallback.clientHandles , [1] )
+    
+    
+    def test_client_Client_createMonitoredData_with_registered_callbacks(self):
+        result = self.client.createMonitoredData([self.address_Byte, self.address_Int32])
+        clientHandle = result.targets[0].clientHandle
+        
+        callback1 = MyDataChangeCallback()
+        callback2 = MyDataChangeCallback()
+        self.client.registerDataChangeCallback(callback1, clientHandle)
+        self.client.registerDataChangeCallback(callback2, clientHandle)
+        
+        # after a few seconds both callbacks should have received 2 notifications
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout \
+                and (len(callback1.clientHandles) < 2 or len(callback2.clientHandles) < 2):
+            time.sleep(0.01)
+        
+        self.assertGreaterEqual( len(callback1.clientHandles) , 2 )
+        self.assertGreaterEqual( len(callback2.clientHandles) , 2 )
+        self.assertEqual( set(callback1.clientHandles) , set([clientHandle]) )
+        
+        # the client itself still receives the notifications of all items
+        self.assertGreaterEqual( self.client.noOfSuccessFullyReceivedNotifications , 2 )
+    
+    
     def tearDown(self):
         # stop the simulation
         self.client.call(self.address_Demo, self.address_StopSimulation)
@@ -19,11 +19,13 @@ class MyClient(pyuaf.client.Client):
     def __init__(self, settings):
         pyuaf.client.Client.__init__(self, settings)
         self.noOfSuccessFullyReceivedNotifications = 0
+        self.receivedNotifications = []
         self.lock = threading.Lock()
             
     def eventsReceived(self, notifications):
         self.lock.acquire()
         self.noOfSuccessFullyReceivedNotifications += len(notifications)
+        self.receivedNotifications.extend(notifications)
         self.lock.release()
 
 
@@ -130,6 +132,26 @@ class ClientMonitorEventsTest(unittest.TestCase):
         self.assertGreaterEqual( self.client.noOfSuccessFullyReceivedNotifications , 1 )
     
 
+    def test_client_Client_createMonitoredEvents_passes_all_fields(self):
+        
+        # create the items
+        result = self.client.createMonitoredEvents([self.address_Alarms], self.eventFilter)
+        clientHandle = result.targets[0].clientHandle
+        
+        # now write a trigger so that an event will be generated
+        self.client.write([self.address_Trigger], [Double(self.highHighLimit + 1.0)])
+        
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and self.client.noOfSuccessFullyReceivedNotifications == 0:
+            time.sleep(0.01)
+        
+        # the events that were not handled as a batch are passed with all their selected fields
+        self.assertGreaterEqual( len(self.client.receivedNotifications) , 1 )
+        for notification in self.client.receivedNotifications:
+            self.assertEqual( notification.clientHandle , clientHandle )
+            self.assertEqual( len(notification.fields) , 3 )
+    
+
     def test_client_Client_createMonitoredEvents_with_callback(self):
         t = TestClass()
         
@@ -147,6 +169,115 @@ class ClientMonitorEventsTest(unittest.TestCase):
         self.assertGreaterEqual( t.noOfSuccessFullyReceivedNotifications , 1 )
     
 
+
+    def test_client_Client_createMonitoredEvents_with_model_change_events_enabled(self):
+        settings = self.client.clientSettings()
+        settings.addressCacheModelChangeEventsEnable = True
+        settings.discoveryIntervalSec = 0.5
+        self.client.setClientSettings(settings)
+        
+        # give the client some time to monitor the model changes of the server
+        time.sleep(2.0)
+        
+        # create the items
+        result = self.client.createMonitoredEvents([self.address_Alarms], self.eventFilter)
+        clientHandle = result.targets[0].clientHandle
+        
+        # now write a trigger so that an event will be generated
+        self.client.write([self.address_Trigger], [Double(self.highHighLimit + 1.0)])
+        
+        # the events of the address cache are not passed to the client, but ours are
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and self.client.noOfSuccessFullyReceivedNotifications == 0:
+            time.sleep(0.01)
+        
+        self.assertGreaterEqual( self.client.noOfSuccessFullyReceivedNotifications , 1 )
+        self.assertEqual( set([n.clientHandle for n in self.client.receivedNotifications]) ,
+                          set([clientHandle]) )
+        
+        # the cached addresses can still be used
+        res = self.client.read([self.address_LowLow, self.address_HighHigh])
+        self.assertTrue( res.overallStatus.isGood() )
+    
+    
+    def help_browseNames(self, address):
+        result = self.client.browse([address])
+        self.assertTrue( result.overallStatus.isGood() )
+        return dict([(ref.browseName.name(), ref.browseName) for ref in result.targets[0].references])
+    
+    def test_client_Client_model_change_events_invalidate_the_cached_addresses(self):
+        demoNsUri = ARGS.demo_ns_uri
+        serverUri = ARGS.demo_server_uri
+        
+        address_Dynamic = Address(ExpandedNodeId("Demo.DynamicNodes", demoNsUri, serverUri))
+        address_Create  = Address(ExpandedNodeId("Demo.DynamicNodes.CreateDynamicNode", demoNsUri, serverUri))
+        address_Delete  = Address(ExpandedNodeId("Demo.DynamicNodes.DeleteDynamicNode", demoNsUri, serverUri))
+        
+        # make sure the dynamic node doesn't exist yet, and find its name once it's created
+        try:
+            self.client.call(address_Dynamic, address_Delete)
+        except pyuaf.util.errors.UafError:
+            pass
+        namesBefore = self.help_browseNames(address_Dynamic)
+        self.client.call(address_Dynamic, address_Create)
+        namesAfter = self.help_browseNames(address_Dynamic)
+        newNames = [name for name in namesAfter if name not in namesBefore]
+        self.assertEqual( len(newNames) , 1 )
+        
+        # a relative path to the dynamic node, and one that passes through its parent
+        elem = RelativePathElement(namesAfter[newNames[0]])
+        address_Node     = Address(address_Dynamic, [elem])
+        address_Indirect = Address(self.address_Demo, [RelativePathElement(QualifiedName("DynamicNodes", demoNsUri)), elem])
+        
+        settings = self.client.clientSettings()
+        settings.addressCacheModelChangeEventsEnable = True
+        settings.discoveryIntervalSec = 0.5
+        self.client.setClientSettings(settings)
+        
+        # give the client some time to monitor the model changes of the server
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout and len(self.client.allSubscriptionInformations()) == 0:
+            time.sleep(0.1)
+        time.sleep(1.0)
+        
+        # cache the addresses
+        res = self.client.read([address_Node, address_Indirect], attributeids.BrowseName)
+        self.assertTrue( res.overallStatus.isGood() )
+        
+        # reading them again doesn't translate them anymore
+        translated = self.client.resolutionStatistics().translatedBrowsePaths
+        res = self.client.read([address_Node, address_Indirect], attributeids.BrowseName)
+        self.assertTrue( res.overallStatus.isGood() )
+        self.assertEqual( self.client.resolutionStatistics().translatedBrowsePaths , translated )
+        
+        # delete the node: once the model change event arrives, the cached addresses are removed,
+        # so they are translated again (and fail, since the node doesn't exist anymore)
+        self.client.call(address_Dynamic, address_Delete)
+        
+        request = pyuaf.client.requests.ReadRequest(2)
+        request.targets[0].address = address_Node
+        request.targets[1].address = address_Indirect
+        request.targets[0].attributeId = attributeids.BrowseName
+        request.targets[1].attributeId = attributeids.BrowseName
+        
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout \
+                and self.client.resolutionStatistics().translatedBrowsePaths == translated:
+            pyuaf.client.ClientBase.processRequest(self.client, request, pyuaf.client.results.ReadResult())
+            time.sleep(0.1)
+        
+        self.assertGreater( self.client.resolutionStatistics().translatedBrowsePaths , translated )
+        
+        # both addresses are gone from the cache
+        translated = self.client.resolutionStatistics().translatedBrowsePaths
+        res = pyuaf.client.results.ReadResult()
+        pyuaf.client.ClientBase.processRequest(self.client, request, res)
+        self.assertFalse( res.targets[0].status.isGood() )
+        self.assertFalse( res.targets[1].status.isGood() )
+        self.assertEqual( self.client.resolutionStatistics().translatedBrowsePaths , translated + 2 )
+        
+        # the model change events are not passed to the client
+        self.assertEqual( self.client.noOfSuccessFullyReceivedNotifications , 0 )
     
     
     def tearDown(self):
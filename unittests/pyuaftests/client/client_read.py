@@ -1,12 +1,14 @@
+import os
 import pyuaf
 import time
+import tempfile
 import thread
 import unittest
 from pyuaf.util.unittesting import parseArgs
 
 from pyuaf.util import NodeId, Address, ExpandedNodeId, BrowsePath, \
                        RelativePathElement, QualifiedName, opcuaidentifiers
-from pyuaf.client.requests import ReadRequest, ReadRequestTarget
+from pyuaf.client.requests import ReadRequest, ReadRequestTarget, WriteRequest, WriteRequestTarget
 from pyuaf.client.results  import ReadResult,  ReadResultTarget
 
 
@@ -120,6 +122,592 @@ class ClientReadTest(unittest.TestCase):
         self.assertEqual( res8.targets[0].data , pyuaf.util.LocalizedText("", "Boiler1") )
         self.assertEqual( res8.targets[1].data.value , False )
     
+    def test_client_Client_read_with_parallel_invocation_enabled(self):
+        settings = self.client.clientSettings()
+        settings.parallelInvocationEnable = True
+        settings.parallelInvocationMaxThreads = 2
+        self.client.setClientSettings(settings)
+
+        # the target of the unknown server gets a session of its own (which cannot be connected),
+        # so the request is invoked on two sessions concurrently
+        unknownAddress = Address(ExpandedNodeId(self.id0, "urn:UnknownServer"))
+        req = ReadRequest([ReadRequestTarget(self.address0),
+                           ReadRequestTarget(unknownAddress),
+                           ReadRequestTarget(self.address5)])
+
+        # call the ClientBase directly, since Client.processRequest() raises the overall error
+        res = ReadResult()
+        status = pyuaf.client.ClientBase.processRequest(self.client, req, res)
+
+        self.assertEqual( len(self.client.allSessionInformations()) , 2 )
+
+        # the invocation of the unknown server failed, the other one was still executed
+        self.assertFalse( status.isGood() )
+        self.assertTrue( res.targets[0].status.isGood() )
+        self.assertEqual( res.targets[0].data.value , False )
+        self.assertTrue( res.targets[2].status.isGood() )
+        self.assertEqual( res.targets[2].data.type() , pyuaf.util.opcuatypes.Double )
+
+    def test_client_Client_read_more_targets_than_the_operation_limits(self):
+        settings = self.client.clientSettings()
+        settings.operationLimitsChunksInFlight = 2
+        self.client.setClientSettings(settings)
+
+        # more targets than most servers accept in a single Read service call
+        addresses = [self.address0, self.address2] * 2500
+
+        res = self.client.read(addresses)
+
+        self.assertTrue( res.overallStatus.isGood() )
+        self.assertEqual( len(res.targets) , len(addresses) )
+        self.assertEqual( res.targets[0].data.value , False )
+        self.assertEqual( res.targets[-2].data.value , False )
+        self.assertTrue( res.targets[-1].status.isGood() )
+
+    def test_client_Client_execute_a_prepared_read(self):
+        target0 = ReadRequestTarget(self.address0)
+        target7 = ReadRequestTarget(self.address7)
+
+        preparedRead = self.client.prepare(ReadRequest([target0, target7]))
+        self.assertTrue( preparedRead.isPrepared() )
+
+        res1 = self.client.execute(preparedRead)
+        res2 = self.client.execute(preparedRead)
+
+        for res in [res1, res2]:
+            self.assertTrue( res.overallStatus.isGood() )
+            self.assertEqual( res.targets[0].data.value , False )
+            self.assertEqual( res.targets[1].data.type() , pyuaf.util.opcuatypes.Double )
+
+        # each execution is a new request
+        self.assertNotEqual( res1.requestHandle , res2.requestHandle )
+
+    def test_client_Client_read_with_read_coalescing_enabled(self):
+        settings = self.client.clientSettings()
+        settings.readCoalescingEnable = True
+        settings.readCoalescingWindowMs = 5
+        self.client.setClientSettings(settings)
+
+        results = {}
+        lock = thread.allocate_lock()
+
+        def readInThread(i, address):
+            res = self.client.read(address)
+            lock.acquire()
+            results[i] = res
+            lock.release()
+
+        addresses = [self.address0, self.address2, self.address5, self.address0]
+        for i in range(len(addresses)):
+            thread.start_new_thread(readInThread, (i, addresses[i]))
+
+        t = time.time()
+        while len(results) < len(addresses) and time.time() - t < 10.0:
+            time.sleep(0.01)
+
+        self.assertEqual( len(results) , len(addresses) )
+        for i in range(len(addresses)):
+            self.assertTrue( results[i].overallStatus.isGood() )
+            self.assertEqual( len(results[i].targets) , 1 )
+        self.assertEqual( results[0].targets[0].data.value , False )
+        self.assertEqual( results[2].targets[0].data.type() , pyuaf.util.opcuatypes.Double )
+        self.assertEqual( results[3].targets[0].data.value , False )
+
+        # each read is still a separate request
+        self.assertNotEqual( results[0].requestHandle , results[3].requestHandle )
+
+    def test_client_Client_read_with_read_coalescing_and_an_unknown_server(self):
+        settings = self.client.clientSettings()
+        settings.readCoalescingEnable = True
+        settings.readCoalescingWindowMs = 50
+        self.client.setClientSettings(settings)
+
+        unknownAddress = Address(ExpandedNodeId(self.id0, "urn:UnknownServer"))
+
+        statuses = {}
+        results = {}
+        lock = thread.allocate_lock()
+
+        def readInThread(i, address):
+            req = ReadRequest(1)
+            req.targets[0].address = address
+            res = pyuaf.client.results.ReadResult()
+            status = pyuaf.client.ClientBase.processRequest(self.client, req, res)
+            lock.acquire()
+            statuses[i] = status
+            results[i] = res
+            lock.release()
+
+        addresses = [unknownAddress, self.address0, self.address5, self.address0]
+        for i in range(len(addresses)):
+            thread.start_new_thread(readInThread, (i, addresses[i]))
+
+        t = time.time()
+        while len(results) < len(addresses) and time.time() - t < 20.0:
+            time.sleep(0.01)
+
+        self.assertEqual( len(results) , len(addresses) )
+
+        # the failing read doesn't affect the reads it was coalesced with
+        self.assertFalse( statuses[0].isGood() and results[0].overallStatus.isGood() )
+        for i in range(1, len(addresses)):
+            self.assertTrue( statuses[i].isGood() )
+            self.assertTrue( results[i].overallStatus.isGood() )
+            self.assertEqual( len(results[i].targets) , 1 )
+        self.assertEqual( results[1].targets[0].data.value , False )
+        self.assertEqual( results[3].targets[0].data.value , False )
+
+    def test_client_Client_read_with_read_coalescing_doesnt_wait_when_alone(self):
+        settings = self.client.clientSettings()
+        settings.readCoalescingEnable = True
+        settings.readCoalescingWindowMs = 3000
+        self.client.setClientSettings(settings)
+
+        # connect first
+        self.client.read(self.address0)
+
+        # no other read can join, so the read is not delayed by the window
+        t = time.time()
+        res = self.client.read(self.address0)
+        self.assertTrue( res.overallStatus.isGood() )
+        self.assertLess( time.time() - t , 2.0 )
+
+    def help_readWithMaxAge(self, addresses, maxAgeSec):
+        readSettings = pyuaf.client.settings.ReadSettings()
+        readSettings.maxAgeSec = maxAgeSec
+        
+        req = ReadRequest([ReadRequestTarget(address) for address in addresses])
+        req.serviceSettingsGiven = True
+        req.serviceSettings = readSettings
+        
+        res = self.client.processRequest(req)
+        self.assertTrue( res.overallStatus.isGood() )
+        return res
+    
+    def help_startSimulation(self):
+        demoNsUri = ARGS.demo_ns_uri
+        serverUri = ARGS.demo_server_uri
+        
+        # the simulated values change every second
+        demo = Address(ExpandedNodeId("Demo", demoNsUri, serverUri))
+        self.client.call(demo, Address(demo, [RelativePathElement(QualifiedName("StartSimulation", demoNsUri))]))
+        self.simulatedDouble = Address(ExpandedNodeId("Demo.Dynamic.Scalar.Double", demoNsUri, serverUri))
+        self.simulatedFloat  = Address(ExpandedNodeId("Demo.Dynamic.Scalar.Float", demoNsUri, serverUri))
+    
+    def help_stopSimulation(self):
+        demoNsUri = ARGS.demo_ns_uri
+        demo = Address(ExpandedNodeId("Demo", demoNsUri, ARGS.demo_server_uri))
+        self.client.call(demo, Address(demo, [RelativePathElement(QualifiedName("StopSimulation", demoNsUri))]))
+
+    def test_client_Client_read_with_value_cache_enabled(self):
+        self.help_startSimulation()
+        try:
+            # without the cache, a simulated value changes between two reads
+            res1 = self.help_readWithMaxAge([self.simulatedDouble], 60.0)
+            time.sleep(2.5)
+            res2 = self.help_readWithMaxAge([self.simulatedDouble], 60.0)
+            self.assertNotEqual( res1.targets[0].sourceTimestamp , res2.targets[0].sourceTimestamp )
+            
+            settings = self.client.clientSettings()
+            settings.valueCacheEnable = True
+            self.client.setClientSettings(settings)
+            
+            # with the cache, it stays frozen as long as it is younger than maxAgeSec
+            res1 = self.help_readWithMaxAge([self.simulatedDouble, self.address0], 60.0)
+            time.sleep(2.5)
+            res2 = self.help_readWithMaxAge([self.simulatedDouble, self.address0], 60.0)
+            self.assertEqual( res1.targets[0].data , res2.targets[0].data )
+            self.assertEqual( res1.targets[0].sourceTimestamp , res2.targets[0].sourceTimestamp )
+            self.assertEqual( res2.targets[1].data.value , False )
+            
+            # ... but not if it is older
+            res3 = self.help_readWithMaxAge([self.simulatedDouble], 1.0)
+            self.assertNotEqual( res1.targets[0].sourceTimestamp , res3.targets[0].sourceTimestamp )
+            
+            # a maxAgeSec of 0.0 always reads from the server
+            time.sleep(2.5)
+            res4 = self.help_readWithMaxAge([self.simulatedDouble], 0.0)
+            self.assertNotEqual( res3.targets[0].sourceTimestamp , res4.targets[0].sourceTimestamp )
+        finally:
+            self.help_stopSimulation()
+
+    def test_client_Client_read_with_value_cache_evicts_the_oldest_value(self):
+        self.help_startSimulation()
+        try:
+            settings = self.client.clientSettings()
+            settings.valueCacheEnable = True
+            settings.valueCacheMaxEntries = 1
+            self.client.setClientSettings(settings)
+            
+            # the float value replaces the double value in the cache
+            res1 = self.help_readWithMaxAge([self.simulatedDouble], 60.0)
+            self.help_readWithMaxAge([self.simulatedFloat], 60.0)
+            time.sleep(2.5)
+            res2 = self.help_readWithMaxAge([self.simulatedDouble], 60.0)
+            
+            self.assertNotEqual( res1.targets[0].sourceTimestamp , res2.targets[0].sourceTimestamp )
+        finally:
+            self.help_stopSimulation()
+
+    def test_client_Client_read_with_value_cache_after_writes(self):
+        settings = self.client.clientSettings()
+        settings.valueCacheEnable = True
+        self.client.setClientSettings(settings)
+        
+        address = Address(ExpandedNodeId("Demo.Static.Scalar.Double", ARGS.demo_ns_uri, ARGS.demo_server_uri))
+        
+        self.client.write([address], [pyuaf.util.primitives.Double(1.0)])
+        self.assertEqual( self.help_readWithMaxAge([address], 60.0).targets[0].data.value , 1.0 )
+        
+        # a synchronous write removes the cached value
+        self.client.write([address], [pyuaf.util.primitives.Double(2.0)])
+        self.assertEqual( self.help_readWithMaxAge([address], 60.0).targets[0].data.value , 2.0 )
+        
+        # so does an asynchronous write
+        writeRequest = WriteRequest([WriteRequestTarget(address, pyuaf.util.primitives.Double(3.0))])
+        self.assertTrue( self.client.writeAsync(writeRequest).get().overallStatus.isGood() )
+        self.assertEqual( self.help_readWithMaxAge([address], 60.0).targets[0].data.value , 3.0 )
+
+    def test_client_Client_read_with_value_cache_and_index_ranges(self):
+        settings = self.client.clientSettings()
+        settings.valueCacheEnable = True
+        self.client.setClientSettings(settings)
+        
+        address = Address(ExpandedNodeId(NodeId(opcuaidentifiers.OpcUaId_Server_NamespaceArray, 0),
+                                         ARGS.demo_server_uri))
+        
+        def readRange(indexRange):
+            readSettings = pyuaf.client.settings.ReadSettings()
+            readSettings.maxAgeSec = 60.0
+            req = ReadRequest(1)
+            req.targets[0].address = address
+            req.targets[0].indexRange = indexRange
+            req.serviceSettingsGiven = True
+            req.serviceSettings = readSettings
+            res = self.client.processRequest(req)
+            self.assertTrue( res.overallStatus.isGood() )
+            return res.targets[0].data
+        
+        # the demo server has more than one namespace
+        noOfNamespaces = len(readRange(""))
+        self.assertGreater( noOfNamespaces , 1 )
+        
+        # a cached full array doesn't answer a read of a range ...
+        self.assertEqual( len(readRange("0:1")) , 2 )
+        
+        # ... and a range doesn't replace the full array in the cache
+        self.assertEqual( len(readRange("")) , noOfNamespaces )
+        self.assertEqual( len(readRange("1")) , 1 )
+        self.assertEqual( len(readRange("")) , noOfNamespaces )
+
+    def test_client_Client_read_with_shared_prefix_resolution_enabled(self):
+        demoNsUri = ARGS.demo_ns_uri
+
+        # two deep relative paths that share the "BoilerDemo/Boiler1" prefix
+        elemSetPoint = RelativePathElement(QualifiedName("TemperatureSetPoint", demoNsUri))
+        addressA = Address(self.start6, self.path6 + [self.elem7a, self.elem7b])
+        addressB = Address(self.start6, self.path6 + [elemSetPoint])
+        addresses = [addressA, addressB, self.address6, self.address7, self.address0]
+
+        # resolve them by a client without shared prefix resolution (so with an empty cache)
+        otherClient = pyuaf.client.Client(self.client.clientSettings())
+        try:
+            expected = otherClient.read(addresses, pyuaf.util.attributeids.NodeId)
+        finally:
+            del otherClient
+
+        settings = self.client.clientSettings()
+        settings.sharedPrefixResolutionEnable = True
+        self.client.setClientSettings(settings)
+
+        res = self.client.read(addresses, pyuaf.util.attributeids.NodeId)
+
+        self.assertTrue( expected.overallStatus.isGood() )
+        self.assertTrue( res.overallStatus.isGood() )
+
+        # the paths resolve to the same nodes as when they are resolved without shared prefixes
+        for i in xrange(len(addresses)):
+            self.assertEqual( res.targets[i].data , expected.targets[i].data )
+
+        # A and the nested address7 are the same node, B is a different one
+        self.assertEqual( res.targets[0].data , res.targets[3].data )
+        self.assertNotEqual( res.targets[0].data , res.targets[1].data )
+
+    def test_client_Client_read_with_shared_prefix_matching_several_nodes(self):
+        demoNsUri = ARGS.demo_ns_uri
+        serverUri = ARGS.demo_server_uri
+
+        # the folders named "Scalar" (e.g. Demo.Static.Scalar and Demo.Dynamic.Scalar), found
+        # via the inverse HasTypeDefinition references of the FolderType
+        start = Address(ExpandedNodeId(NodeId(opcuaidentifiers.OpcUaId_FolderType, 0), serverUri))
+        elemScalar = RelativePathElement(QualifiedName("Scalar", demoNsUri),
+                                         NodeId(opcuaidentifiers.OpcUaId_HasTypeDefinition, 0),
+                                         True, False)
+        prefix = Address(start, [elemScalar])
+        addresses = [Address(start, [elemScalar, RelativePathElement(QualifiedName(name, demoNsUri))])
+                     for name in ["Double", "Int32", "XmlElement", "NonExistingNode"]]
+
+        # resolve them by a client without shared prefix resolution
+        otherClient = pyuaf.client.Client(self.client.clientSettings())
+        try:
+            prefixResult = otherClient.read([prefix], pyuaf.util.attributeids.NodeId)
+            expected = otherClient.read(addresses, pyuaf.util.attributeids.NodeId)
+        finally:
+            del otherClient
+
+        if prefixResult.targets[0].status.statusCode != pyuaf.util.statuscodes.MultipleTranslationResultsError:
+            self.skipTest("The shared prefix doesn't match several nodes of this server")
+
+        settings = self.client.clientSettings()
+        settings.sharedPrefixResolutionEnable = True
+        self.client.setClientSettings(settings)
+
+        res = self.client.read(addresses, pyuaf.util.attributeids.NodeId)
+
+        # the failure of the shared prefix is not copied to the paths: they are resolved via their
+        # full paths, just like without shared prefix resolution
+        for i in xrange(len(addresses)):
+            self.assertEqual( res.targets[i].status.statusCode , expected.targets[i].status.statusCode )
+            if expected.targets[i].status.isGood():
+                self.assertEqual( res.targets[i].data , expected.targets[i].data )
+
+    def test_client_Client_read_with_resolution_failures_cached(self):
+        settings = self.client.clientSettings()
+        settings.resolutionFailureTtlSec = 60.0
+        self.client.setClientSettings(settings)
+
+        demoNsUri = ARGS.demo_ns_uri
+        badAddress = Address(self.start5,
+                             [RelativePathElement(QualifiedName("NonExistingNode", demoNsUri))])
+
+        # the first read translates the address
+        res1 = self.client.read([badAddress, self.address0])
+        stats1 = self.client.resolutionStatistics()
+
+        # the second one fails immediately, without translating the address again
+        res2 = self.client.read([badAddress, self.address0])
+        stats2 = self.client.resolutionStatistics()
+
+        for res in [res1, res2]:
+            self.assertFalse( res.targets[0].status.isGood() )
+            self.assertEqual( res.targets[1].data.value , False )
+
+        self.assertEqual( res1.targets[0].status.statusCode , res2.targets[0].status.statusCode )
+
+        self.assertTrue( stats1.translatedBrowsePaths > 0 )
+        self.assertEqual( stats2.translatedBrowsePaths , stats1.translatedBrowsePaths )
+        self.assertEqual( stats2.cachedFailures , stats1.cachedFailures + 1 )
+
+    def test_client_Client_read_with_resolution_failures_expired(self):
+        settings = self.client.clientSettings()
+        settings.resolutionFailureTtlSec = 1.0
+        settings.resolutionFailureMaxTtlSec = 1.0
+        self.client.setClientSettings(settings)
+
+        demoNsUri = ARGS.demo_ns_uri
+        badAddress = Address(self.start5,
+                             [RelativePathElement(QualifiedName("NonExistingNode", demoNsUri))])
+
+        res1 = self.client.read([badAddress, self.address0])
+        stats1 = self.client.resolutionStatistics()
+
+        # once the failure has expired, the address is translated again
+        time.sleep(1.5)
+
+        res2 = self.client.read([badAddress, self.address0])
+        stats2 = self.client.resolutionStatistics()
+
+        for res in [res1, res2]:
+            self.assertFalse( res.targets[0].status.isGood() )
+
+        self.assertTrue( stats2.translatedBrowsePaths > stats1.translatedBrowsePaths )
+        self.assertEqual( stats2.cachedFailures , stats1.cachedFailures )
+
+    def test_client_Client_read_with_parallel_resolution_enabled(self):
+        settings = self.client.clientSettings()
+        settings.parallelResolutionEnable = True
+        self.client.setClientSettings(settings)
+
+        # the browse paths start in two different servers: the demo server and a server that
+        # cannot be connected, so they are translated per server, concurrently
+        demoNsUri = ARGS.demo_ns_uri
+        unknownStart = Address(ExpandedNodeId(self.id0, "urn:UnknownServer"))
+        unknownAddress = Address(unknownStart,
+                                 [RelativePathElement(QualifiedName("Node", demoNsUri))])
+        req = ReadRequest([ReadRequestTarget(self.address5),
+                           ReadRequestTarget(unknownAddress),
+                           ReadRequestTarget(self.address6, pyuaf.util.attributeids.DisplayName),
+                           ReadRequestTarget(self.address0)])
+
+        stats1 = self.client.resolutionStatistics()
+
+        # call the ClientBase directly, since Client.processRequest() raises the overall error
+        res = ReadResult()
+        status = pyuaf.client.ClientBase.processRequest(self.client, req, res)
+
+        stats2 = self.client.resolutionStatistics()
+
+        # one translation request per server
+        self.assertEqual( stats2.translationRequests , stats1.translationRequests + 2 )
+        self.assertEqual( stats2.translatedBrowsePaths , stats1.translatedBrowsePaths + 3 )
+
+        # the translation of the unknown server failed, the one of the demo server succeeded
+        self.assertFalse( status.isGood() )
+        self.assertTrue( res.targets[0].status.isGood() )
+        self.assertEqual( res.targets[0].data.type() , pyuaf.util.opcuatypes.Double )
+        self.assertFalse( res.targets[1].status.isGood() )
+        self.assertTrue( res.targets[2].status.isGood() )
+        self.assertEqual( res.targets[2].data , pyuaf.util.LocalizedText("", "Boiler1") )
+        self.assertTrue( res.targets[3].status.isGood() )
+        self.assertEqual( res.targets[3].data.value , False )
+
+    def test_client_Client_read_with_registered_nodes(self):
+        settings = self.client.clientSettings()
+        settings.registerNodesEnable = True
+        settings.registerNodesMinAccessCount = 2
+        self.client.setClientSettings(settings)
+
+        for i in xrange(4):
+            res = self.client.read(self.address0)
+            self.assertTrue( res.overallStatus.isGood() )
+            self.assertEqual( res.targets[0].data.value , False )
+
+        info = self.client.sessionInformation(res.targets[0].clientConnectionId)
+
+        self.assertEqual( info.registeredNodes , 1 )
+
+        # the first two reads counted the accesses, the last two used the alias
+        self.assertEqual( info.registeredNodeHits , 2 )
+
+    def test_client_Client_read_with_registered_nodes_evicts_cold_nodes(self):
+        settings = self.client.clientSettings()
+        settings.registerNodesEnable = True
+        settings.registerNodesMinAccessCount = 2
+        settings.registerNodesMaxNodes = 2
+        self.client.setClientSettings(settings)
+
+        # two cold nodes fill the table
+        self.client.read(self.address1)
+        self.client.read(self.address2)
+
+        # the coldest node makes room for a new one, which can therefore become hot
+        for i in xrange(4):
+            res = self.client.read(self.address0)
+            self.assertEqual( res.targets[0].data.value , False )
+
+        info = self.client.sessionInformation(res.targets[0].clientConnectionId)
+
+        self.assertEqual( info.registeredNodes , 1 )
+        self.assertEqual( info.registeredNodeHits , 2 )
+
+        # the registered node is kept, so the other cold node gets evicted instead
+        for i in xrange(3):
+            res = self.client.read(self.address1)
+        self.client.read(self.address0)
+
+        info = self.client.sessionInformation(res.targets[0].clientConnectionId)
+
+        self.assertEqual( info.registeredNodes , 2 )
+        self.assertEqual( info.registeredNodeHits , 4 )
+
+    def test_client_Client_read_with_registered_nodes_unregisters_evicted_nodes(self):
+        settings = self.client.clientSettings()
+        settings.registerNodesEnable = True
+        settings.registerNodesMinAccessCount = 2
+        settings.registerNodesMaxNodes = 1
+        self.client.setClientSettings(settings)
+
+        for i in xrange(3):
+            res = self.client.read(self.address0)
+
+        info = self.client.sessionInformation(res.targets[0].clientConnectionId)
+
+        self.assertEqual( info.registeredNodes , 1 )
+        self.assertEqual( info.registeredNodeHits , 1 )
+
+        # the registered node has gone cold, so it makes room for a new node and gets unregistered
+        res = self.client.read(self.address1)
+        self.assertTrue( res.overallStatus.isGood() )
+
+        info = self.client.sessionInformation(res.targets[0].clientConnectionId)
+
+        self.assertEqual( info.registeredNodes , 0 )
+
+        # the evicted node is counted again from scratch, so its original NodeId is used
+        res = self.client.read(self.address0)
+        self.assertTrue( res.overallStatus.isGood() )
+        self.assertEqual( res.targets[0].data.value , False )
+
+        info = self.client.sessionInformation(res.targets[0].clientConnectionId)
+
+        self.assertEqual( info.registeredNodeHits , 1 )
+
+    def test_client_Client_read_with_registered_nodes_unregisters_nodes_on_disconnection(self):
+        settings = self.client.clientSettings()
+        settings.registerNodesEnable = True
+        settings.registerNodesMinAccessCount = 2
+        self.client.setClientSettings(settings)
+
+        # the reads use the same session as the one that is connected manually
+        clientConnectionId = self.client.manuallyConnect(ARGS.demo_server_uri,
+                                                         pyuaf.client.settings.SessionSettings())
+
+        for i in xrange(3):
+            res = self.client.read(self.address0)
+            self.assertEqual( res.targets[0].clientConnectionId , clientConnectionId )
+
+        self.assertEqual( self.client.sessionInformation(clientConnectionId).registeredNodes , 1 )
+
+        # the aliases are released before the session is disconnected (raises an error if the
+        # disconnection fails)
+        self.client.manuallyDisconnect(clientConnectionId)
+
+        # a new session counts and registers the node again
+        for i in xrange(3):
+            res = self.client.read(self.address0)
+            self.assertTrue( res.overallStatus.isGood() )
+            self.assertEqual( res.targets[0].data.value , False )
+
+        info = self.client.sessionInformation(res.targets[0].clientConnectionId)
+
+        self.assertEqual( info.registeredNodes , 1 )
+        self.assertEqual( info.registeredNodeHits , 1 )
+
+    def test_client_Client_read_with_an_address_cache_file(self):
+        fileName = os.path.join(tempfile.mkdtemp(), "addresscache.bin")
+
+        settings = self.client.clientSettings()
+        settings.addressCacheFile = fileName
+        self.client.setClientSettings(settings)
+
+        res1 = self.client.read(self.address7)
+        self.assertGreater( self.client.resolutionStatistics().translatedBrowsePaths , 0 )
+
+        # the cached addresses are saved when the client is destroyed
+        del self.client
+        self.assertTrue( os.path.exists(fileName) )
+
+        # a new client loads them again, and doesn't need to translate the address anymore
+        self.client = pyuaf.client.Client(settings)
+        self.assertGreater( self.client.resolutionStatistics().loadedAddresses , 0 )
+
+        res2 = self.client.read(self.address7)
+
+        for res in [res1, res2]:
+            self.assertTrue( res.overallStatus.isGood() )
+            self.assertEqual( res.targets[0].data.type() , pyuaf.util.opcuatypes.Double )
+
+        statistics = self.client.resolutionStatistics()
+        self.assertEqual( statistics.translationRequests , 0 )
+        self.assertEqual( statistics.translatedBrowsePaths , 0 )
+        self.assertGreater( statistics.cachedAddresses , 0 )
+
+        # saving replaces the existing file
+        del self.client
+        self.client = pyuaf.client.Client(settings)
+        self.assertGreater( self.client.resolutionStatistics().loadedAddresses , 0 )
+        self.assertFalse( os.path.exists(fileName + ".tmp") )
+
     def tearDown(self):
         # delete the client instances manually (now!) instead of letting them be garbage collected 
         # automatically (which may happen during a another test, and which may cause logging output
@@ -100,6 +100,68 @@ class ClientStructuresTest(unittest.TestCase):
         self.assertEqual( statuscode, 0 )
         
         
+    def test_client_Client_structureDefinition_with_preloading(self):
+        # the definitions are preloaded when the session connects, so the namespace must be
+        # configured before the client connects to the server
+        settings = self.client.clientSettings()
+        settings.structureDefinitionsPreloadNamespaceUris.append(ARGS.demo_ns_uri)
+        client = pyuaf.client.Client(settings)
+        
+        result = client.read( [self.address_vector] , attributeId = attributeids.DataType)
+        dataTypeId = result.targets[0].data
+        
+        # wait until the session has preloaded the definitions
+        clientConnectionId = result.targets[0].clientConnectionId
+        t_timeout = time.time() + 5.0
+        while time.time() < t_timeout \
+                and client.sessionInformation(clientConnectionId).structureDefinitions == 0:
+            time.sleep(0.1)
+        
+        info = client.sessionInformation(clientConnectionId)
+        self.assertTrue( info.structureDefinitions > 0 )
+        self.assertEqual( info.structureDefinitionHits , 0 )
+        
+        # the definition is taken from the cache, without browsing the server
+        definition = client.structureDefinition(dataTypeId)
+        
+        info = client.sessionInformation(clientConnectionId)
+        self.assertEqual( info.structureDefinitionHits , 1 )
+        self.assertEqual( definition.child(0).name(), 'X' )
+        
+        del client
+        
+        
+    def test_client_Client_structureDefinition_is_cached(self):
+        result = self.client.read( [self.address_vector] , attributeId = attributeids.DataType)
+        dataTypeId = result.targets[0].data
+        
+        # the second definition is taken from the cache
+        definition1 = self.client.structureDefinition(dataTypeId)
+        definition2 = self.client.structureDefinition(dataTypeId)
+        
+        info = self.client.sessionInformation(result.targets[0].clientConnectionId)
+        self.assertEqual( info.structureDefinitions , 1 )
+        self.assertEqual( info.structureDefinitionHits , 1 )
+        
+        self.assertEqual( definition1.child(0).name(), 'X' )
+        self.assertEqual( definition2.child(0).name(), 'X' )
+        self.assertEqual( definition1.childrenCount(), definition2.childrenCount() )
+        
+        
+    def test_client_Client_structureDefinition_not_found_is_not_cached(self):
+        result = self.client.read( [self.address_vector] , attributeId = attributeids.DataType)
+        
+        # a Double has no structure definition
+        doubleId = NodeId(opcuaidentifiers.OpcUaId_Double, 0)
+        
+        for i in xrange(2):
+            self.assertRaises(UafError, self.client.structureDefinition, doubleId)
+        
+        info = self.client.sessionInformation(result.targets[0].clientConnectionId)
+        self.assertEqual( info.structureDefinitions , 0 )
+        self.assertEqual( info.structureDefinitionHits , 0 )
+        
+        
     def test_client_Client_unions(self):
         # read the structure
         result = self.client.read( [self.address_union] )
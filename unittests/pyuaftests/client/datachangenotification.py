@@ -23,7 +23,9 @@ class DataChangeNotificationTest(unittest.TestCase):
         self.notif1 = pyuaf.client.DataChangeNotification()
         self.notif1.clientHandle = 123
         self.notif1.data = pyuaf.util.primitives.UInt16(456)
-        self.notif1.status = pyuaf.util.Status(pyuaf.util.errors.NoTargetsGivenError())
+        self.notif1.opcUaStatusCode = pyuaf.util.opcuastatuscodes.OpcUa_BadNoData
+        self.notif1.sourceTimestamp = 131000000000000000
+        self.notif1.serverTimestamp = 131000000000000001
     
     def test_client_DataChangeNotification_clientHandle(self):
         self.assertEqual( self.notif1.clientHandle , 123 )
@@ -31,8 +33,19 @@ class DataChangeNotificationTest(unittest.TestCase):
     def test_client_DataChangeNotification_data(self):
         self.assertEqual( self.notif1.data , pyuaf.util.primitives.UInt16(456) )
     
+    def test_client_DataChangeNotification_opcUaStatusCode(self):
+        self.assertEqual( self.notif1.opcUaStatusCode , pyuaf.util.opcuastatuscodes.OpcUa_BadNoData )
+    
     def test_client_DataChangeNotification_status(self):
-        self.assertEqual( self.notif1.status , pyuaf.util.Status(pyuaf.util.errors.NoTargetsGivenError()) )
+        self.assertTrue( self.notif0.status().isGood() )
+        self.assertTrue( self.notif1.status().isBad() )
+    
+    def test_client_DataChangeNotification_timestamps(self):
+        self.assertEqual( self.notif0.sourceTimestamp , 0 )
+        self.assertEqual( self.notif1.sourceTimestamp , 131000000000000000 )
+        self.assertEqual( self.notif1.serverTimestamp , 131000000000000001 )
+        self.assertEqual( pyuaf.util.DateTime.fromFileTime(self.notif1.sourceTimestamp).toFileTime(),
+                          self.notif1.sourceTimestamp )
     
     def test_client_DataChangeNotificationVector(self):
         testVector(self, pyuaf.client.DataChangeNotificationVector, [self.notif0, self.notif1])
@@ -58,6 +58,12 @@ class AddressTest(unittest.TestCase):
         self.assertTrue( self.a2 == self.a2_ )
         self.assertTrue( self.a3 == self.a3_ )
     
+    def test_util_Address_hash(self):
+        self.assertEqual( self.a0.hash() , self.a0_.hash() )
+        self.assertEqual( self.a1.hash() , self.a1_.hash() )
+        self.assertEqual( self.a2.hash() , self.a2_.hash() )
+        self.assertEqual( self.a3.hash() , self.a3_.hash() )
+    
     def test_util_Address___ne__(self):
         self.assertTrue( self.a0 != self.a1 )
         self.assertTrue( self.a1 != self.a2 ) 
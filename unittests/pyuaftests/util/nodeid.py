@@ -119,6 +119,12 @@ class NodeIdTest(unittest.TestCase):
         self.assertTrue( self.n11 == self.n2 )
         self.assertTrue( self.n12 == self.n3 )
         
+    def test_util_NodeId_hash(self):
+        self.assertEqual( self.n1.hash() , self.n1_.hash() )
+        self.assertEqual( self.n5.hash() , self.n5_.hash() )
+        self.assertEqual( self.n9.hash() , self.n9_.hash() )
+        self.assertEqual( self.n10.hash() , self.n1.hash() )
+        
     def test_util_NodeId___ne__(self):
         self.assertTrue( self.n0 != self.n1  )
         self.assertTrue( self.n1 != self.n1a )
@@ -39,6 +39,26 @@ class QualifiedNameTest(unittest.TestCase):
         self.assertEqual( self.q2.hasNameSpaceUri() , True  )
         self.assertEqual( self.q3.hasNameSpaceUri() , True  )
     
+    def test_util_QualifiedName_isNull(self):
+        self.assertEqual( self.q0.isNull() , True  )
+        self.assertEqual( self.q1.isNull() , False )
+        self.assertEqual( self.q2.isNull() , False )
+        self.assertEqual( self.q3.isNull() , False )
+    
+    def test_util_QualifiedName_null_has_no_namespace(self):
+        self.assertEqual( self.q0.hasNameSpaceIndex() , False )
+        self.assertEqual( self.q0.hasNameSpaceUri() , False )
+        self.assertEqual( self.q0.nameSpaceUri() , "" )
+        self.assertEqual( self.q0.nameSpaceIndex() , 0 )
+        self.assertTrue( self.q0 == self.q0_ )
+        self.assertFalse( self.q0 < self.q0_ )
+        self.assertFalse( self.q0_ < self.q0 )
+        
+        # once a namespace URI is set, the qualified name is no longer null
+        self.q0.setNameSpaceUri("SomeUri")
+        self.assertEqual( self.q0.isNull() , False )
+        self.assertTrue( self.q0 != self.q0_ )
+    
     def test_util_QualifiedName_nameSpaceUri(self):
         self.assertEqual( self.q2.nameSpaceUri() , "SomeUri" )
         self.assertEqual( self.q3.nameSpaceUri() , "SomeUri" )